@@ -3,8 +3,46 @@
 
 #include "catalog_manager.hpp"
 
+#include <cmath>
+#include <deque>
+#include <string_view>
+
 using namespace components;
 
+namespace {
+    int64_t field_int(boost::mysql::field_view field) {
+        if (field.is_int64()) {
+            return field.as_int64();
+        }
+        if (field.is_uint64()) {
+            return static_cast<int64_t>(field.as_uint64());
+        }
+        return -1;
+    }
+
+    std::string quote(std::string_view value) {
+        std::string quoted = "'";
+        for (char c : value) {
+            if (c == '\'') {
+                quoted += c;
+            }
+            quoted += c;
+        }
+        return quoted + "'";
+    }
+
+    std::string quote_identifier(std::string_view name) {
+        std::string quoted = "`";
+        for (char c : name) {
+            if (c == '`') {
+                quoted += c;
+            }
+            quoted += c;
+        }
+        return quoted + "`";
+    }
+} // namespace
+
 namespace mysqlc {
     CatalogManager::CatalogManager(std::pmr::memory_resource* res)
         : actor_zeta::cooperative_supervisor<CatalogManager>(res)
@@ -32,13 +70,20 @@ namespace mysqlc {
         , log_(get_logger(logger_tag::CATALOG_MANAGER)) {
         assert(log_.is_valid());
         assert(res != nullptr);
-        worker_.start();
     }
 
     void CatalogManager::set_connector_manager(std::shared_ptr<ConnectorManager> conn_manager) {
         conn_manager_ = std::move(conn_manager);
     }
 
+    void CatalogManager::set_partial_aggregation(bool enabled) { partial_aggregation_ = enabled; }
+
+    void CatalogManager::set_analyze_statistics(bool enabled) { analyze_statistics_ = enabled; }
+
+    void CatalogManager::set_query_feedback(query_feedback_ptr feedback) { feedback_ = std::move(feedback); }
+
+    void CatalogManager::set_schema_cache(schema_cache_ptr cache) { schema_cache_ = std::move(cache); }
+
     actor_zeta::behavior_t CatalogManager::behavior() {
         return actor_zeta::make_behavior(resource(), [this](actor_zeta::message* msg) -> void {
             switch (msg->command()) {
@@ -76,37 +121,121 @@ namespace mysqlc {
     }
 
     auto CatalogManager::get_catalog_schema(session_hash_t id, ParsedQueryDataPtr&& data) -> void {
+        // computed before external nodes are swapped for schema nodes
+        const auto columns = schema_utils::required_columns(data->otterbrix_params->node);
+        if (data->has_binder()) {
+            data->parameter_types.assign(data->otterbrix_params->parameters_count, types::logical_type::NA);
+        }
         for (auto& batch : data->otterbrix_params->external_nodes) {
             for (size_t i = 0; i < batch.size(); ++i) {
                 if ((*batch[i])->type() == logical_plan::node_type::aggregate_t) {
                     const auto& name = (*batch[i])->collection_full_name();
-                    collection_full_name_t uid_as_schema(name.database, name.unique_identifier, name.collection);
-                    catalog::table_id uid_as_schema_id(resource(), uid_as_schema);
-
-                    if (!catalog_.table_exists(uid_as_schema_id)) {
-                        if (auto err = add_connection_schema(uid_as_schema); err) {
-                            send_result(id, std::move(data), err);
-                            return;
-                        }
+                    types::complex_logical_type initial_schema;
+                    if (auto err = source_schema(*batch[i], initial_schema); err) {
+                        send_result(id, std::move(data), err);
+                        return;
                     }
 
-                    const auto& agg = static_cast<logical_plan::node_aggregate_t&>(*(*batch[i]));
-                    auto initial_schema = catalog_.get_table_schema(uid_as_schema_id).schema_struct();
+                    // the plan itself stays untouched, pruning only applies to the query sent to the backend
+                    components::logical_plan::node_aggregate_t agg(
+                        static_cast<logical_plan::node_aggregate_t&>(*(*batch[i])));
+                    schema_utils::infer_parameter_types(agg, initial_schema, data->parameter_types);
+                    if (columns && schema_utils::prune_projection(agg, *columns, initial_schema)) {
+                        log_->trace("get_catalog_schema: pruned projection of {}", name.to_string());
+                    }
                     initial_schema = schema_utils::aggregate_filter_schema(agg,
                                                                            data->otterbrix_params->params_node.get(),
                                                                            catalog::schema(resource(), initial_schema));
 
-                    auto node_schema = schema_utils::make_node_schema(name,
-                                                                      std::move(initial_schema),
-                                                                      components::logical_plan::node_aggregate_t(agg));
+                    auto node_schema =
+                        schema_utils::make_node_schema(name, std::move(initial_schema), std::move(agg));
                     *batch[i] = node_schema;
                 }
             }
         }
 
+        if (schema_utils::push_join_filters(data->otterbrix_params->node)) {
+            log_->trace("get_catalog_schema: join filters pushed to their sources");
+        }
+
+        // estimated once the queries of the sources are final
+        for (auto& batch : data->otterbrix_params->external_nodes) {
+            for (auto* slot : batch) {
+                if ((*slot)->type() != logical_plan::node_type::unused) {
+                    continue;
+                }
+                auto& node_schema = static_cast<schema_utils::schema_node_t&>(**slot);
+                const auto& agg = *node_schema.agg_node();
+                // a join pushed to the backend has no statistics of its own
+                const bool single_table =
+                    std::none_of(agg.children().begin(), agg.children().end(), [](const auto& child) {
+                        return child->type() == logical_plan::node_type::join_t;
+                    });
+                auto rows = single_table ? schema_utils::estimate_rows(agg, table_stats(agg.collection_full_name()))
+                                         : -1;
+                if (auto observed = observed_rows(node_schema, data->otterbrix_params->params_node.get());
+                    observed >= 0) {
+                    rows = observed;
+                }
+                log_->trace("get_catalog_schema: {} estimated at {} rows",
+                            node_schema.collection_full_name().to_string(),
+                            rows);
+                node_schema.set_estimated_rows(rows);
+            }
+        }
+
+        if (partial_aggregation_ && schema_utils::push_partial_aggregation(data->otterbrix_params->node,
+                                                                           data->otterbrix_params->params_node.get())) {
+            log_->trace("get_catalog_schema: aggregation split into partial and final steps");
+        }
+
         send_result(id, std::move(data), catalog::catalog_error{});
     }
 
+    auto CatalogManager::table_schema(const collection_full_name_t& name, types::complex_logical_type& schema)
+        -> catalog::catalog_error {
+        collection_full_name_t uid_as_schema(name.database, name.unique_identifier, name.collection);
+        catalog::table_id uid_as_schema_id(resource(), uid_as_schema);
+
+        if (!catalog_.table_exists(uid_as_schema_id)) {
+            if (auto err = add_connection_schema(uid_as_schema); err) {
+                return err;
+            }
+        }
+        schema = catalog_.get_table_schema(uid_as_schema_id).schema_struct();
+        return catalog::catalog_error{};
+    }
+
+    auto CatalogManager::source_schema(const logical_plan::node_ptr& node, types::complex_logical_type& schema)
+        -> catalog::catalog_error {
+        auto join = std::find_if(node->children().begin(), node->children().end(), [](const auto& child) {
+            return child->type() == logical_plan::node_type::join_t;
+        });
+        if (join == node->children().end()) {
+            return table_schema(node->collection_full_name(), schema);
+        }
+
+        // join pushed to a single backend, rows carry the columns of every scan
+        std::deque<logical_plan::node_ptr> scans{*join};
+        bool first = true;
+        while (!scans.empty()) {
+            auto scan = std::move(scans.front());
+            scans.pop_front();
+            if (scan->type() == logical_plan::node_type::join_t) {
+                scans.insert(scans.end(), scan->children().begin(), scan->children().end());
+                continue;
+            }
+
+            types::complex_logical_type scan_schema;
+            if (auto err = table_schema(scan->collection_full_name(), scan_schema); err) {
+                return err;
+            }
+            schema = first ? std::move(scan_schema) : schema_utils::merge_schemas(schema, scan_schema);
+            first = false;
+        }
+        return catalog::catalog_error{};
+    }
+
     auto CatalogManager::add_connection_schema(collection_full_name_t name) -> catalog::catalog_error {
         if (!conn_manager_) {
             log_->warn("add_connection_schema: mysql_manager is null, unable to query schema");
@@ -124,6 +253,9 @@ namespace mysqlc {
 
             catalog_.create_namespace(id.get_namespace());
             auto err = catalog_.create_table(id, catalog::table_metadata(resource(), std::move(schema)));
+            if (!err && schema_cache_) {
+                schema_cache_->invalidate();
+            }
             log_->info("add_connection_schema: {} for: {}",
                        (err) ? "failed to add schema" : "schema added",
                        id.to_string());
@@ -154,8 +286,135 @@ namespace mysqlc {
         }
     }
 
+    auto CatalogManager::table_stats(const collection_full_name_t& name) -> schema_utils::table_stats_t {
+        const auto table = name.database.empty() ? name.collection : name.database + "." + name.collection;
+        {
+            std::lock_guard lock(stats_mtx_);
+            auto& cached = stats_[name.unique_identifier][table];
+            const bool stale = cached.fetched == std::chrono::steady_clock::time_point{} ||
+                               std::chrono::steady_clock::now() - cached.fetched >= STATS_TTL;
+            if (!stale || cached.refreshing || !conn_manager_) {
+                return cached.stats;
+            }
+            cached.refreshing = true;
+        }
+        refresh_stats(name, table);
+
+        std::lock_guard lock(stats_mtx_);
+        return stats_[name.unique_identifier][table].stats;
+    }
+
+    auto CatalogManager::refresh_stats(const collection_full_name_t& name, const std::string& table) -> void {
+        const auto uuid = name.unique_identifier;
+        const auto where = " WHERE TABLE_SCHEMA = " + (name.database.empty() ? "DATABASE()" : quote(name.database)) +
+                           " AND TABLE_NAME = " + quote(name.collection);
+        auto stats = std::make_shared<schema_utils::table_stats_t>();
+
+        // a failed read is stored as unknown as well, estimates then fall back to the plan structure
+        auto publish = [this, uuid, table, stats](std::exception_ptr error) {
+            if (error) {
+                try {
+                    std::rethrow_exception(error);
+                } catch (const std::exception& e) {
+                    log_->warn("table_stats: failed to read statistics of {}: {}", table, e.what());
+                } catch (...) {
+                    log_->warn("table_stats: failed to read statistics of {}", table);
+                }
+            }
+            std::lock_guard lock(stats_mtx_);
+            auto tables = stats_.find(uuid);
+            if (tables == stats_.end()) {
+                // the connection was removed meanwhile
+                return;
+            }
+            auto& cached = tables->second[table];
+            cached.stats = std::move(*stats);
+            cached.fetched = std::chrono::steady_clock::now();
+            cached.refreshing = false;
+            log_->debug("table_stats: {} has {} rows, {} indexed columns",
+                        table,
+                        cached.stats.rows,
+                        cached.stats.index_cardinality.size());
+        };
+        auto read_indexes = [this, uuid, where, stats, publish](std::exception_ptr error, catalog::catalog_error) {
+            if (error) {
+                publish(error);
+                return;
+            }
+            auto index_handler = [stats](const boost::mysql::results& result) -> catalog::catalog_error {
+                for (auto row : result.rows()) {
+                    if (row.at(0).is_string()) {
+                        stats->index_cardinality[std::string(row.at(0).as_string())] = field_int(row.at(1));
+                    }
+                }
+                return catalog::catalog_error{};
+            };
+            conn_manager_->executeQuery(uuid,
+                                        "SELECT COLUMN_NAME, MAX(CARDINALITY) FROM information_schema.STATISTICS" +
+                                            where + " AND SEQ_IN_INDEX = 1 GROUP BY COLUMN_NAME;",
+                                        index_handler,
+                                        [publish](std::exception_ptr error, catalog::catalog_error) {
+                                            publish(error);
+                                        });
+        };
+        auto read_tables = [this, uuid, where, stats, read_indexes](std::exception_ptr error, int64_t) {
+            if (error) {
+                read_indexes(error, {});
+                return;
+            }
+            auto tables_handler = [stats](const boost::mysql::results& result) -> catalog::catalog_error {
+                if (!result.rows().empty()) {
+                    stats->rows = field_int(result.rows()[0].at(0));
+                    stats->avg_row_length = field_int(result.rows()[0].at(1));
+                }
+                return catalog::catalog_error{};
+            };
+            conn_manager_->executeQuery(uuid,
+                                        "SELECT TABLE_ROWS, AVG_ROW_LENGTH FROM information_schema.TABLES" + where +
+                                            ";",
+                                        tables_handler,
+                                        read_indexes);
+        };
+
+        if (!analyze_statistics_) {
+            read_tables(nullptr, 0);
+            return;
+        }
+        const auto analyzed = name.database.empty() ? quote_identifier(name.collection)
+                                                    : quote_identifier(name.database) + "." +
+                                                          quote_identifier(name.collection);
+        conn_manager_->executeQuery(uuid,
+                                    "ANALYZE TABLE " + analyzed + ";",
+                                    [](const boost::mysql::results&) -> int64_t { return 0; },
+                                    read_tables);
+    }
+
+    auto CatalogManager::observed_rows(schema_utils::schema_node_t& node,
+                                       logical_plan::parameter_node_t* params) const -> int64_t {
+        if (!feedback_) {
+            return -1;
+        }
+        // same query the sql connection manager sends for this node, before any semi-join filter
+        std::string shape;
+        try {
+            shape = sql_gen::normalize_query(
+                sql_gen::generate_query(node.agg_node(), &params->parameters(), &node.schema()));
+        } catch (const std::exception&) {
+            return -1;
+        }
+        auto observed = feedback_->lookup(shape);
+        return observed ? std::llround(observed->rows) : -1;
+    }
+
     auto CatalogManager::remove_connection_schema(const std::string& uuid) -> void {
         catalog_.drop_namespace({uuid.c_str()});
+        {
+            std::lock_guard lock(stats_mtx_);
+            stats_.erase(uuid);
+        }
+        if (schema_cache_) {
+            schema_cache_->invalidate();
+        }
     }
 
     auto CatalogManager::get_tables(const arrow::flight::sql::GetTables& command,
@@ -217,12 +476,16 @@ namespace mysqlc {
     }
 
     auto CatalogManager::send_result(session_hash_t id, ParsedQueryDataPtr&& data, catalog::catalog_error err) -> void {
-        auto send_task = [this, id, &data, err = std::move(err)]() mutable {
-            actor_zeta::send(current_message()->sender(),
+        auto send_task = [this,
+                          id,
+                          reply_to = current_message()->sender(),
+                          data_holder = std::make_shared<ParsedQueryDataPtr>(std::move(data)),
+                          err = std::move(err)]() mutable {
+            actor_zeta::send(reply_to,
                              address(),
                              scheduler::handler_id(scheduler::route::get_catalog_schema_finish),
                              id,
-                             std::move(data),
+                             std::move(*data_holder),
                              std::move(err));
         };
         if (!worker_.addTask(std::move(send_task))) {
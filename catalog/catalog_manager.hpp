@@ -13,6 +13,8 @@
 #include "routes/scheduler.hpp"
 #include "scheduler/schema_utils.hpp"
 #include "utility/cv_wrapper.hpp"
+#include "utility/query_feedback.hpp"
+#include "utility/schema_cache.hpp"
 #include "utility/session.hpp"
 #include "utility/table_info.hpp"
 #include "utility/worker.hpp"
@@ -27,11 +29,24 @@
 #include <boost/mysql/connect_params.hpp>
 #include <components/catalog/catalog.hpp>
 
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 namespace mysqlc {
     class CatalogManager final : public actor_zeta::cooperative_supervisor<CatalogManager> {
     public:
         CatalogManager(std::pmr::memory_resource* res);
         void set_connector_manager(std::shared_ptr<ConnectorManager> conn_manager);
+        // aggregates over joins are split into remote partial and local final aggregates
+        void set_partial_aggregation(bool enabled);
+        // tables are analyzed by the backend before their statistics are read
+        void set_analyze_statistics(bool enabled);
+        // observed row counts of earlier queries of the same shape take precedence over table statistics
+        void set_query_feedback(query_feedback_ptr feedback);
+        // described result schemas are dropped whenever a namespace is added or removed
+        void set_schema_cache(schema_cache_ptr cache);
 
         actor_zeta::behavior_t behavior();
         auto make_scheduler() noexcept -> actor_zeta::scheduler_abstract_t*;
@@ -51,11 +66,40 @@ namespace mysqlc {
         components::catalog::catalog catalog_;
         std::shared_ptr<ConnectorManager> conn_manager_;
         std::mutex input_mtx_;
-        TaskManager<std::function<void()>> worker_;
+        std::atomic_bool partial_aggregation_{false};
+        std::atomic_bool analyze_statistics_{false};
+        query_feedback_ptr feedback_;
+        schema_cache_ptr schema_cache_;
+        struct cached_stats_t {
+            schema_utils::table_stats_t stats;
+            std::chrono::steady_clock::time_point fetched;
+            bool refreshing = false;
+        };
+        // statistics older than this are read again, the stale ones are used until the new ones arrive
+        static constexpr std::chrono::minutes STATS_TTL{10};
+        // connection uid -> table -> statistics, dropped together with the connection's schema.
+        // refreshes complete on connector threads
+        std::mutex stats_mtx_;
+        std::unordered_map<std::string, std::unordered_map<std::string, cached_stats_t>> stats_;
+        // last member, so queued sends finish before the maps above are destroyed
+        TaskGroup worker_;
 
         /// async method
         auto get_catalog_schema(session_hash_t id, ParsedQueryDataPtr&& data) -> void;
         auto add_connection_schema(collection_full_name_t name) -> catalog::catalog_error;
+        // schema of a remote table, fetched from the backend on first use
+        auto table_schema(const collection_full_name_t& name, components::types::complex_logical_type& schema)
+            -> catalog::catalog_error;
+        // schema of the rows an external aggregate reads, merged over the scans of a pushed join
+        auto source_schema(const components::logical_plan::node_ptr& node,
+                           components::types::complex_logical_type& schema) -> catalog::catalog_error;
+        // statistics of a remote table as last read from information_schema. unknown values are -1 until a
+        // refresh, started here without waiting for it, has completed or when the backend can't report them
+        auto table_stats(const collection_full_name_t& name) -> schema_utils::table_stats_t;
+        auto refresh_stats(const collection_full_name_t& name, const std::string& table) -> void;
+        // rows earlier runs of the node's query returned, -1 if none were recorded
+        auto observed_rows(schema_utils::schema_node_t& node,
+                           components::logical_plan::parameter_node_t* params) const -> int64_t;
         auto remove_connection_schema(const std::string& uuid) -> void;
         auto get_tables(const arrow::flight::sql::GetTables& command, shared_data<std::pmr::vector<table_info>> sdata)
             -> void;
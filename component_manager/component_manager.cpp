@@ -4,6 +4,9 @@
 #include "component_manager.hpp"
 #include "utility/logger.hpp"
 
+#include <algorithm>
+#include <thread>
+
 ComponentManager::ComponentManager(const configuration::config& config)
     : otterbrix_(otterbrix::make_otterbrix(config))
     , resource_(otterbrix_->dispatcher()->resource())
@@ -27,13 +30,24 @@ ComponentManager::ComponentManager(const configuration::config& config)
         actor_zeta::spawn_supervisor<db_conn::SqlConnectionManager>(resource_, db_connector_manager_);
     assert(sql_connection_manager_ != nullptr && "sql connection manager must not be null");
 
+    catalog_manager_->set_query_feedback(query_feedback_);
+    catalog_manager_->set_schema_cache(schema_cache_);
+    sql_connection_manager_->set_query_feedback(query_feedback_);
+
+    // parsing is the heaviest part of the scheduler, give every core its own parser
+    std::vector<parser_ptr> parsers;
+    const size_t shard_count = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < shard_count; ++i) {
+        parsers.push_back(make_parser(resource_));
+    }
     scheduler_ = actor_zeta::spawn_supervisor<Scheduler>(resource_,
-                                                         make_parser(resource_),
+                                                         std::move(parsers),
                                                          sql_connection_manager_->address(),
                                                          otterbrix_manager_->address(),
                                                          catalog_manager_->address());
 
     assert(scheduler_ != nullptr && "scheduler must not be null");
+    scheduler_->set_schema_cache(schema_cache_);
 
     // Start connector manager
     db_connector_manager_->start();
@@ -55,3 +69,7 @@ actor_zeta::address_t ComponentManager::catalog_address() const { return catalog
 actor_zeta::address_t ComponentManager::otterbrix_manager_address() const { return otterbrix_manager_->address(); }
 
 actor_zeta::address_t ComponentManager::sql_connection_manager_address() const { return sql_connection_manager_->address(); }
+
+void ComponentManager::set_partial_aggregation(bool enabled) { catalog_manager_->set_partial_aggregation(enabled); }
+
+void ComponentManager::set_analyze_statistics(bool enabled) { catalog_manager_->set_analyze_statistics(enabled); }
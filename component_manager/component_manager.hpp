@@ -26,11 +26,17 @@ public:
     actor_zeta::address_t catalog_address() const;
     actor_zeta::address_t otterbrix_manager_address() const;
     actor_zeta::address_t sql_connection_manager_address() const;
+    void set_partial_aggregation(bool enabled);
+    void set_analyze_statistics(bool enabled);
 private:
     otterbrix::otterbrix_ptr otterbrix_{nullptr};
     std::pmr::memory_resource* resource_{nullptr};
     std::string log_path_;
     std::shared_ptr<mysqlc::ConnectorManager> db_connector_manager_{nullptr};
+    // shared by the planner and the executor of remote queries
+    query_feedback_ptr query_feedback_ = std::make_shared<QueryFeedback>();
+    // filled by the scheduler, dropped by the catalog when a namespace changes
+    schema_cache_ptr schema_cache_ = std::make_shared<SchemaCache>();
     std::unique_ptr<mysqlc::CatalogManager, actor_zeta::pmr::deleter_t> catalog_manager_{
         nullptr,
         actor_zeta::pmr::deleter_t{getResource()}};
@@ -0,0 +1,351 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "connection_pool.hpp"
+
+#include "utility/logger.hpp"
+
+#include <algorithm>
+
+namespace mysqlc {
+
+    PooledConnector::PooledConnector(std::shared_ptr<ConnectionPool> pool, std::unique_ptr<IConnector> conn) noexcept
+        : pool_(std::move(pool))
+        , conn_(std::move(conn)) {}
+
+    PooledConnector& PooledConnector::operator=(PooledConnector&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = std::move(other.pool_);
+            conn_ = std::move(other.conn_);
+            broken_ = other.broken_;
+        }
+        return *this;
+    }
+
+    PooledConnector::~PooledConnector() { reset(); }
+
+    void PooledConnector::reset() noexcept {
+        if (pool_ && conn_) {
+            pool_->release(std::move(conn_), broken_);
+        }
+        pool_.reset();
+        conn_.reset();
+        broken_ = false;
+    }
+
+    ConnectionPool::ConnectionPool(asio::io_context& io_ctx,
+                                   connector_factory make_connector,
+                                   mysql::connect_params params,
+                                   std::string alias,
+                                   pool_config config)
+        : log_(get_logger(logger_tag::CONNECTOR_MANAGER))
+        , io_ctx_(io_ctx)
+        , make_connector_(std::move(make_connector))
+        , params_(std::move(params))
+        , alias_(std::move(alias))
+        , config_(config)
+        , sweep_timer_(std::make_shared<asio::steady_timer>(io_ctx)) {
+        assert(log_.is_valid());
+        config_.max_size = std::max<size_t>(config_.max_size, 1);
+        config_.min_size = std::min(config_.min_size, config_.max_size);
+    }
+
+    ConnectionPool::~ConnectionPool() { close(); }
+
+    void ConnectionPool::start() {
+        for (size_t i = 0; i < config_.min_size; ++i) {
+            {
+                std::lock_guard lock(mtx_);
+                ++total_;
+            }
+            std::unique_ptr<IConnector> conn;
+            try {
+                conn = open();
+            } catch (...) {
+                std::lock_guard lock(mtx_);
+                --total_;
+                if (i == 0) {
+                    throw;
+                }
+                log_->warn("Alias: {} pool warm up stopped at {} connections", alias_, i);
+                break;
+            }
+            std::lock_guard lock(mtx_);
+            idle_.push_back({std::move(conn), clock::now()});
+        }
+        asio::post(io_ctx_, [weak = weak_from_this()] {
+            if (auto self = weak.lock(); self) {
+                self->schedule_sweep();
+            }
+        });
+    }
+
+    PooledConnector ConnectionPool::acquire() {
+        std::unique_lock lock(mtx_);
+        const auto ticket = next_ticket_++;
+        waiters_.push_back({ticket, {}, nullptr});
+
+        auto is_mine = [ticket](const waiter_t& w) { return w.ticket == ticket; };
+        auto can_proceed = [&] { return closed_ || (waiters_.front().ticket == ticket && can_grant()); };
+        if (!cv_.wait_for(lock, config_.checkout_timeout, can_proceed)) {
+            waiters_.erase(std::find_if(waiters_.begin(), waiters_.end(), is_mine));
+            serve_waiters();
+            lock.unlock();
+            cv_.notify_all();
+            log_->error("Alias: {} checkout timed out, pool size: {}", alias_, config_.max_size);
+            throw std::runtime_error("[ConnectionPool::acquire] Alias: " + alias_ + " checkout timed out");
+        }
+        waiters_.erase(std::find_if(waiters_.begin(), waiters_.end(), is_mine));
+        if (closed_) {
+            lock.unlock();
+            cv_.notify_all();
+            throw std::runtime_error("[ConnectionPool::acquire] Alias: " + alias_ + " pool is closed");
+        }
+
+        std::unique_ptr<IConnector> conn;
+        if (!idle_.empty()) {
+            // most recently used connector first, so surplus ones age out
+            conn = std::move(idle_.back().conn);
+            idle_.pop_back();
+        } else {
+            ++total_;
+        }
+        serve_waiters();
+        lock.unlock();
+        cv_.notify_all();
+        if (conn) {
+            return {shared_from_this(), std::move(conn)};
+        }
+
+        try {
+            return {shared_from_this(), open()};
+        } catch (...) {
+            {
+                std::lock_guard guard(mtx_);
+                --total_;
+                serve_waiters();
+            }
+            cv_.notify_all();
+            throw;
+        }
+    }
+
+    void ConnectionPool::async_acquire(acquire_handler handler) {
+        // timer lives on its own strand, it is armed here and cancelled from whichever thread serves the waiter
+        auto timer = std::make_shared<asio::steady_timer>(asio::make_strand(io_ctx_), config_.checkout_timeout);
+        uint64_t ticket;
+        bool queued;
+        {
+            std::lock_guard lock(mtx_);
+            ticket = next_ticket_++;
+            waiters_.push_back({ticket, std::move(handler), timer});
+            serve_waiters();
+            queued = !waiters_.empty() && waiters_.back().ticket == ticket;
+        }
+        cv_.notify_all();
+        if (!queued) {
+            return;
+        }
+        asio::dispatch(timer->get_executor(), [weak = weak_from_this(), timer, ticket] {
+            timer->async_wait([weak, timer, ticket](const boost::system::error_code& ec) {
+                if (ec) {
+                    return;
+                }
+                if (auto self = weak.lock(); self) {
+                    self->expire_waiter(ticket);
+                }
+            });
+        });
+    }
+
+    void ConnectionPool::expire_waiter(uint64_t ticket) {
+        acquire_handler handler;
+        {
+            std::lock_guard lock(mtx_);
+            auto it = std::find_if(waiters_.begin(), waiters_.end(), [ticket](const waiter_t& w) {
+                return w.ticket == ticket;
+            });
+            if (it == waiters_.end()) {
+                // already served
+                return;
+            }
+            handler = std::move(it->handler);
+            waiters_.erase(it);
+            serve_waiters();
+        }
+        cv_.notify_all();
+        log_->error("Alias: {} checkout timed out, pool size: {}", alias_, config_.max_size);
+        handler(std::make_exception_ptr(
+                    std::runtime_error("[ConnectionPool::async_acquire] Alias: " + alias_ + " checkout timed out")),
+                {});
+    }
+
+    // called under mtx_, hands free capacity to asynchronous waiters in queue order
+    void ConnectionPool::serve_waiters() {
+        while (!waiters_.empty() && (closed_ || can_grant())) {
+            if (!waiters_.front().handler) {
+                // blocking waiter at the front takes its turn itself
+                return;
+            }
+            auto handler = std::move(waiters_.front().handler);
+            asio::post(waiters_.front().timer->get_executor(), [timer = waiters_.front().timer] { timer->cancel(); });
+            waiters_.pop_front();
+
+            if (closed_) {
+                auto error = std::make_exception_ptr(
+                    std::runtime_error("[ConnectionPool::acquire] Alias: " + alias_ + " pool is closed"));
+                asio::post(io_ctx_, [handler = std::move(handler), error] { handler(error, {}); });
+                continue;
+            }
+            if (!idle_.empty()) {
+                auto conn = std::make_shared<std::unique_ptr<IConnector>>(std::move(idle_.back().conn));
+                idle_.pop_back();
+                asio::post(io_ctx_, [self = shared_from_this(), handler = std::move(handler), conn] {
+                    handler(nullptr, PooledConnector(self, std::move(*conn)));
+                });
+                continue;
+            }
+            ++total_;
+            // connecting never blocks the io context the pool's waiters and queries run on
+            co_spawn(io_ctx_,
+                     async_open(),
+                     [self = shared_from_this(), handler = std::move(handler)](std::exception_ptr err,
+                                                                                std::unique_ptr<IConnector> conn) {
+                         if (err) {
+                             {
+                                 std::lock_guard lock(self->mtx_);
+                                 --self->total_;
+                                 self->serve_waiters();
+                             }
+                             self->cv_.notify_all();
+                             handler(err, {});
+                             return;
+                         }
+                         handler(nullptr, PooledConnector(self, std::move(conn)));
+                     });
+        }
+    }
+
+    void ConnectionPool::close() {
+        std::deque<idle_connector_t> idle;
+        {
+            std::lock_guard lock(mtx_);
+            if (closed_) {
+                return;
+            }
+            closed_ = true;
+            idle.swap(idle_);
+            total_ -= idle.size();
+            serve_waiters();
+        }
+        cv_.notify_all();
+        asio::post(io_ctx_, [timer = sweep_timer_] { timer->cancel(); });
+        for (auto& entry : idle) {
+            entry.conn->close();
+        }
+    }
+
+    size_t ConnectionPool::size() const {
+        std::lock_guard lock(mtx_);
+        return total_;
+    }
+
+    size_t ConnectionPool::idle() const {
+        std::lock_guard lock(mtx_);
+        return idle_.size();
+    }
+
+    bool ConnectionPool::isClosed() const {
+        std::lock_guard lock(mtx_);
+        return closed_;
+    }
+
+    std::unique_ptr<IConnector> ConnectionPool::open() {
+        log_->debug("Alias: {} open pooled connection", alias_);
+        auto conn = make_connector_(io_ctx_, params_, alias_);
+        conn->connect();
+        return conn;
+    }
+
+    asio::awaitable<std::unique_ptr<IConnector>> ConnectionPool::async_open() {
+        log_->debug("Alias: {} open pooled connection asynchronously", alias_);
+        auto conn = make_connector_(io_ctx_, params_, alias_);
+        co_await conn->async_connect();
+        co_return conn;
+    }
+
+    void ConnectionPool::release(std::unique_ptr<IConnector> conn, bool broken) noexcept {
+        std::deque<std::unique_ptr<IConnector>> expired;
+        {
+            std::lock_guard lock(mtx_);
+            const auto now = clock::now();
+            if (closed_ || broken || conn->isClosed()) {
+                --total_;
+                expired.push_back(std::move(conn));
+            } else {
+                idle_.push_back({std::move(conn), now});
+            }
+            auto evicted = evict_idle(now);
+            expired.insert(expired.end(),
+                           std::make_move_iterator(evicted.begin()),
+                           std::make_move_iterator(evicted.end()));
+            serve_waiters();
+        }
+        cv_.notify_all();
+        for (auto& c : expired) {
+            try {
+                c->close();
+            } catch (const std::exception& e) {
+                log_->warn("Alias: {} close of released connection failed: {}", alias_, e.what());
+            }
+        }
+    }
+
+    std::deque<std::unique_ptr<IConnector>> ConnectionPool::evict_idle(clock::time_point now) {
+        std::deque<std::unique_ptr<IConnector>> expired;
+        // oldest idle connectors sit at the front
+        while (!idle_.empty() && total_ > config_.min_size && now - idle_.front().since >= config_.idle_timeout) {
+            expired.push_back(std::move(idle_.front().conn));
+            idle_.pop_front();
+            --total_;
+        }
+        return expired;
+    }
+
+    void ConnectionPool::schedule_sweep() {
+        // an idle connector outlives idle_timeout by at most half of it
+        const auto interval = std::max<std::chrono::milliseconds>(config_.idle_timeout / 2, MIN_SWEEP_INTERVAL);
+        sweep_timer_->expires_after(interval);
+        sweep_timer_->async_wait([weak = weak_from_this(), timer = sweep_timer_](const boost::system::error_code& ec) {
+            if (ec) {
+                return;
+            }
+            if (auto self = weak.lock(); self) {
+                self->sweep();
+            }
+        });
+    }
+
+    void ConnectionPool::sweep() {
+        std::deque<std::unique_ptr<IConnector>> expired;
+        {
+            std::lock_guard lock(mtx_);
+            if (closed_) {
+                return;
+            }
+            expired = evict_idle(clock::now());
+            serve_waiters();
+        }
+        cv_.notify_all();
+        for (auto& c : expired) {
+            try {
+                c->close();
+            } catch (const std::exception& e) {
+                log_->warn("Alias: {} close of idle connection failed: {}", alias_, e.what());
+            }
+        }
+        schedule_sweep();
+    }
+
+} // namespace mysqlc
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include <components/log/log.hpp>
+
+#include "mysql_connector.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mysqlc {
+
+    struct pool_config {
+        size_t min_size = 1;
+        size_t max_size = 8;
+        std::chrono::milliseconds idle_timeout = std::chrono::seconds(60);
+        std::chrono::milliseconds checkout_timeout = std::chrono::seconds(30);
+    };
+
+    class ConnectionPool;
+
+    // owns a checked-out connector and hands it back to the pool on destruction
+    class PooledConnector {
+    public:
+        PooledConnector() = default;
+        PooledConnector(std::shared_ptr<ConnectionPool> pool, std::unique_ptr<IConnector> conn) noexcept;
+        PooledConnector(PooledConnector&& other) noexcept = default;
+        PooledConnector& operator=(PooledConnector&& other) noexcept;
+        PooledConnector(const PooledConnector&) = delete;
+        PooledConnector& operator=(const PooledConnector&) = delete;
+        ~PooledConnector();
+
+        IConnector* operator->() const noexcept { return conn_.get(); }
+        IConnector& operator*() const noexcept { return *conn_; }
+        explicit operator bool() const noexcept { return conn_ != nullptr; }
+
+        // connector is closed on return instead of going back to the idle list
+        void invalidate() noexcept { broken_ = true; }
+
+    private:
+        void reset() noexcept;
+
+        std::shared_ptr<ConnectionPool> pool_;
+        std::unique_ptr<IConnector> conn_;
+        bool broken_ = false;
+    };
+
+    // set of connectors to one alias, checkout is served in FIFO order
+    class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
+    public:
+        using clock = std::chrono::steady_clock;
+        using acquire_handler = std::function<void(std::exception_ptr, PooledConnector)>;
+        static constexpr std::chrono::milliseconds MIN_SWEEP_INTERVAL{10};
+
+        ConnectionPool(asio::io_context& io_ctx,
+                       connector_factory make_connector,
+                       mysql::connect_params params,
+                       std::string alias,
+                       pool_config config = {});
+        ~ConnectionPool();
+
+        // opens min_size connectors, throws if the first one fails, and starts the idle sweep
+        void start();
+        // blocks the calling thread, actors lease through async_acquire
+        PooledConnector acquire();
+        // queues behind earlier waiters, handler runs on the io context once a connector is free,
+        // or with an error once checkout_timeout passes
+        void async_acquire(acquire_handler handler);
+        void close();
+
+        const mysql::connect_params& params() const noexcept { return params_; }
+        const std::string& alias() const noexcept { return alias_; }
+        const pool_config& config() const noexcept { return config_; }
+        size_t size() const;
+        size_t idle() const;
+        bool isClosed() const;
+
+    private:
+        friend class PooledConnector;
+
+        struct idle_connector_t {
+            std::unique_ptr<IConnector> conn;
+            clock::time_point since;
+        };
+
+        // blocking acquire() waits on cv_ and has neither handler nor timer
+        struct waiter_t {
+            uint64_t ticket;
+            acquire_handler handler;
+            std::shared_ptr<asio::steady_timer> timer;
+        };
+
+        // blocking, for start() and acquire() which run on the caller's thread
+        std::unique_ptr<IConnector> open();
+        // for waiters served on the io context
+        asio::awaitable<std::unique_ptr<IConnector>> async_open();
+        void release(std::unique_ptr<IConnector> conn, bool broken) noexcept;
+        bool can_grant() const noexcept { return !idle_.empty() || total_ < config_.max_size; }
+        void serve_waiters();
+        void expire_waiter(uint64_t ticket);
+        std::deque<std::unique_ptr<IConnector>> evict_idle(clock::time_point now);
+        // runs on the io context, idle connectors expire even if nothing is released
+        void schedule_sweep();
+        void sweep();
+
+        log_t log_;
+        asio::io_context& io_ctx_;
+        connector_factory make_connector_;
+        mysql::connect_params params_;
+        std::string alias_;
+        pool_config config_;
+        // shared with pending waits, so a closing pool never destroys a timer in use
+        std::shared_ptr<asio::steady_timer> sweep_timer_;
+
+        mutable std::mutex mtx_;
+        std::condition_variable cv_;
+        std::deque<idle_connector_t> idle_;
+        std::deque<waiter_t> waiters_;
+        uint64_t next_ticket_ = 0;
+        size_t total_ = 0; // idle + checked out + opening
+        bool closed_ = false;
+    };
+
+    using connection_pool_ptr = std::shared_ptr<ConnectionPool>;
+
+} // namespace mysqlc
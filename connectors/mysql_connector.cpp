@@ -94,6 +94,95 @@ namespace mysqlc {
         throw std::runtime_error(error);
     }
 
+    asio::awaitable<void> Connector::async_connect() {
+        if (status_ == Status::Connected) {
+            co_return;
+        }
+        conn_.set_meta_mode(mysql::metadata_mode::full);
+        status_ = Status::Disconnected;
+
+        boost::system::error_code ec;
+        boost::mysql::diagnostics diag;
+        asio::steady_timer backoff(co_await asio::this_coro::executor);
+        for (size_t attempts = 0; attempts < 3; ++attempts) {
+            if (attempts) {
+                backoff.expires_after(std::chrono::milliseconds(200));
+                co_await backoff.async_wait(asio::use_awaitable);
+            }
+            log_->debug("Alias: {} Attempt: {}", alias_, attempts);
+            co_await conn_.async_connect(params_, diag, asio::redirect_error(asio::use_awaitable, ec));
+            if (!ec) {
+                log_->debug("Alias: {} Connect success", alias_);
+                status_ = Status::Connected;
+                co_return;
+            }
+            log_->debug("Alias: {} Connect attempt: {} failed: {} - {}",
+                        alias_,
+                        attempts,
+                        ec.message(),
+                        diag.server_message());
+        }
+        std::string error = "[Connector] Alias: " + alias_ + " connect failed " + ec.message();
+        log_->error(error);
+        throw std::runtime_error(error);
+    }
+
+    asio::awaitable<bool> Connector::async_ping() {
+        if (status_ != Status::Connected) {
+            co_return false;
+        }
+        boost::system::error_code ec;
+        co_await conn_.async_ping(asio::redirect_error(asio::use_awaitable, ec));
+        if (ec) {
+            status_ = Status::Disconnected;
+            log_->debug("Alias: {} Ping failed: {}", alias_, ec.message());
+            co_return false;
+        }
+        co_return true;
+    }
+
+    asio::awaitable<void> Connector::ensureAlive() {
+        if (status_ != Status::Connected) {
+            std::string err = "[Run query] Connector with alias: " + alias_ + " is not connected";
+            log_->error(err);
+            throw std::runtime_error(err);
+        }
+        boost::system::error_code ec;
+        co_await conn_.async_ping(asio::redirect_error(asio::use_awaitable, ec));
+
+        if (ec) {
+            std::string err = "[Run query] Connector with alias: " + alias_ + " ping failed: " + ec.message();
+            log_->error(err);
+            throw std::runtime_error(err);
+        }
+    }
+
+    asio::awaitable<void> Connector::runStreamingQuery(std::string_view query, tsl::mysql_chunk_stream_t& stream) {
+        co_await ensureAlive();
+
+        log_->debug("Alias: {} streaming query: {}", alias_, query);
+        boost::system::error_code ec;
+        mysql::execution_state st;
+        co_await conn_.async_start_execution(query, st, asio::redirect_error(asio::use_awaitable, ec));
+        if (ec) {
+            log_->error("Alias: {} query [{}] failed: {}", alias_, std::string(query), ec.message());
+            throw std::runtime_error("[Run query] Alias: " + alias_ + " query [" + std::string(query) +
+                                     "]\nfailed: " + ec.message());
+        }
+
+        // rows_view points into the connection buffer, so each batch is converted before the next read
+        while (st.should_read_rows()) {
+            auto rows = co_await conn_.async_read_some_rows(st, asio::redirect_error(asio::use_awaitable, ec));
+            if (ec) {
+                log_->error("Alias: {} reading rows of [{}] failed: {}", alias_, std::string(query), ec.message());
+                throw std::runtime_error("[Run query] Alias: " + alias_ + " query [" + std::string(query) +
+                                         "]\nfailed: " + ec.message());
+            }
+            stream.append(st.meta(), rows);
+        }
+        log_->debug("Alias: {} streamed {} rows in {} batches", alias_, stream.size(), stream.batches());
+    }
+
     bool Connector::isClosed() const noexcept { return status_ == Status::Closed; }
     std::string Connector::alias() const noexcept { return alias_; }
 } // namespace mysqlc
\ No newline at end of file
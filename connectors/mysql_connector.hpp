@@ -58,6 +58,9 @@ namespace mysqlc {
         virtual void tryReconnect() = 0;
         virtual bool isClosed() const noexcept = 0;
         virtual std::string alias() const noexcept = 0;
+        // counterparts of connect() with its retries and of isConnected(), for callers running on the io context
+        virtual asio::awaitable<void> async_connect() = 0;
+        virtual asio::awaitable<bool> async_ping() = 0;
 
         virtual asio::awaitable<std::unique_ptr<data_chunk_t>>
         runQuery(std::string_view query,
@@ -67,6 +70,9 @@ namespace mysqlc {
         virtual asio::awaitable<components::catalog::catalog_error>
         runQuery(std::string_view query,
                  std::function<components::catalog::catalog_error(const boost::mysql::results&)> handler) = 0;
+
+        // reads the result in read_some_rows batches and feeds them to stream as they arrive
+        virtual asio::awaitable<void> runStreamingQuery(std::string_view query, tsl::mysql_chunk_stream_t& stream) = 0;
     };
 
     class Connector : public IConnector {
@@ -81,6 +87,8 @@ namespace mysqlc {
         void tryReconnect() override;
         bool isClosed() const noexcept override;
         std::string alias() const noexcept override;
+        asio::awaitable<void> async_connect() override;
+        asio::awaitable<bool> async_ping() override;
 
         asio::awaitable<std::unique_ptr<data_chunk_t>>
         runQuery(std::string_view query,
@@ -96,34 +104,25 @@ namespace mysqlc {
                  std::function<components::catalog::catalog_error(const boost::mysql::results&)> handler) override {
             return runQuery_(query, handler);
         }
+        asio::awaitable<void> runStreamingQuery(std::string_view query, tsl::mysql_chunk_stream_t& stream) override;
 
     private:
         log_t log_;
 
+        asio::awaitable<void> ensureAlive();
+
         template<typename Callable>
         requires std::invocable<Callable, const boost::mysql::results&>
             asio::awaitable<std::invoke_result_t<Callable, const boost::mysql::results&>>
             runQuery_(std::string_view query, Callable handler) {
-            // log_->trace("Thread id: {}", std::this_thread::get_id()); // Removed: fmt doesn't format thread::id
-            if (status_ != Status::Connected) {
-                std::string err = "[Run query] Connector with alias: " + alias_ + " is not connected";
-                log_->error(err);
-                throw std::runtime_error(err);
-            }
-            boost::system::error_code ec;
-            co_await conn_.async_ping(asio::redirect_error(asio::use_awaitable, ec));
-
-            if (ec) {
-                std::string err = "[Run query] Connector with alias: " + alias_ + " ping failed: " + ec.message();
-                log_->error(err);
-                throw std::runtime_error(err);
-            }
+            co_await ensureAlive();
 
             // TODO add timeout or table check asio::cancel_after(std::chrono::seconds(5)) use boost 1.87
             // TODO add atomic working status to block removing while get results from
             // DB
             // Issue the SQL query to the server
             log_->debug("Alias: {} query: {}", alias_, query);
+            boost::system::error_code ec;
             mysql::results result;
             co_await conn_.async_execute(query, result, asio::redirect_error(asio::use_awaitable, ec));
 
@@ -5,6 +5,8 @@
 #include "utility/connection_uid.hpp"
 #include "utility/logger.hpp"
 
+#include <utility>
+
 using namespace components;
 
 namespace mysqlc {
@@ -16,11 +18,13 @@ namespace mysqlc {
 
     ConnectorManager::ConnectorManager(actor_zeta::address_t catalog_manager,
                                        connector_factory make_connector,
-                                       size_t pool_size)
+                                       size_t pool_size,
+                                       pool_config connection_pool)
         : log_(get_logger(logger_tag::CONNECTOR_MANAGER))
         , thread_pool_manager_(pool_size)
         , catalog_manager_(catalog_manager)
-        , make_connector_(make_connector) {
+        , make_connector_(make_connector)
+        , pool_config_(connection_pool) {
         assert(log_.is_valid());
     }
 
@@ -31,39 +35,46 @@ namespace mysqlc {
     void ConnectorManager::stop() { thread_pool_manager_.stop(); }
 
     // TODO add query for adding and removing connections
-    // TODO this is not thread safe!!!
     std::string ConnectorManager::addConnection(mysql::connect_params connection_param, const std::string& uuid) {
+        auto pool = std::make_shared<ConnectionPool>(thread_pool_manager_.ctx(),
+                                                     make_connector_,
+                                                     connection_param,
+                                                     uuid,
+                                                     pool_config_);
         try {
-            std::string addr = std::string(connection_param.server_address.hostname()) + ":" +
-                               std::to_string(connection_param.server_address.port());
-
             log_->debug("Try add connection with uuid: {}", uuid);
-            connections_[uuid] = make_connector_(thread_pool_manager_.ctx(), connection_param, uuid);
-            connections_[uuid]->connect();
-
-            collection_full_name_t name(connection_param.database, uuid, uuid); // treat uuid as schema
-            actor_zeta::send(catalog_manager_->address(),
-                             catalog_manager_->address(),
-                             catalog_manager::handler_id(catalog_manager::route::add_connection_schema),
-                             std::move(name));
-            return uuid;
+            pool->start();
         } catch (const boost::mysql::error_with_diagnostics& e) {
             log_->error("MySQL error occurred - Error code: {}, Message: {}, Diagnostics: {}",
                         e.code().value(),
                         e.what(),
                         e.get_diagnostics().server_message());
-            connections_[uuid]->close();
-            connections_.erase(uuid);
+            pool->close();
             throw std::runtime_error("Add connection asio error: " + std::string(e.what()));
         } catch (const std::exception& e) {
             log_->error("Error: {}", e.what());
-            connections_[uuid]->close();
-            connections_.erase(uuid);
+            pool->close();
             throw std::runtime_error("Add connection common error: " + std::string(e.what()));
         }
+
+        connection_pool_ptr previous;
+        {
+            std::unique_lock lock(pools_mtx_);
+            previous = std::exchange(pools_[uuid], std::move(pool));
+        }
+        if (previous) {
+            previous->close();
+        }
+
+        // catalog queries the new connection synchronously, so the lock must be released here
+        collection_full_name_t name(connection_param.database, uuid, uuid); // treat uuid as schema
+        actor_zeta::send(catalog_manager_->address(),
+                         catalog_manager_->address(),
+                         catalog_manager::handler_id(catalog_manager::route::add_connection_schema),
+                         std::move(name));
+        return uuid;
     }
 
-    // TODO not threadsafe!!!
     std::string ConnectorManager::addConnection(http_server::ConnectionParams connection_param) {
         boost::mysql::connect_params params;
         log_->debug("Try add connection with alias: {}", connection_param.alias);
@@ -81,28 +92,173 @@ namespace mysqlc {
     }
 
     void ConnectorManager::removeConnection(const std::string& uuid) {
-        auto conn = connections_.find(uuid);
-        if (conn == connections_.end()) {
-            log_->error("Invalid connection uuid: {}", uuid);
-            throw std::runtime_error("Invalid connection uuid: : " + uuid);
+        connection_pool_ptr pool;
+        {
+            std::unique_lock lock(pools_mtx_);
+            auto it = pools_.find(uuid);
+            if (it == pools_.end()) {
+                log_->error("Invalid connection uuid: {}", uuid);
+                throw std::runtime_error("Invalid connection uuid: : " + uuid);
+            }
+            pool = std::move(it->second);
+            pools_.erase(it);
         }
-        conn->second->close();
-        connections_.erase(uuid);
+        // leased connectors are closed when their queries return them
+        pool->close();
         actor_zeta::send(catalog_manager_->address(),
                          catalog_manager_->address(),
                          catalog_manager::handler_id(catalog_manager::route::remove_connection_schema),
                          uuid);
     }
 
-    size_t ConnectorManager::totalConnections() const noexcept { return connections_.size(); }
+    void ConnectorManager::executeStreamingQuery(const std::string& uuid,
+                                                 std::string query,
+                                                 std::pmr::memory_resource* resource,
+                                                 chunk_handler done) {
+        executeStreamingScript(uuid, {}, std::move(query), {}, resource, 0, std::move(done));
+    }
+
+    void ConnectorManager::executeStreamingScript(const std::string& uuid,
+                                                  std::vector<std::string> setup,
+                                                  std::string query,
+                                                  std::string cleanup,
+                                                  std::pmr::memory_resource* resource,
+                                                  size_t expected_rows,
+                                                  chunk_handler done) {
+        auto pool = find_pool(uuid);
+        if (!pool || pool->isClosed()) {
+            log_->error("[ConnectorManager::executeStreamingScript] Invalid connection uuid: {}", uuid);
+            auto error = std::make_exception_ptr(
+                std::runtime_error("[ConnectorManager::executeStreamingScript]  Invalid connection uuid: " + uuid));
+            asio::post(thread_pool_manager_.ctx(), [done = std::move(done), error] { done(error, {}); });
+            return;
+        }
+
+        pool->async_acquire([this,
+                             uuid,
+                             setup = std::move(setup),
+                             query = std::move(query),
+                             cleanup = std::move(cleanup),
+                             resource,
+                             expected_rows,
+                             done = std::move(done)](std::exception_ptr err, PooledConnector conn) mutable {
+            if (err) {
+                done(err, {});
+                return;
+            }
+            co_spawn(thread_pool_manager_.ctx(),
+                     runPooledStreaming(this,
+                                        std::move(uuid),
+                                        std::move(conn),
+                                        std::move(setup),
+                                        std::move(query),
+                                        std::move(cleanup),
+                                        resource,
+                                        expected_rows),
+                     [done = std::move(done)](std::exception_ptr e, streamed_result_t result) {
+                         done(e, std::move(result));
+                     });
+        });
+    }
+
+    asio::awaitable<ConnectorManager::streamed_result_t>
+    ConnectorManager::runPooledStreaming(ConnectorManager* self,
+                                         std::string uuid,
+                                         PooledConnector conn,
+                                         std::vector<std::string> setup,
+                                         std::string query,
+                                         std::string cleanup,
+                                         std::pmr::memory_resource* resource,
+                                         size_t expected_rows) {
+        co_await self->revive(conn, std::move(uuid));
+        auto affected_rows = [](const mysql::results& result) { return static_cast<int64_t>(result.affected_rows()); };
+        tsl::mysql_chunk_stream_t stream(resource, tsl::mysql_chunk_stream_t::DEFAULT_CHUNK_ROWS, expected_rows);
+        streamed_result_t result;
+        try {
+            for (const auto& statement : setup) {
+                co_await conn->runQuery(statement, std::function<int64_t(const mysql::results&)>(affected_rows));
+            }
+            co_await conn->runStreamingQuery(query, stream);
+            result.rows = stream.size();
+            result.bytes = stream.bytes();
+            result.chunks = stream.finish();
+        } catch (...) {
+            // a connection closed mid-script also drops whatever the script created in its session
+            conn.invalidate();
+            throw;
+        }
+        if (!cleanup.empty()) {
+            try {
+                co_await conn->runQuery(cleanup, std::function<int64_t(const mysql::results&)>(affected_rows));
+            } catch (...) {
+                // leftovers of the script must not leak into the next lease
+                conn.invalidate();
+            }
+        }
+        co_return result;
+    }
+
+    size_t ConnectorManager::totalConnections() const noexcept {
+        std::shared_lock lock(pools_mtx_);
+        return pools_.size();
+    }
 
     std::optional<mysql::connect_params> ConnectorManager::conn_params(const std::string& uuid) const {
-        auto conn = connections_.find(uuid);
-        if (conn == connections_.end()) {
+        auto pool = find_pool(uuid);
+        if (!pool) {
             return std::nullopt;
         }
-        return conn->second->params();
+        return pool->params();
+    }
+
+    bool ConnectorManager::hasConnection(const std::string& uuid) const noexcept {
+        std::shared_lock lock(pools_mtx_);
+        return pools_.contains(uuid);
     }
 
-    bool ConnectorManager::hasConnection(const std::string& uuid) const noexcept { return connections_.contains(uuid); }
-} // namespace mysqlc
\ No newline at end of file
+    connection_pool_ptr ConnectorManager::find_pool(const std::string& uuid) const {
+        std::shared_lock lock(pools_mtx_);
+        auto it = pools_.find(uuid);
+        return it == pools_.end() ? nullptr : it->second;
+    }
+
+    asio::awaitable<PooledConnector> ConnectorManager::checkout(std::string uuid) {
+        auto pool = find_pool(uuid);
+        if (!pool) {
+            log_->error("[ConnectorManager::executeQuery] Invalid connection uuid: {}", uuid);
+            throw std::runtime_error("[ConnectorManager::executeQuery]  Invalid connection uuid: " + uuid);
+        }
+        if (pool->isClosed()) {
+            log_->error("[ConnectorManager::executeQuery] Connector is not connected");
+            throw std::runtime_error("[ConnectorManager::executeQuery]  Connector is not connected\n");
+        }
+
+        auto conn = co_await asio::async_initiate<decltype(use_awaitable), void(std::exception_ptr, PooledConnector)>(
+            [pool](auto handler) {
+                // acquire_handler must be copyable, the completion handler is move-only
+                auto shared = std::make_shared<decltype(handler)>(std::move(handler));
+                pool->async_acquire([shared](std::exception_ptr err, PooledConnector leased) {
+                    (*shared)(err, std::move(leased));
+                });
+            },
+            use_awaitable);
+        co_await revive(conn, std::move(uuid));
+        co_return conn;
+    }
+
+    asio::awaitable<void> ConnectorManager::revive(PooledConnector& conn, std::string uuid) {
+        if (co_await conn->async_ping()) {
+            co_return;
+        }
+        try {
+            co_await conn->async_connect();
+        } catch (const std::exception& e) {
+            conn.invalidate();
+            actor_zeta::send(catalog_manager_->address(),
+                             catalog_manager_->address(),
+                             catalog_manager::handler_id(catalog_manager::route::remove_connection_schema),
+                             uuid);
+            throw std::runtime_error("Failed to reconnect. Error message: " + std::string(e.what()));
+        }
+    }
+} // namespace mysqlc
@@ -5,6 +5,7 @@
 
 #include <components/log/log.hpp>
 
+#include "connection_pool.hpp"
 #include "mysql_connector.hpp"
 
 #include <concepts>
@@ -14,9 +15,11 @@
 #include <thread>
 
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "http_server/connection_config.hpp"
 #include "routes/catalog_manager.hpp"
@@ -40,13 +43,13 @@ namespace mysqlc {
     public:
         ConnectorManager(actor_zeta::address_t catalog_manager,
                          connector_factory make_connector = make_mysql_connector,
-                         size_t pool_size = std::thread::hardware_concurrency());
+                         size_t pool_size = std::thread::hardware_concurrency(),
+                         pool_config connection_pool = {});
         thread_pool_status status() const noexcept;
         void start();
         void stop();
 
         // TODO add query for adding and removing connections
-        // TODO this is not thread safe!!!
         std::string addConnection(mysql::connect_params connection_param, const std::string& uuid);
         std::string addConnection(http_server::ConnectionParams connection_param);
         void removeConnection(const std::string& uuid);
@@ -55,38 +58,87 @@ namespace mysqlc {
         requires std::invocable<Callable, const boost::mysql::results&>
             std::future<std::invoke_result_t<Callable, const boost::mysql::results&>>
             executeQuery(const std::string& uuid, std::string_view query, Callable handler) {
-            auto conn = connections_.find(uuid);
-            if (conn == connections_.end()) {
-                log_->error("[ConnectorManager::executeQuery] Invalid connection uuid: {}", uuid);
-                throw std::runtime_error("[ConnectorManager::executeQuery]  Invalid connection uuid: " + uuid);
-            }
-            if (conn->second->status() == Status::Closed) {
-                log_->error("[ConnectorManager::executeQuery] Connector is not connected");
-                throw std::runtime_error("[ConnectorManager::executeQuery]  Connector is not connected\n");
-            }
-            if (!conn->second->isConnected()) {
-                try {
-                    conn->second->tryReconnect();
-                } catch (const std::exception& e) {
-                    actor_zeta::send(catalog_manager_->address(),
-                                     catalog_manager_->address(),
-                                     catalog_manager::handler_id(catalog_manager::route::remove_connection_schema),
-                                     uuid);
-                    throw std::runtime_error("Failed to reconnect. Error message: " + std::string(e.what()));
-                }
-            }
-            return co_spawn(thread_pool_manager_.ctx(), conn->second->runQuery(query, handler), asio::use_future);
+            // the connector is leased on the io context, a full pool never blocks the caller
+            return co_spawn(thread_pool_manager_.ctx(),
+                            runPooled(this, uuid, std::string(query), std::move(handler)),
+                            asio::use_future);
         }
 
+        // same query without a future, done(std::exception_ptr, result) runs on the io context
+        template<typename Callable, typename Done>
+        requires std::invocable<Callable, const boost::mysql::results&>
+        void executeQuery(const std::string& uuid, std::string_view query, Callable handler, Done done) {
+            co_spawn(thread_pool_manager_.ctx(),
+                     runPooled(this, uuid, std::string(query), std::move(handler)),
+                     std::move(done));
+        }
+
+        // rows of a streamed query in bounded chunks, see tsl::mysql_chunk_stream_t, and the payload they took
+        // on the wire
+        struct streamed_result_t {
+            std::vector<std::unique_ptr<data_chunk_t>> chunks;
+            size_t rows = 0;
+            size_t bytes = 0;
+        };
+        using chunk_handler = std::function<void(std::exception_ptr, streamed_result_t)>;
+
+        // rows are converted batch by batch while the query is still reading from the server,
+        // done runs on the io context and receives every error, nothing blocks the caller
+        void executeStreamingQuery(const std::string& uuid,
+                                   std::string query,
+                                   std::pmr::memory_resource* resource,
+                                   chunk_handler done);
+        // setup statements and the query share one pooled connection, so session state such as temporary
+        // tables is visible to the query. cleanup runs afterwards, a connection it fails on is not reused.
+        // expected_rows sizes the first chunk, see tsl::mysql_chunk_stream_t
+        void executeStreamingScript(const std::string& uuid,
+                                    std::vector<std::string> setup,
+                                    std::string query,
+                                    std::string cleanup,
+                                    std::pmr::memory_resource* resource,
+                                    size_t expected_rows,
+                                    chunk_handler done);
+
         size_t totalConnections() const noexcept;
         std::optional<mysql::connect_params> conn_params(const std::string& uuid) const;
         bool hasConnection(const std::string& uuid) const noexcept;
 
     private:
+        connection_pool_ptr find_pool(const std::string& uuid) const;
+        // leases a live connector without blocking, a pool that can't reconnect is dropped from the catalog
+        asio::awaitable<PooledConnector> checkout(std::string uuid);
+
+        template<typename Callable>
+        static asio::awaitable<std::invoke_result_t<Callable, const boost::mysql::results&>>
+        runPooled(ConnectorManager* self, std::string uuid, std::string query, Callable handler) {
+            auto conn = co_await self->checkout(std::move(uuid));
+            try {
+                co_return co_await conn->runQuery(query, std::move(handler));
+            } catch (...) {
+                // connection state is unknown after a failure, don't hand it out again
+                conn.invalidate();
+                throw;
+            }
+        }
+
+        // pings a leased connector and reconnects it without blocking the io context,
+        // a connection that can't be restored is dropped from the catalog
+        asio::awaitable<void> revive(PooledConnector& conn, std::string uuid);
+        static asio::awaitable<streamed_result_t> runPooledStreaming(ConnectorManager* self,
+                                                                     std::string uuid,
+                                                                     PooledConnector conn,
+                                                                     std::vector<std::string> setup,
+                                                                     std::string query,
+                                                                     std::string cleanup,
+                                                                     std::pmr::memory_resource* resource,
+                                                                     size_t expected_rows);
+
         log_t log_;
         thread_pool_manager thread_pool_manager_;
         actor_zeta::address_t catalog_manager_;
         connector_factory make_connector_;
-        std::unordered_map<std::string, std::unique_ptr<mysqlc::IConnector>> connections_;
+        pool_config pool_config_;
+        mutable std::shared_mutex pools_mtx_;
+        std::unordered_map<std::string, connection_pool_ptr> pools_;
     };
 } // namespace mysqlc
\ No newline at end of file
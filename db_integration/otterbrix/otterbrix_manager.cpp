@@ -27,7 +27,6 @@ OtterbrixManager::OtterbrixManager(std::pmr::memory_resource* res, std::unique_p
                                             &OtterbrixManager::get_schema))
     , log_(get_logger(logger_tag::OTTERBRIX_MANAGER)) {
     assert(log_.is_valid());
-    worker_.start(); // Start the worker thread manager
 }
 
 auto OtterbrixManager::make_scheduler() noexcept -> actor_zeta::scheduler_abstract_t* {
@@ -119,14 +118,19 @@ auto OtterbrixManager::get_schema(session_hash_t id,
 void OtterbrixManager::send_schema(session_hash_t id,
                                    components::cursor::cursor_t_ptr cursor,
                                    ParsedQueryDataPtr&& data) {
-    auto send_task = [this, id, cursor_data = std::move(cursor), &data]() mutable {
+    // tasks run on the shared executor, so everything they need is captured now
+    auto send_task = [this,
+                      id,
+                      reply_to = current_message()->sender(),
+                      cursor_data = std::move(cursor),
+                      data_holder = std::make_shared<ParsedQueryDataPtr>(std::move(data))]() mutable {
         log_->trace("get_schema send task");
-        actor_zeta::send(current_message()->sender(),
+        actor_zeta::send(reply_to,
                          address(),
                          scheduler::handler_id(scheduler::route::get_otterbrix_schema_finish),
                          id,
                          std::move(cursor_data),
-                         std::move(data));
+                         std::move(*data_holder));
     };
     if (!worker_.addTask(std::move(send_task))) {
         log_->error("get_schema failed to add task to worker");
@@ -136,9 +140,9 @@ void OtterbrixManager::send_schema(session_hash_t id,
 }
 
 void OtterbrixManager::send_result(session_hash_t id, components::cursor::cursor_t_ptr cursor) {
-    auto send_task = [this, id, cursor_data = std::move(cursor)]() mutable {
+    auto send_task = [this, id, reply_to = current_message()->sender(), cursor_data = std::move(cursor)]() mutable {
         log_->trace("execute send task");
-        actor_zeta::send(current_message()->sender(),
+        actor_zeta::send(reply_to,
                          address(),
                          scheduler::handler_id(scheduler::route::execute_otterbrix_finish),
                          id,
@@ -153,8 +157,8 @@ void OtterbrixManager::send_result(session_hash_t id, components::cursor::cursor
 
 void OtterbrixManager::send_error(session_hash_t id, std::string error_msg) {
     log_->error("execute caught exception: {}", error_msg);
-    auto send_task = [this, id, msg = std::move(error_msg)]() mutable {
-        actor_zeta::send(current_message()->sender(),
+    auto send_task = [this, id, reply_to = current_message()->sender(), msg = std::move(error_msg)]() mutable {
+        actor_zeta::send(reply_to,
                          address(),
                          scheduler::handler_id(scheduler::route::execute_failed),
                          id,
@@ -8,10 +8,13 @@
 #include "routes/scheduler.hpp"
 #include "routes/sql_connection_manager.hpp"
 #include "utility/cv_wrapper.hpp"
-#include "utility/timer.hpp"
-#include "utility/wait_barrier.hpp"
 #include "utility/logger.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
 using namespace db_conn;
 SqlConnectionManager::SqlConnectionManager(std::pmr::memory_resource* res,
                                            std::shared_ptr<mysqlc::ConnectorManager> connector_manager)
@@ -26,7 +29,6 @@ SqlConnectionManager::SqlConnectionManager(std::pmr::memory_resource* res,
     assert(res != nullptr);
     assert(connector_manager_ != nullptr);
     connector_manager_->start(); // Start the connector manager
-    worker_.start();             // Start the worker thread manager
 }
 
 auto SqlConnectionManager::make_scheduler() noexcept -> actor_zeta::scheduler_abstract_t* {
@@ -36,6 +38,8 @@ auto SqlConnectionManager::make_scheduler() noexcept -> actor_zeta::scheduler_ab
 
 auto SqlConnectionManager::make_type() const noexcept -> const char* const { return "SQLConnectionManager"; }
 
+void SqlConnectionManager::set_query_feedback(query_feedback_ptr feedback) { feedback_ = std::move(feedback); }
+
 auto SqlConnectionManager::enqueue_impl(actor_zeta::message_ptr msg, actor_zeta::execution_unit*) -> void {
     std::unique_lock<std::mutex> _(input_mtx_);
     set_current_message(std::move(msg));
@@ -53,92 +57,272 @@ actor_zeta::behavior_t SqlConnectionManager::behavior() {
     });
 }
 
+struct SqlConnectionManager::remote_execution_t {
+    session_hash_t id;
+    actor_zeta::address_t reply_to;
+    ParsedQueryDataPtr data;
+    // batches left to run, the next one is external_nodes[remaining_batches - 1]
+    size_t remaining_batches;
+    std::vector<std::unique_ptr<data_chunk_t>> results;
+    // targets of the current batch start once their reducer has completed
+    std::vector<schema_utils::semi_join_t> semi_joins;
+    std::atomic<size_t> pending{0};
+    std::mutex error_mtx;
+    std::string error;
+};
+
+namespace {
+    constexpr size_t KEY_TABLE_ROWS_PER_INSERT = 1000;
+    // room above the observed row count of a shape, so a result that grew a little still fits its first chunk
+    constexpr double EXPECTED_ROWS_HEADROOM = 1.25;
+
+    std::string generate_remote_query(const logical_plan::node_ptr& node,
+                                      const logical_plan::storage_parameters* parameters,
+                                      std::string_view filter = {}) {
+        if (node->type() == logical_plan::node_type::unused) {
+            // this is a schema node, push pre-generated query
+            auto& schema_node = static_cast<schema_utils::schema_node_t&>(*node);
+            return sql_gen::generate_query(schema_node.agg_node(), parameters, &schema_node.schema(), filter);
+        }
+        return sql_gen::generate_query(node, parameters, nullptr, filter);
+    }
+
+    std::string describe_error(std::exception_ptr error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const boost::mysql::error_with_diagnostics& err) {
+            return "SqlConnectionManager::execute caught boost::mysql exception: " + std::string(err.what()) +
+                   ", server diagnostics: " + std::string(err.get_diagnostics().server_message());
+        } catch (const std::exception& e) {
+            return e.what();
+        } catch (...) {
+            return "SqlConnectionManager::execute caught unknown exception";
+        }
+    }
+} // namespace
+
 auto SqlConnectionManager::execute(session_hash_t id, ParsedQueryDataPtr&& data) -> void {
     assert(data);
+    log_->trace("execute, id hash: {}", id);
+
+    auto state = std::make_shared<remote_execution_t>();
+    state->id = id;
+    state->reply_to = current_message()->sender();
+    state->data = std::move(data);
+    state->remaining_batches = state->data->otterbrix_params->external_nodes.size();
+
+    log_->debug("execute Total execute queries: {}", state->data->otterbrix_params->external_nodes_count);
+    log_->debug("execute Execute batches: {}", state->remaining_batches);
+    dispatch_batch(std::move(state));
+}
+
+void SqlConnectionManager::dispatch_batch(remote_execution_ptr state) {
+    auto& batches = state->data->otterbrix_params->external_nodes;
+    while (state->remaining_batches > 0 && batches[state->remaining_batches - 1].empty()) {
+        --state->remaining_batches;
+    }
+    if (state->remaining_batches == 0) {
+        log_->debug("execute finished");
+        send_result(state);
+        return;
+    }
+
+    auto& batch = batches[state->remaining_batches - 1];
+    log_->debug("execute Current batch size: {}", batch.size());
+    state->semi_joins = schema_utils::plan_semi_joins(state->data->otterbrix_params->node, batch);
+    std::vector<bool> deferred(batch.size(), false);
+    for (const auto& semi_join : state->semi_joins) {
+        deferred[semi_join.target] = true;
+    }
+
+    std::vector<std::string> generated_queries(batch.size());
     try {
-        Timer timer("SqlConnectionManager::execute");
-
-        log_->trace("execute, id hash: {}", id);
-
-        // Create a handler to convert mysql results to data_chunk_t
-        auto data_converter = [this](const boost::mysql::results& result) -> std::unique_ptr<data_chunk_t> {
-            return std::make_unique<data_chunk_t>(tsl::mysql_to_chunk(this->resource(), result));
-        };
-
-        log_->debug("execute Total execute queries: {}", data->otterbrix_params->external_nodes_count);
-        log_->debug("execute Execute batches: {}", data->otterbrix_params->external_nodes.size());
-        // Execute queries
-        size_t counter = 0;
-        for (auto it = data->otterbrix_params->external_nodes.rbegin();
-             it != data->otterbrix_params->external_nodes.rend();
-             ++it) {
-            log_->debug("execute Current batch size: {}", it->size());
-            std::vector<std::string> generated_queries;
-            generated_queries.reserve(it->size());
-            // wrapped in unique_ptr because data_chunk does not have a default constructor
-            QueryHandleWaiter<std::unique_ptr<components::vector::data_chunk_t>> wait_guard{};
-            // Order inside batch does not matter
-            for (size_t i = 0; i < it->size(); i++) {
-                log_->trace("Execute query: {}", ++counter);
-                // TODO we can't run multiple queries on the same connection
-                // TODO error for empty returns
-                // move to connection pool instead of single connection
-
-                auto& node = *(*it)[i];
-                log_->trace("UID: {}", node->collection_full_name().unique_identifier);
-
-                if (node->type() == logical_plan::node_type::unused) {
-                    // this is a schema node, push pre-generated query
-                    generated_queries.emplace_back(
-                        sql_gen::generate_query(static_cast<schema_utils::schema_node_t&>(*node).agg_node(),
-                                                &data->otterbrix_params->params_node->parameters()));
-                } else {
-                    generated_queries.emplace_back(
-                        sql_gen::generate_query(node, &data->otterbrix_params->params_node->parameters()));
-                }
-                log_->debug("execute Generated SQL Query: \"{}\"", generated_queries.back());
-                wait_guard.futures.push_back(
-                    connector_manager_->executeQuery(node->collection_full_name().unique_identifier,
-                                                     generated_queries[i],
-                                                     data_converter));
+        // Order inside batch does not matter
+        for (size_t i = 0; i < batch.size(); i++) {
+            // TODO error for empty returns
+            log_->trace("UID: {}", (*batch[i])->collection_full_name().unique_identifier);
+            if (deferred[i]) {
+                continue;
+            }
+            generated_queries[i] =
+                generate_remote_query(*batch[i], &state->data->otterbrix_params->params_node->parameters());
+            log_->debug("execute Generated SQL Query: \"{}\"", generated_queries[i]);
+        }
+    } catch (...) {
+        send_error(state, describe_error(std::current_exception()));
+        return;
+    }
+
+    state->results.clear();
+    state->results.resize(batch.size());
+    state->pending = batch.size();
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (!deferred[i]) {
+            launch_query(state, i, std::move(generated_queries[i]));
+        }
+    }
+}
+
+void SqlConnectionManager::launch_query(const remote_execution_ptr& state,
+                                        size_t index,
+                                        std::string query,
+                                        std::vector<std::string> setup,
+                                        std::string cleanup) {
+    auto& batch = state->data->otterbrix_params->external_nodes[state->remaining_batches - 1];
+    auto shape = feedback_ ? sql_gen::normalize_query(query) : std::string();
+    // raw data nodes take a single chunk. rows of a shape seen before are decoded straight into one chunk sized
+    // by its observed row count, so only results that outgrew it are joined from their bounded chunks
+    size_t expected_rows = 0;
+    if (feedback_) {
+        if (auto observed = feedback_->lookup(shape); observed) {
+            expected_rows = static_cast<size_t>(observed->rows * EXPECTED_ROWS_HEADROOM);
+        }
+    }
+    // rows are decoded as they arrive, the full mysql result is never held in memory
+    connector_manager_->executeStreamingScript(
+        (*batch[index])->collection_full_name().unique_identifier,
+        std::move(setup),
+        std::move(query),
+        std::move(cleanup),
+        resource(),
+        expected_rows,
+        [this, state, index, shape = std::move(shape), start = std::chrono::steady_clock::now()](
+            std::exception_ptr error,
+            mysqlc::ConnectorManager::streamed_result_t result) {
+            if (feedback_ && !error) {
+                feedback_->record(shape,
+                                  result.rows,
+                                  result.bytes,
+                                  std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::steady_clock::now() - start));
+            }
+            // a result within its expected rows is a single chunk and is moved as is
+            complete_query(state,
+                           index,
+                           error,
+                           error || result.chunks.empty() ? nullptr
+                                                          : tsl::concat_chunks(resource(), std::move(result.chunks)));
+        });
+}
+
+// runs on a connector thread, once the reducer's rows are in
+void SqlConnectionManager::dispatch_semi_join(const remote_execution_ptr& state,
+                                              const schema_utils::semi_join_t& semi_join,
+                                              std::exception_ptr error) {
+    if (error) {
+        complete_query(state, semi_join.target, error, nullptr);
+        return;
+    }
+
+    std::string filter;
+    std::vector<std::string> setup;
+    std::string cleanup;
+    if (const auto& reduced = state->results[semi_join.reducer]; reduced) {
+        for (size_t column = 0; column < reduced->column_count(); ++column) {
+            if (reduced->types()[column].alias() != semi_join.reducer_key) {
+                continue;
             }
-            // wait for all queries to finish
-            wait_guard.wait();
-            log_->debug("execute Run Query Success!");
-            assert(generated_queries.size() == it->size());
-            for (size_t i = 0; i < it->size(); i++) {
-                auto data_node =
-                    logical_plan::make_node_raw_data(resource(), std::move(*wait_guard.results[i].release()));
-                *(*it)[i] = data_node;
+            // the reducer's row count bounds its distinct keys
+            auto shipping = schema_utils::choose_key_shipping(reduced->size(), semi_join.target_rows);
+            try {
+                switch (shipping) {
+                    case schema_utils::key_shipping::key_table: {
+                        // temporary tables are per session, the name only has to be unique on the leased connection
+                        auto table = "__otterstax_keys_" + std::to_string(semi_join.target);
+                        setup = sql_gen::generate_key_table(table, *reduced, column, KEY_TABLE_ROWS_PER_INSERT);
+                        filter = sql_gen::generate_key_table_filter(semi_join.target_key, table);
+                        cleanup = sql_gen::generate_drop_key_table(table);
+                        break;
+                    }
+                    case schema_utils::key_shipping::in_list:
+                        filter = sql_gen::generate_key_filter(semi_join.target_key,
+                                                              *reduced,
+                                                              column,
+                                                              schema_utils::SEMI_JOIN_IN_LIST_LIMIT);
+                        break;
+                    case schema_utils::key_shipping::range:
+                        filter = sql_gen::generate_key_filter(semi_join.target_key, *reduced, column, 0);
+                        break;
+                }
+            } catch (const std::exception& e) {
+                // a key type the generator can't write: the range needs only literals, no filter is still correct
+                log_->warn("execute semi-join keys of {} are not shipped as planned: {}",
+                           semi_join.target_key,
+                           e.what());
+                setup.clear();
+                cleanup.clear();
+                filter.clear();
+                if (shipping == schema_utils::key_shipping::key_table) {
+                    try {
+                        filter = sql_gen::generate_key_filter(semi_join.target_key, *reduced, column, 0);
+                    } catch (const std::exception&) {
+                        filter.clear();
+                    }
+                }
             }
+            break;
         }
-        send_result(id, std::move(data));
-        log_->debug("execute finished");
-    } catch (const boost::mysql::error_with_diagnostics& err) {
-        std::string error_msg =
-            "SqlConnectionManager::execute caught boost::mysql exception: " + std::string(err.what()) +
-            ", server diagnostics: " + std::string(err.get_diagnostics().server_message());
-        log_->error("execute caught boost::mysql::error_with_diagnostics: {}, error code: {}, server diagnostics: {}",
-                    err.what(),
-                    err.code().value(),
-                    err.get_diagnostics().server_message());
-        send_error(id, error_msg);
-    } catch (const std::exception& e) {
-        send_error(id, e.what());
+    }
+
+    auto& batch = state->data->otterbrix_params->external_nodes[state->remaining_batches - 1];
+    std::string query;
+    try {
+        query = generate_remote_query(*batch[semi_join.target],
+                                      &state->data->otterbrix_params->params_node->parameters(),
+                                      filter);
     } catch (...) {
-        std::string error_msg = "SqlConnectionManager::execute caught unknown exception";
-        send_error(id, error_msg);
+        complete_query(state, semi_join.target, std::current_exception(), nullptr);
+        return;
+    }
+    log_->debug("execute Generated semi-join SQL Query: \"{}\", key table statements: {}", query, setup.size());
+    launch_query(state, semi_join.target, std::move(query), std::move(setup), std::move(cleanup));
+}
+
+// runs on a connector thread
+void SqlConnectionManager::complete_query(const remote_execution_ptr& state,
+                                          size_t index,
+                                          std::exception_ptr error,
+                                          std::unique_ptr<data_chunk_t> chunk) {
+    if (error) {
+        std::lock_guard lock(state->error_mtx);
+        if (state->error.empty()) {
+            state->error = describe_error(error);
+        }
+    } else {
+        state->results[index] = std::move(chunk);
+    }
+    for (const auto& semi_join : state->semi_joins) {
+        if (semi_join.reducer == index) {
+            dispatch_semi_join(state, semi_join, error);
+        }
+    }
+    if (state->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    // last query of the batch
+    if (!state->error.empty()) {
+        send_error(state, state->error);
+        return;
+    }
+    log_->debug("execute Run Query Success!");
+    auto& batch = state->data->otterbrix_params->external_nodes[state->remaining_batches - 1];
+    for (size_t i = 0; i < batch.size(); i++) {
+        *batch[i] = logical_plan::make_node_raw_data(resource(), std::move(*state->results[i]));
     }
+    state->results.clear();
+    --state->remaining_batches;
+    dispatch_batch(state);
 }
 
-void SqlConnectionManager::send_result(session_hash_t id, ParsedQueryDataPtr&& data) {
-    auto send_task = [this, id, &data]() mutable {
+void SqlConnectionManager::send_result(const remote_execution_ptr& state) {
+    auto send_task = [this, state]() mutable {
         log_->trace("execute send task");
-        actor_zeta::send(current_message()->sender(),
+        actor_zeta::send(state->reply_to,
                          address(),
                          scheduler::handler_id(scheduler::route::execute_remote_sql_finish),
-                         id,
-                         std::move(data));
+                         state->id,
+                         std::move(state->data));
     };
     if (!worker_.addTask(std::move(send_task))) {
         log_->error("execute failed to add task to worker");
@@ -147,13 +331,13 @@ void SqlConnectionManager::send_result(session_hash_t id, ParsedQueryDataPtr&& d
     }
 }
 
-void SqlConnectionManager::send_error(session_hash_t id, std::string error_msg) {
+void SqlConnectionManager::send_error(const remote_execution_ptr& state, std::string error_msg) {
     log_->error("{}", error_msg);
-    auto send_task = [this, id, msg = std::move(error_msg)]() mutable {
-        actor_zeta::send(current_message()->sender(),
+    auto send_task = [this, state, msg = std::move(error_msg)]() mutable {
+        actor_zeta::send(state->reply_to,
                          address(),
                          scheduler::handler_id(scheduler::route::execute_failed),
-                         id,
+                         state->id,
                          std::move(msg));
     };
     if (!worker_.addTask(std::move(send_task))) {
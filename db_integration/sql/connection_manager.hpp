@@ -9,12 +9,16 @@
 #include "connectors/mysql_manager.hpp"
 #include "otterbrix/parser/parser.hpp"
 #include "scheduler/schema_utils.hpp"
+#include "utility/query_feedback.hpp"
 #include "utility/session.hpp"
 #include "utility/worker.hpp"
 
+#include <exception>
 #include <functional>
+#include <memory>
 #include <memory_resource>
 #include <string>
+#include <vector>
 
 namespace db_conn {
     class SqlConnectionManager final : public actor_zeta::cooperative_supervisor<SqlConnectionManager> {
@@ -24,23 +28,47 @@ namespace db_conn {
         actor_zeta::behavior_t behavior();
         auto make_scheduler() noexcept -> actor_zeta::scheduler_abstract_t*;
         auto make_type() const noexcept -> const char* const;
+        // rows, bytes and latency of every remote query are recorded under its normalized shape
+        void set_query_feedback(query_feedback_ptr feedback);
 
     protected:
         auto enqueue_impl(actor_zeta::message_ptr msg, actor_zeta::execution_unit*) -> void final;
 
     private:
+        struct remote_execution_t;
+        using remote_execution_ptr = std::shared_ptr<remote_execution_t>;
+
         std::shared_ptr<mysqlc::ConnectorManager> connector_manager_;
+        query_feedback_ptr feedback_;
         // Behaviors
         actor_zeta::behavior_t execute_;
         log_t log_;
 
-        /// async method
+        /// async method, returns once the first batch is dispatched
         auto execute(session_hash_t id, ParsedQueryDataPtr&& data) -> void;
 
-        void send_error(session_hash_t id, std::string error_msg);
-        void send_result(session_hash_t id, ParsedQueryDataPtr&& data);
+        // batches run from the last one to the first, each one starts when the previous one completed
+        void dispatch_batch(remote_execution_ptr state);
+        // setup and cleanup run around the query on the same connection
+        void launch_query(const remote_execution_ptr& state,
+                          size_t index,
+                          std::string query,
+                          std::vector<std::string> setup = {},
+                          std::string cleanup = {});
+        // semi-join target is sent restricted to the reducer's keys, either inline in the query or through
+        // a temporary table loaded on the target's backend, see schema_utils::choose_key_shipping
+        void dispatch_semi_join(const remote_execution_ptr& state,
+                                const schema_utils::semi_join_t& semi_join,
+                                std::exception_ptr error);
+        void complete_query(const remote_execution_ptr& state,
+                            size_t index,
+                            std::exception_ptr error,
+                            std::unique_ptr<data_chunk_t> chunk);
+
+        void send_error(const remote_execution_ptr& state, std::string error_msg);
+        void send_result(const remote_execution_ptr& state);
 
         std::mutex input_mtx_;
-        TaskManager<std::function<void()>> worker_;
+        TaskGroup worker_;
     };
 } // namespace db_conn
@@ -34,6 +34,7 @@ namespace frontend {
     void frontend_connection::finish() {
         if (close_callback_) {
             logger()->info("[Connection {}] FINISH: Client disconnected", connection_id_);
+            finish_impl();
             socket_.close();
             close_callback_();
             close_callback_ = nullptr;
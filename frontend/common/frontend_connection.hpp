@@ -4,12 +4,16 @@
 #pragma once
 
 #include "protocol_config.hpp"
+#include "utility/cv_wrapper.hpp"
 
 #include <actor-zeta.hpp>
 #include <atomic>
 #include <boost/asio.hpp>
+#include <chrono>
 #include <components/log/log.hpp>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <stdexcept>
@@ -51,7 +55,41 @@ namespace frontend {
             };
         }
 
+        // resumes on the connection's executor once the result is released or the timeout expires it,
+        // no io thread is blocked while the query runs
+        template<typename T, typename Callable>
+        void await_result(shared_data<T> data,
+                          Callable&& on_complete,
+                          std::chrono::milliseconds timeout = cv_wrapper::DEFAULT_TIMEOUT) {
+            auto executor = socket_.get_executor();
+            auto timer = std::make_shared<boost::asio::steady_timer>(executor, timeout);
+            auto resume = std::make_shared<std::function<void()>>(
+                [this, id = connection_id_, callback = safe_callback(std::forward<Callable>(on_complete))]() mutable {
+                    if (id != connection_id_) {
+                        return; // connection slot was reused by another client
+                    }
+                    if (!socket_.is_open()) {
+                        return; // client is gone, nothing to reply to
+                    }
+                    callback();
+                });
+
+            timer->async_wait([data, resume](boost::system::error_code ec) {
+                if (!ec && data->expire()) {
+                    (*resume)();
+                }
+            });
+            data->on_ready([executor, timer, resume]() {
+                boost::asio::post(executor, [timer, resume]() {
+                    timer->cancel();
+                    (*resume)();
+                });
+            });
+        }
+
         virtual void start_impl() = 0;
+        // releases per-connection server state, runs once before the close callback
+        virtual void finish_impl() {}
 
         virtual log_t& get_logger_impl() = 0;
         virtual uint32_t get_header_size() const = 0;
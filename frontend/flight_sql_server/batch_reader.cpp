@@ -3,124 +3,183 @@
 
 #include "batch_reader.hpp"
 
-ChunkBatchReader::ChunkBatchReader(std::shared_ptr<arrow::Schema> schema, components::vector::data_chunk_t chunk)
+#include "otterbrix/translators/output/chunk_to_arrow.hpp"
+#include "utility/worker.hpp"
+
+#include <algorithm>
+
+namespace {
+    // conversions of every open stream share these workers instead of a thread per batch
+    task_executor_t& prefetch_executor() {
+        static task_executor_t executor(std::max(2u, std::thread::hardware_concurrency() / 2));
+        return executor;
+    }
+} // namespace
+
+ChunkBatchReader::ChunkBatchReader(std::shared_ptr<arrow::Schema> schema,
+                                   components::vector::data_chunk_t chunk,
+                                   size_t batch_rows)
     : schema_ptr_{std::move(schema)}
-    , chunk_{std::move(chunk)} {}
+    , chunk_{std::move(chunk)}
+    , field_to_column_(schema_ptr_->num_fields(), -1)
+    , batch_rows_{std::max<size_t>(batch_rows, 1)} {
+    // bulk conversion reads raw buffers, so constant and dictionary vectors are expanded first
+    chunk_.flatten();
+    for (size_t i = 0; i < chunk_.column_count(); i++) {
+        auto index = schema_ptr_->GetFieldIndex(chunk_.data[i].type().alias());
+        if (index >= 0) {
+            field_to_column_[index] = static_cast<int>(i);
+        }
+    }
+}
 
 arrow::Result<std::shared_ptr<ChunkBatchReader>> ChunkBatchReader::Make(std::shared_ptr<arrow::Schema> schema,
-                                                                        components::vector::data_chunk_t chunk) {
-    return std::make_shared<ChunkBatchReader>(std::move(schema), std::move(chunk));
+                                                                        components::vector::data_chunk_t chunk,
+                                                                        size_t batch_rows) {
+    return std::make_shared<ChunkBatchReader>(std::move(schema), std::move(chunk), batch_rows);
+}
+
+ChunkBatchReader::~ChunkBatchReader() {
+    if (prefetch_.valid()) {
+        prefetch_.wait();
+    }
 }
 
 std::shared_ptr<arrow::Schema> ChunkBatchReader::schema() const { return schema_ptr_; }
 
 arrow::Status ChunkBatchReader::ReadNext(std::shared_ptr<arrow::RecordBatch>* out) {
-    if (used) {
+    if (offset_ >= chunk_.size()) {
         *out = nullptr;
         return arrow::Status::OK();
     }
-    used = true;
 
-    if (chunk_.empty()) {
-        *out = nullptr;
-        return arrow::Status::OK();
+    auto batch = prefetch_.valid() ? prefetch_.get() : ConvertBatch(offset_);
+    offset_ += batch_rows_;
+    if (offset_ < chunk_.size()) {
+        Prefetch(offset_);
     }
 
-    const auto num_fields = schema_ptr_->num_fields();
-    std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders(num_fields);
+    ARROW_ASSIGN_OR_RAISE(*out, std::move(batch));
+    return arrow::Status::OK();
+}
 
-    // Initialize builders
+void ChunkBatchReader::Prefetch(size_t offset) {
+    using batch_task_t = std::packaged_task<arrow::Result<std::shared_ptr<arrow::RecordBatch>>()>;
+    auto task = std::make_shared<batch_task_t>([this, offset] { return ConvertBatch(offset); });
+    prefetch_ = task->get_future();
+    if (!prefetch_executor().addTask([task] { (*task)(); })) {
+        // pool is stopped at shutdown, convert on the caller
+        (*task)();
+    }
+}
+
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> ChunkBatchReader::ConvertBatch(size_t offset) const {
+    const auto length = std::min(batch_rows_, chunk_.size() - offset);
+    const auto num_fields = schema_ptr_->num_fields();
+    std::vector<std::shared_ptr<arrow::Array>> columns(num_fields);
     for (int i = 0; i < num_fields; i++) {
-        ARROW_RETURN_NOT_OK(MakeBuilder(arrow::default_memory_pool(), schema_ptr_->field(i)->type(), &builders[i]));
+        ARROW_ASSIGN_OR_RAISE(columns[i], ConvertColumn(i, offset, length));
     }
+    return arrow::RecordBatch::Make(schema_ptr_, static_cast<int64_t>(length), std::move(columns));
+}
+
+arrow::Result<std::shared_ptr<arrow::Array>>
+ChunkBatchReader::ConvertColumn(int field_index, size_t offset, size_t length) const {
+    const auto& type = schema_ptr_->field(field_index)->type();
+    const auto column = field_to_column_[field_index];
+    if (column < 0) {
+        return arrow::MakeArrayOfNull(type, static_cast<int64_t>(length));
+    }
+
+    auto bulk = to_arrow_array(chunk_.data[column], type, offset, length);
+    if (bulk.ok() || !bulk.status().IsNotImplemented()) {
+        return bulk;
+    }
+    // schema type differs from the stored one, convert value by value
+    return BuildColumn(static_cast<size_t>(column), type, offset, length);
+}
+
+arrow::Result<std::shared_ptr<arrow::Array>> ChunkBatchReader::BuildColumn(size_t column,
+                                                                           const std::shared_ptr<arrow::DataType>& type,
+                                                                           size_t offset,
+                                                                           size_t length) const {
+    std::unique_ptr<arrow::ArrayBuilder> builder;
+    ARROW_RETURN_NOT_OK(MakeBuilder(arrow::default_memory_pool(), type, &builder));
+    ARROW_RETURN_NOT_OK(builder->Reserve(static_cast<int64_t>(length)));
 
     // Helper lambda to populate builder
     auto populateBuilder = [](auto* builder, const auto& value, bool is_null) -> arrow::Status {
         return is_null ? builder->AppendNull() : builder->Append(value);
     };
 
-    // Fill builders with row data
-    for (size_t i = 0; i < chunk_.column_count(); i++) {
-        // field order could be different
-        auto index = schema_ptr_->GetFieldIndex(chunk_.data[i].type().alias());
-        const auto& field = schema_ptr_->field(index);
-        const auto& field_type = field->type();
-        for (size_t j = 0; j < chunk_.size(); j++) {
-            auto value = chunk_.value(i, j);
-            bool is_null = value.is_null();
-
-            switch (field_type->id()) {
-                case arrow::Type::BOOL:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::BooleanBuilder*>(builders[index].get()),
-                                                        value.value<bool>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::INT8:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::Int8Builder*>(builders[index].get()),
-                                                        value.value<int8_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::INT16:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::Int16Builder*>(builders[index].get()),
-                                                        value.value<int16_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::INT32:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::Int32Builder*>(builders[index].get()),
-                                                        value.value<int32_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::INT64:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::Int64Builder*>(builders[index].get()),
-                                                        value.value<int64_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::UINT8:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::UInt8Builder*>(builders[index].get()),
-                                                        value.value<uint8_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::UINT16:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::UInt16Builder*>(builders[index].get()),
-                                                        value.value<uint16_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::UINT32:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::UInt32Builder*>(builders[index].get()),
-                                                        value.value<uint32_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::UINT64:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::UInt64Builder*>(builders[index].get()),
-                                                        value.value<uint64_t>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::FLOAT:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::FloatBuilder*>(builders[index].get()),
-                                                        value.value<float>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::DOUBLE:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::DoubleBuilder*>(builders[index].get()),
-                                                        value.value<double>(),
-                                                        is_null));
-                    break;
-                case arrow::Type::STRING:
-                    ARROW_RETURN_NOT_OK(populateBuilder(dynamic_cast<arrow::StringBuilder*>(builders[index].get()),
-                                                        *value.value<std::string*>(),
-                                                        is_null));
-                    break;
-                default:
-                    return arrow::Status::TypeError("Unknown builder type");
-            }
-        }
-    }
+    for (size_t j = offset; j < offset + length; j++) {
+        auto value = chunk_.value(column, j);
+        bool is_null = value.is_null();
 
-    std::vector<std::shared_ptr<arrow::Array>> columns(num_fields);
-    for (int i = 0; i < num_fields; i++) {
-        ARROW_RETURN_NOT_OK(builders[i]->Finish(&columns[i]));
+        switch (type->id()) {
+            case arrow::Type::BOOL:
+                ARROW_RETURN_NOT_OK(
+                    populateBuilder(static_cast<arrow::BooleanBuilder*>(builder.get()), value.value<bool>(), is_null));
+                break;
+            case arrow::Type::INT8:
+                ARROW_RETURN_NOT_OK(
+                    populateBuilder(static_cast<arrow::Int8Builder*>(builder.get()), value.value<int8_t>(), is_null));
+                break;
+            case arrow::Type::INT16:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::Int16Builder*>(builder.get()),
+                                                    value.value<int16_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::INT32:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::Int32Builder*>(builder.get()),
+                                                    value.value<int32_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::INT64:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::Int64Builder*>(builder.get()),
+                                                    value.value<int64_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::UINT8:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::UInt8Builder*>(builder.get()),
+                                                    value.value<uint8_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::UINT16:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::UInt16Builder*>(builder.get()),
+                                                    value.value<uint16_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::UINT32:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::UInt32Builder*>(builder.get()),
+                                                    value.value<uint32_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::UINT64:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::UInt64Builder*>(builder.get()),
+                                                    value.value<uint64_t>(),
+                                                    is_null));
+                break;
+            case arrow::Type::FLOAT:
+                ARROW_RETURN_NOT_OK(
+                    populateBuilder(static_cast<arrow::FloatBuilder*>(builder.get()), value.value<float>(), is_null));
+                break;
+            case arrow::Type::DOUBLE:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::DoubleBuilder*>(builder.get()),
+                                                    value.value<double>(),
+                                                    is_null));
+                break;
+            case arrow::Type::STRING:
+                ARROW_RETURN_NOT_OK(populateBuilder(static_cast<arrow::StringBuilder*>(builder.get()),
+                                                    *value.value<std::string*>(),
+                                                    is_null));
+                break;
+            default:
+                return arrow::Status::TypeError("Unknown builder type");
+        }
     }
 
-    *out = arrow::RecordBatch::Make(schema_ptr_, chunk_.size(), columns);
-    return arrow::Status::OK();
+    std::shared_ptr<arrow::Array> array;
+    ARROW_RETURN_NOT_OK(builder->Finish(&array));
+    return array;
 }
@@ -12,21 +12,42 @@
 
 #include <otterbrix/otterbrix.hpp>
 
+#include <future>
 #include <memory_resource>
+#include <vector>
 
+// record batches are sliced from the chunk, the next slice is converted on a bounded pool while the current one is sent
 class ChunkBatchReader : public arrow::RecordBatchReader {
 public:
-    ChunkBatchReader(std::shared_ptr<arrow::Schema> schema, components::vector::data_chunk_t chunk);
+    static constexpr size_t DEFAULT_BATCH_ROWS = 64 * 1024;
+
+    ChunkBatchReader(std::shared_ptr<arrow::Schema> schema,
+                     components::vector::data_chunk_t chunk,
+                     size_t batch_rows = DEFAULT_BATCH_ROWS);
 
     static arrow::Result<std::shared_ptr<ChunkBatchReader>> Make(std::shared_ptr<arrow::Schema> schema,
-                                                                 components::vector::data_chunk_t chunk);
+                                                                 components::vector::data_chunk_t chunk,
+                                                                 size_t batch_rows = DEFAULT_BATCH_ROWS);
+
+    ~ChunkBatchReader() override;
 
     std::shared_ptr<arrow::Schema> schema() const override;
 
     arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* out) override;
 
 private:
+    void Prefetch(size_t offset);
+    arrow::Result<std::shared_ptr<arrow::RecordBatch>> ConvertBatch(size_t offset) const;
+    arrow::Result<std::shared_ptr<arrow::Array>> ConvertColumn(int field_index, size_t offset, size_t length) const;
+    arrow::Result<std::shared_ptr<arrow::Array>>
+    BuildColumn(size_t column, const std::shared_ptr<arrow::DataType>& type, size_t offset, size_t length) const;
+
     std::shared_ptr<arrow::Schema> schema_ptr_;
     components::vector::data_chunk_t chunk_;
-    bool used{false};
-};
\ No newline at end of file
+    // chunk column for each schema field, field order could be different
+    std::vector<int> field_to_column_;
+    size_t batch_rows_;
+    size_t offset_{0};
+    // waited in the destructor, a queued conversion still reads chunk_
+    std::future<arrow::Result<std::shared_ptr<arrow::RecordBatch>>> prefetch_;
+};
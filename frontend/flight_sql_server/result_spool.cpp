@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "result_spool.hpp"
+#include "batch_reader.hpp"
+
+#include "arrow/util/byte_size.h"
+
+#include <algorithm>
+
+ResultSpool::ResultSpool(std::chrono::milliseconds ttl, int64_t max_bytes)
+    : ttl_(ttl)
+    , max_bytes_(max_bytes)
+    , sweeper_([this](std::stop_token stop) { Sweep(std::move(stop)); }) {}
+
+arrow::Result<ResultSpool::spooled_result_ptr>
+ResultSpool::Make(std::shared_ptr<arrow::Schema> schema, components::vector::data_chunk_t chunk, size_t batch_rows) {
+    auto result = std::make_shared<spooled_result_t>();
+    result->schema = schema;
+    ARROW_ASSIGN_OR_RAISE(auto reader, ChunkBatchReader::Make(std::move(schema), std::move(chunk), batch_rows));
+    for (;;) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_RETURN_NOT_OK(reader->ReadNext(&batch));
+        if (!batch) {
+            break;
+        }
+        result->total_records += batch->num_rows();
+        result->total_bytes += arrow::util::TotalBufferSize(*batch);
+        result->batches.push_back(std::move(batch));
+    }
+    return result;
+}
+
+void ResultSpool::spooled_result_t::Split(size_t max_parts) {
+    const size_t parts = std::max<size_t>(std::min(max_parts, batches.size()), 1);
+    part_begin.resize(parts);
+    for (size_t i = 0; i < parts; ++i) {
+        part_begin[i] = i * batches.size() / parts;
+    }
+}
+
+bool ResultSpool::Put(session_hash_t id, spooled_result_ptr result) {
+    std::lock_guard lock(mtx_);
+    const auto now = clock::now();
+    EvictExpired(now);
+    if (auto it = results_.find(id); it != results_.end()) {
+        bytes_ -= it->second.bytes;
+        results_.erase(it);
+    }
+    if (result->total_bytes > max_bytes_ - bytes_) {
+        return false;
+    }
+
+    const size_t parts = result->parts();
+    const int64_t bytes = result->total_bytes;
+    results_[id] = entry_t{std::move(result), now + ttl_, std::vector<bool>(parts, false), parts, bytes};
+    bytes_ += bytes;
+    return true;
+}
+
+std::optional<ResultSpool::spooled_part_t> ResultSpool::Take(session_hash_t id, size_t part) {
+    std::lock_guard lock(mtx_);
+    const auto now = clock::now();
+    EvictExpired(now);
+    auto it = results_.find(id);
+    if (it == results_.end() || part >= it->second.taken.size() || it->second.taken[part]) {
+        return std::nullopt;
+    }
+
+    auto& entry = it->second;
+    auto& result = *entry.result;
+    const size_t begin = result.part_begin[part];
+    const size_t end = part + 1 < result.parts() ? result.part_begin[part + 1] : result.batches.size();
+    spooled_part_t spooled{result.schema, {}};
+    spooled.batches.reserve(end - begin);
+    int64_t bytes = 0;
+    for (size_t i = begin; i < end; ++i) {
+        bytes += arrow::util::TotalBufferSize(*result.batches[i]);
+        spooled.batches.push_back(std::move(result.batches[i]));
+    }
+
+    entry.taken[part] = true;
+    entry.bytes -= bytes;
+    bytes_ -= bytes;
+    if (--entry.remaining == 0) {
+        bytes_ -= entry.bytes;
+        results_.erase(it);
+    } else {
+        // the other endpoints are still being fetched, their time runs from the last fetch
+        entry.expires = now + ttl_;
+    }
+    return spooled;
+}
+
+int64_t ResultSpool::bytes() {
+    std::lock_guard lock(mtx_);
+    return bytes_;
+}
+
+void ResultSpool::EvictExpired(clock::time_point now) {
+    std::erase_if(results_, [this, now](const auto& entry) {
+        if (entry.second.expires > now) {
+            return false;
+        }
+        bytes_ -= entry.second.bytes;
+        return true;
+    });
+}
+
+void ResultSpool::Sweep(std::stop_token stop) {
+    std::unique_lock lock(mtx_);
+    while (!stop.stop_requested()) {
+        // woken early only to stop
+        sweep_cv_.wait_for(lock, stop, ttl_, [] { return false; });
+        EvictExpired(clock::now());
+    }
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include "arrow/api.h"
+
+#include "../../utility/session.hpp"
+
+#include <otterbrix/otterbrix.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// results executed by GetFlightInfoStatement, kept as record batches until DoGetStatement of their ticket
+// takes them or their time to live runs out. expired results are swept every ttl even if nobody asks for them
+class ResultSpool {
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct spooled_result_t {
+        std::shared_ptr<arrow::Schema> schema;
+        std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+        int64_t total_records = 0;
+        int64_t total_bytes = 0;
+        // first batch of every endpoint's range, a single range until Split()
+        std::vector<size_t> part_begin{0};
+
+        size_t parts() const noexcept { return part_begin.size(); }
+        // contiguous ranges of whole batches, so there are never more ranges than batches
+        void Split(size_t max_parts);
+    };
+    using spooled_result_ptr = std::shared_ptr<spooled_result_t>;
+
+    // batches of one endpoint's range
+    struct spooled_part_t {
+        std::shared_ptr<arrow::Schema> schema;
+        std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    };
+
+    // max_bytes bounds the batches held by all results together
+    ResultSpool(std::chrono::milliseconds ttl, int64_t max_bytes);
+    ResultSpool(const ResultSpool&) = delete;
+    ResultSpool& operator=(const ResultSpool&) = delete;
+
+    // converts the whole chunk up front, so the totals are exact
+    static arrow::Result<spooled_result_ptr>
+    Make(std::shared_ptr<arrow::Schema> schema, components::vector::data_chunk_t chunk, size_t batch_rows);
+
+    // false if the result doesn't fit next to the ones already held, it is not spooled then
+    bool Put(session_hash_t id, spooled_result_ptr result);
+    // every range is streamed once and the result is dropped after its last one, taking a range renews
+    // the time to live of the others. nullopt if there is no such range or the result expired
+    std::optional<spooled_part_t> Take(session_hash_t id, size_t part);
+    // batches held by all results, not taken yet
+    int64_t bytes();
+
+private:
+    struct entry_t {
+        spooled_result_ptr result;
+        clock::time_point expires;
+        std::vector<bool> taken;
+        size_t remaining = 0;
+        // batches not taken yet
+        int64_t bytes = 0;
+    };
+
+    // called under mtx_
+    void EvictExpired(clock::time_point now);
+    void Sweep(std::stop_token stop);
+
+    const std::chrono::milliseconds ttl_;
+    const int64_t max_bytes_;
+    std::mutex mtx_;
+    std::condition_variable_any sweep_cv_;
+    std::unordered_map<session_hash_t, entry_t> results_;
+    int64_t bytes_ = 0;
+    // last member, stopped and joined before the state it sweeps is destroyed
+    std::jthread sweeper_;
+};
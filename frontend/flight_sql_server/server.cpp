@@ -5,6 +5,7 @@
 #include "batch_reader.hpp"
 
 #include "otterbrix/operators/execute_plan.hpp"
+#include "otterbrix/translators/input/arrow_to_value.hpp"
 #include "otterbrix/translators/input/mysql_to_chunk.hpp"
 #include "otterbrix/translators/output/chunk_to_arrow.hpp"
 #include "utility/connection_uid.hpp"
@@ -20,16 +21,19 @@
 #include <boost/mysql/results.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <chrono>
 #include <components/logical_plan/node_data.hpp>
 #include <components/logical_plan/node_function.hpp>
 #include <components/sql/transformer/utils.hpp>
 #include <deque>
+#include <iterator>
 #include <thread>
 
 #include "arrow/flight/server.h"
 #include "arrow/flight/server_auth.h"
 #include "arrow/status.h"
+#include "arrow/util/iterator.h"
 
 #include "../../otterbrix/query_generation/sql_query_generator.hpp"
 
@@ -57,52 +61,18 @@ struct QueryHandleWaiter {
     }
 };
 
-// Create a Ticket that combines a SQL query, transaction ID, and session hash.
-arrow::Result<arrow::flight::Ticket> EncodeTransactionQuery(TicketData data) {
-    std::string transaction_query = data.sql_query;
-    transaction_query += ':';
-    transaction_query += data.transaction_id;
-    transaction_query += ':';
-    transaction_query += std::to_string(data.session_hash);
-    auto ticket_string = arrow::flight::sql::CreateStatementQueryTicket(transaction_query).ValueOrDie();
-    return arrow::flight::Ticket{std::move(ticket_string)};
-}
-
-// Decode input ticket to query, transaction ID, and session hash
-arrow::Result<TicketData> DecodeTransactionQuery(const std::string& ticket) {
-    // Decode ticket
-
-    // SQL & transaction_id
-    auto first_divider = ticket.find(':');
-    if (first_divider == std::string::npos) {
-        return arrow::Status::Invalid("Malformed ticket: missing first divider");
-    }
-
-    // transaction_id & session_hash
-    auto second_divider = ticket.find(':', first_divider + 1);
-    if (second_divider == std::string::npos) {
-        return arrow::Status::Invalid("Malformed ticket: missing second divider");
-    }
-
-    std::string sql_query = ticket.substr(0, first_divider);
-    std::string transaction_id = ticket.substr(first_divider + 1, second_divider - first_divider - 1);
-    std::string session_str = ticket.substr(second_divider + 1);
-
-    try {
-        size_t session_hash = std::stoul(session_str);
-        return TicketData(std::move(sql_query), std::move(transaction_id), session_hash);
-    } catch (const std::exception& e) {
-        return arrow::Status::Invalid("Failed to extract session hash from string: " + session_str +
-                                      " error: " + e.what());
-    }
-}
-
 SimpleFlightSQLServer::SimpleFlightSQLServer(const Config& config)
     : log_(get_logger(logger_tag::FLIGHTSQL_SERVER))
     , location_(arrow::flight::Location::ForGrpcTcp(config.host, config.port).ValueOrDie())
     , resource_(config.resource)
     , catalog_address_(config.catalog_address)
-    , scheduler_address_(config.scheduler_address) {
+    , scheduler_address_(config.scheduler_address)
+    , batch_rows_(config.batch_rows)
+    , max_endpoints_(std::max<size_t>(config.max_endpoints, 1))
+    , prepared_ttl_(config.prepared_ttl)
+    , max_prepared_statements_(std::max<size_t>(config.max_prepared_statements, 1))
+    , spool_(config.spool_results ? std::make_unique<ResultSpool>(config.spool_ttl, config.spool_max_bytes)
+                                  : nullptr) {
     assert(log_.is_valid());
 }
 
@@ -115,26 +85,55 @@ SimpleFlightSQLServer::GetFlightInfoStatement(const arrow::flight::ServerCallCon
     session_id id;
     const std::string& query = command.query;
     log_->debug("Received query in ticket: {}", query);
-    auto ticket = EncodeTransactionQuery({query, command.transaction_id, id.hash()}).ValueOrDie();
-    log_->trace("ticket: {}", ticket.ToString());
+    ARROW_ASSIGN_OR_RAISE(auto shared_data, DescribeStatement(id.hash(), query));
+
+    std::shared_ptr<arrow::Schema> schema = to_arrow_schema(shared_data->result.schema);
+    int64_t total_records = -1;
+    int64_t total_bytes = -1;
+    size_t parts = 1;
+    bool spooled = false;
+    if (spool_) {
+        ARROW_ASSIGN_OR_RAISE(auto result, ExecuteToSpool(id.hash(), query, schema));
+        if (result) {
+            total_records = result->total_records;
+            total_bytes = result->total_bytes;
+            parts = result->parts();
+            spooled = true;
+        } else {
+            // the execution consumed the plan, DoGet runs the statement described again
+            ARROW_RETURN_NOT_OK(DescribeStatement(id.hash(), query));
+        }
+    }
+
+    std::vector<arrow::flight::FlightEndpoint> endpoints;
+    endpoints.reserve(parts);
+    for (size_t part = 0; part < parts; ++part) {
+        auto ticket =
+            EncodeTransactionQuery({query, command.transaction_id, id.hash(), part, spooled}).ValueOrDie();
+        log_->trace("ticket: {}", ticket.ToString());
+        endpoints.push_back(arrow::flight::FlightEndpoint{std::move(ticket), {}, std::nullopt, ""});
+    }
 
+    // endpoints hold consecutive ranges of the result, concatenated in order they keep ORDER BY
+    const bool ordered = parts > 1;
+    auto result = arrow::flight::FlightInfo::Make(*schema, descriptor, endpoints, total_records, total_bytes, ordered)
+                      .ValueOrDie();
+    return std::make_unique<arrow::flight::FlightInfo>(result);
+}
+
+arrow::Result<shared_flight_data> SimpleFlightSQLServer::DescribeStatement(session_hash_t id,
+                                                                           const std::string& query) {
     auto shared_data = create_cv_wrapper(flight_data(resource_));
     actor_zeta::send(scheduler_address_,
                      scheduler_address_,
                      scheduler::handler_id(scheduler::route::prepare_schema),
-                     id.hash(),
+                     id,
                      shared_data,
                      query);
     shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
 
     if (shared_data->status() == cv_wrapper::Status::Ok) {
-        std::shared_ptr<arrow::Schema> schema = to_arrow_schema(shared_data->result.schema);
-        std::vector<arrow::flight::FlightEndpoint> endpoints{
-            arrow::flight::FlightEndpoint{std::move(ticket), {}, std::nullopt, ""}};
-
-        const bool ordered = false;
-        auto result = arrow::flight::FlightInfo::Make(*schema, descriptor, endpoints, -1, -1, ordered).ValueOrDie();
-        return std::make_unique<arrow::flight::FlightInfo>(result);
+        return shared_data;
     } else if (shared_data->status() == cv_wrapper::Status::Timeout) {
         log_->warn("Timeout while preparing query: {}", query);
         return arrow::Status::Invalid("Timeout while preparing query: " + query);
@@ -152,14 +151,28 @@ SimpleFlightSQLServer::DoGetStatement(const arrow::flight::ServerCallContext& co
     // log_->trace("[DOGET] Thread id: {}", std::this_thread::get_id()); // fmt doesn't format thread::id
 
     try {
-        const auto& [query, transaction_id, session_hash] =
+        const auto& [query, transaction_id, session_hash, endpoint, spooled] =
             DecodeTransactionQuery(command.statement_handle).ValueOrDie();
 
         // Log the received ticket, assuming the query is stored in the ticket
-        log_->debug("Received query in ticket: {} Session hash: {} Transaction ID: {}",
+        log_->debug("Received query in ticket: {} Session hash: {} Transaction ID: {} Endpoint: {}",
                     query,
                     session_hash,
-                    transaction_id);
+                    transaction_id,
+                    endpoint);
+        if (spooled) {
+            // the statement already ran, its plan is gone and it can't be executed again
+            auto part = spool_ ? spool_->Take(session_hash, endpoint) : std::nullopt;
+            if (!part) {
+                log_->warn("[DOGET] Spooled endpoint {} of session {} is gone", endpoint, session_hash);
+                return arrow::Status::Invalid("Result of endpoint " + std::to_string(endpoint) +
+                                              " expired or was already fetched");
+            }
+            log_->debug("[DOGET] Streaming spooled endpoint {}, batches: {}", endpoint, part->batches.size());
+            ARROW_ASSIGN_OR_RAISE(auto reader, arrow::RecordBatchReader::Make(std::move(part->batches), part->schema));
+            return std::make_unique<arrow::flight::RecordBatchStream>(reader);
+        }
+
         auto shared_data = create_cv_wrapper(flight_data(resource_));
         actor_zeta::send(scheduler_address_,
                          scheduler_address_,
@@ -174,7 +187,7 @@ SimpleFlightSQLServer::DoGetStatement(const arrow::flight::ServerCallContext& co
             timer.timePoint("[DOGET] Scheduler finished successfully");
 
             auto schema = to_arrow_schema(shared_data->result.schema);
-            auto batch_reader = ChunkBatchReader::Make(std::move(schema), std::move(chunk_res)).ValueOrDie();
+            auto batch_reader = ChunkBatchReader::Make(std::move(schema), std::move(chunk_res), batch_rows_).ValueOrDie();
             // Use a record batch stream
             log_->trace("[ARROW FLIGHT SERVER] Send data");
             timer.timePoint("[DOGET] datastream created");
@@ -201,6 +214,50 @@ SimpleFlightSQLServer::DoGetStatement(const arrow::flight::ServerCallContext& co
     }
 }
 
+arrow::Result<ResultSpool::spooled_result_ptr>
+SimpleFlightSQLServer::ExecuteToSpool(session_hash_t id,
+                                      const std::string& query,
+                                      std::shared_ptr<arrow::Schema> schema) {
+    Timer timer("ExecuteToSpool");
+    auto shared_data = create_cv_wrapper(flight_data(resource_));
+    actor_zeta::send(scheduler_address_,
+                     scheduler_address_,
+                     scheduler::handler_id(scheduler::route::execute_statement),
+                     id,
+                     shared_data);
+    shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
+
+    ResultSpool::spooled_result_ptr spooled;
+    if (shared_data->status() == cv_wrapper::Status::Ok) {
+        ARROW_ASSIGN_OR_RAISE(spooled,
+                              ResultSpool::Make(to_arrow_schema(shared_data->result.schema),
+                                                std::move(shared_data->result.chunk),
+                                                batch_rows_));
+    } else if (shared_data->status() == cv_wrapper::Status::Empty) {
+        spooled = std::make_shared<ResultSpool::spooled_result_t>();
+        spooled->schema = std::move(schema);
+    } else if (shared_data->status() == cv_wrapper::Status::Timeout) {
+        log_->warn("Timeout while executing query: {}", query);
+        return arrow::Status::Invalid("Timeout while executing query: " + query);
+    } else {
+        log_->error("Error while executing GetFlightInfoStatement: {}", shared_data->error_message());
+        return arrow::Status::Invalid("Error while executing GetFlightInfoStatement: " +
+                                      shared_data->error_message());
+    }
+
+    spooled->Split(max_endpoints_);
+    if (!spool_->Put(id, spooled)) {
+        log_->debug("Result of session {} is too large to be spooled: {} bytes", id, spooled->total_bytes);
+        return nullptr;
+    }
+    log_->debug("Spooled {} rows, {} bytes in {} parts for session {}",
+                spooled->total_records,
+                spooled->total_bytes,
+                spooled->parts(),
+                id);
+    return spooled;
+}
+
 arrow::Result<std::unique_ptr<arrow::flight::FlightInfo>>
 SimpleFlightSQLServer::GetFlightInfoTables(const arrow::flight::ServerCallContext& context,
                                            const arrow::flight::sql::GetTables& command,
@@ -337,6 +394,281 @@ SimpleFlightSQLServer::DoPutCommandStatementUpdate(const arrow::flight::ServerCa
     }
 }
 
+arrow::Result<arrow::flight::sql::ActionCreatePreparedStatementResult>
+SimpleFlightSQLServer::CreatePreparedStatement(
+    const arrow::flight::ServerCallContext& context,
+    const arrow::flight::sql::ActionCreatePreparedStatementRequest& request) {
+    Timer timer("CreatePreparedStatement");
+    session_id id;
+    log_->debug("Preparing query: {} Id: {}", request.query, request.transaction_id);
+
+    auto shared_data = create_cv_wrapper(flight_data(resource_));
+    actor_zeta::send(scheduler_address_,
+                     scheduler_address_,
+                     scheduler::handler_id(scheduler::route::prepare_schema),
+                     id.hash(),
+                     shared_data,
+                     request.query);
+    shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
+
+    if (shared_data->status() == cv_wrapper::Status::Timeout) {
+        log_->warn("Timeout while preparing query: {}", request.query);
+        return arrow::Status::Invalid("Timeout while preparing query: " + request.query);
+    } else if (shared_data->status() != cv_wrapper::Status::Ok &&
+               shared_data->status() != cv_wrapper::Status::Empty) {
+        log_->error("Error while CreatePreparedStatement: {}", shared_data->error_message());
+        return arrow::Status::Invalid("Error while CreatePreparedStatement: " + shared_data->error_message());
+    }
+
+    auto statement = std::make_shared<prepared_statement_t>();
+    statement->session_hash = id.hash();
+    statement->query = request.query;
+    statement->dataset_schema = shared_data->status() == cv_wrapper::Status::Ok
+                                    ? to_arrow_schema(shared_data->result.schema)
+                                    : arrow::schema({});
+    statement->parameter_count = shared_data->result.parameter_count;
+
+    // types the scheduler told from the columns the parameters are compared with, the rest are null and take
+    // whatever the client binds
+    std::pmr::vector<components::types::complex_logical_type> parameter_types(resource_);
+    parameter_types.reserve(statement->parameter_count);
+    for (size_t i = 0; i < statement->parameter_count; ++i) {
+        const auto& known = shared_data->result.parameter_types;
+        parameter_types.emplace_back(i < known.size() ? known[i].type() : components::types::logical_type::NA);
+        parameter_types.back().set_alias("$" + std::to_string(i + 1));
+    }
+
+    auto handle = std::to_string(id.hash());
+    arrow::flight::sql::ActionCreatePreparedStatementResult result{statement->dataset_schema,
+                                                                   to_arrow_schema(parameter_types),
+                                                                   handle};
+    {
+        std::lock_guard lock(prepared_mtx_);
+        statement->last_used = std::chrono::steady_clock::now();
+        EvictPreparedStatements(statement->last_used);
+        prepared_statements_.emplace(std::move(handle), std::move(statement));
+    }
+    log_->debug("Prepared statement {} with {} parameters",
+                result.prepared_statement_handle,
+                shared_data->result.parameter_count);
+    return result;
+}
+
+arrow::Status
+SimpleFlightSQLServer::ClosePreparedStatement(const arrow::flight::ServerCallContext& context,
+                                              const arrow::flight::sql::ActionClosePreparedStatementRequest& request) {
+    Timer timer("ClosePreparedStatement");
+    prepared_statement_ptr statement;
+    {
+        std::lock_guard lock(prepared_mtx_);
+        auto it = prepared_statements_.find(request.prepared_statement_handle);
+        if (it == prepared_statements_.end()) {
+            return arrow::Status::KeyError("Unknown prepared statement: " + request.prepared_statement_handle);
+        }
+        statement = std::move(it->second);
+        prepared_statements_.erase(it);
+    }
+
+    // drops the plan kept by the scheduler for re-execution
+    actor_zeta::send(scheduler_address_,
+                     scheduler_address_,
+                     scheduler::handler_id(scheduler::route::close_statement),
+                     statement->session_hash);
+    return arrow::Status::OK();
+}
+
+arrow::Result<std::string>
+SimpleFlightSQLServer::DoPutPreparedStatementQuery(const arrow::flight::ServerCallContext& context,
+                                                   const arrow::flight::sql::PreparedStatementQuery& command,
+                                                   arrow::flight::FlightMessageReader* reader,
+                                                   arrow::flight::FlightMetadataWriter* writer) {
+    Timer timer("DoPutPreparedStatementQuery");
+    ARROW_ASSIGN_OR_RAISE(auto statement, FindPreparedStatement(command.prepared_statement_handle));
+    ARROW_ASSIGN_OR_RAISE(auto batches, reader->ToRecordBatches());
+
+    std::vector<std::pmr::vector<components::types::logical_value_t>> parameter_sets;
+    for (const auto& batch : batches) {
+        if (static_cast<size_t>(batch->num_columns()) != statement->parameter_count) {
+            return arrow::Status::Invalid("Prepared statement expects " + std::to_string(statement->parameter_count) +
+                                          " parameters, got " + std::to_string(batch->num_columns()));
+        }
+        ARROW_ASSIGN_OR_RAISE(auto sets, tsl::arrow_to_parameter_sets(resource_, *batch));
+        std::move(sets.begin(), sets.end(), std::back_inserter(parameter_sets));
+    }
+    log_->debug("Bound {} parameter sets to prepared statement {}",
+                parameter_sets.size(),
+                command.prepared_statement_handle);
+
+    std::lock_guard lock(statement->execution_mtx);
+    statement->parameter_sets = std::move(parameter_sets);
+    return command.prepared_statement_handle;
+}
+
+arrow::Result<std::unique_ptr<arrow::flight::FlightInfo>>
+SimpleFlightSQLServer::GetFlightInfoPreparedStatement(const arrow::flight::ServerCallContext& context,
+                                                      const arrow::flight::sql::PreparedStatementQuery& command,
+                                                      const arrow::flight::FlightDescriptor& descriptor) {
+    Timer timer("GetFlightInfoPreparedStatement");
+    ARROW_ASSIGN_OR_RAISE(auto statement, FindPreparedStatement(command.prepared_statement_handle));
+    std::vector<arrow::flight::FlightEndpoint> endpoints{{arrow::flight::Ticket{descriptor.cmd}, {}, std::nullopt, ""}};
+    ARROW_ASSIGN_OR_RAISE(
+        auto result,
+        arrow::flight::FlightInfo::Make(*statement->dataset_schema, descriptor, endpoints, -1, -1, false))
+    return std::make_unique<arrow::flight::FlightInfo>(std::move(result));
+}
+
+arrow::Result<std::unique_ptr<arrow::flight::FlightDataStream>>
+SimpleFlightSQLServer::DoGetPreparedStatement(const arrow::flight::ServerCallContext& context,
+                                              const arrow::flight::sql::PreparedStatementQuery& command) {
+    Timer timer("DoGetPreparedStatement");
+    try {
+        ARROW_ASSIGN_OR_RAISE(auto statement, FindPreparedStatement(command.prepared_statement_handle));
+        std::unique_lock lock(statement->execution_mtx);
+        if (statement->parameter_count && statement->parameter_sets.empty()) {
+            return arrow::Status::Invalid("Prepared statement has " + std::to_string(statement->parameter_count) +
+                                          " unbound parameters");
+        }
+
+        // every parameter set runs the kept plan again, results follow each other in binding order. an execution
+        // starts once the client has read the one before it and gets its own timeout. the statement stays locked
+        // until the stream is done with it, binding again waits for that
+        struct stream_state_t {
+            std::unique_lock<std::mutex> lock;
+            prepared_statement_ptr statement;
+            size_t executions = 0;
+            size_t next = 0;
+            std::shared_ptr<ChunkBatchReader> reader;
+        };
+        auto state = std::make_shared<stream_state_t>();
+        state->lock = std::move(lock);
+        state->statement = statement;
+        state->executions = std::max<size_t>(statement->parameter_sets.size(), 1);
+
+        // runs executions up to the next one that returned rows, the reader is null once all of them are done
+        auto advance = [this](stream_state_t& stream) -> arrow::Status {
+            stream.reader = nullptr;
+            while (!stream.reader && stream.next < stream.executions) {
+                const auto& parameter_sets = stream.statement->parameter_sets;
+                std::pmr::vector<components::types::logical_value_t> parameters(resource_);
+                if (stream.next < parameter_sets.size()) {
+                    parameters = parameter_sets[stream.next];
+                }
+                ++stream.next;
+                ARROW_ASSIGN_OR_RAISE(stream.reader,
+                                      ExecutePreparedStatement(stream.statement->session_hash,
+                                                               std::move(parameters),
+                                                               cv_wrapper::DEFAULT_TIMEOUT));
+            }
+            return arrow::Status::OK();
+        };
+
+        // the first result is waited for here, so its error reaches the client as the status of the call
+        ARROW_RETURN_NOT_OK(advance(*state));
+        timer.timePoint("[DoGetPreparedStatement] first execution finished");
+        auto schema = state->reader ? state->reader->schema() : statement->dataset_schema;
+
+        auto batches = arrow::MakeFunctionIterator(
+            [this, state, advance]() -> arrow::Result<std::shared_ptr<arrow::RecordBatch>> {
+                try {
+                    while (state->reader) {
+                        std::shared_ptr<arrow::RecordBatch> batch;
+                        ARROW_RETURN_NOT_OK(state->reader->ReadNext(&batch));
+                        if (batch) {
+                            return batch;
+                        }
+                        ARROW_RETURN_NOT_OK(advance(*state));
+                    }
+                } catch (const std::exception& e) {
+                    log_->error("Error while streaming prepared statement: {}", e.what());
+                    return arrow::Status::Invalid("Error while streaming prepared statement: " +
+                                                  std::string(e.what()));
+                }
+                log_->debug("[DoGetPreparedStatement] {} executions streamed", state->executions);
+                if (state->lock.owns_lock()) {
+                    state->lock.unlock();
+                }
+                return arrow::IterationEnd<std::shared_ptr<arrow::RecordBatch>>();
+            });
+        ARROW_ASSIGN_OR_RAISE(auto reader,
+                              arrow::RecordBatchReader::MakeFromIterator(std::move(batches), std::move(schema)));
+        return std::make_unique<arrow::flight::RecordBatchStream>(reader);
+    } catch (const std::exception& e) {
+        log_->error("Error: {}", e.what());
+        return arrow::Status::Invalid("Error: " + std::string(e.what()));
+    } catch (...) {
+        log_->error("Error: unknown");
+        return arrow::Status::Invalid("Error while DoGetPreparedStatement: unknown");
+    }
+}
+
+arrow::Result<SimpleFlightSQLServer::prepared_statement_ptr>
+SimpleFlightSQLServer::FindPreparedStatement(const std::string& handle) {
+    std::lock_guard lock(prepared_mtx_);
+    auto it = prepared_statements_.find(handle);
+    if (it == prepared_statements_.end()) {
+        return arrow::Status::KeyError("Unknown prepared statement: " + handle);
+    }
+    it->second->last_used = std::chrono::steady_clock::now();
+    return it->second;
+}
+
+void SimpleFlightSQLServer::EvictPreparedStatements(std::chrono::steady_clock::time_point now) {
+    std::vector<session_hash_t> closed;
+    std::erase_if(prepared_statements_, [&](const auto& entry) {
+        if (now - entry.second->last_used < prepared_ttl_) {
+            return false;
+        }
+        closed.push_back(entry.second->session_hash);
+        return true;
+    });
+    while (prepared_statements_.size() >= max_prepared_statements_) {
+        auto oldest = std::min_element(prepared_statements_.begin(),
+                                       prepared_statements_.end(),
+                                       [](const auto& lhs, const auto& rhs) {
+                                           return lhs.second->last_used < rhs.second->last_used;
+                                       });
+        closed.push_back(oldest->second->session_hash);
+        prepared_statements_.erase(oldest);
+    }
+
+    // a running execution keeps its statement, the scheduler drops the plan once it completes
+    for (auto session_hash : closed) {
+        log_->debug("Closing unused prepared statement {}", session_hash);
+        actor_zeta::send(scheduler_address_,
+                         scheduler_address_,
+                         scheduler::handler_id(scheduler::route::close_statement),
+                         session_hash);
+    }
+}
+
+arrow::Result<std::shared_ptr<ChunkBatchReader>>
+SimpleFlightSQLServer::ExecutePreparedStatement(session_hash_t id,
+                                                std::pmr::vector<components::types::logical_value_t> parameters,
+                                                std::chrono::milliseconds timeout) {
+    auto shared_data = create_cv_wrapper(flight_data(resource_));
+    actor_zeta::send(scheduler_address_,
+                     scheduler_address_,
+                     scheduler::handler_id(scheduler::route::execute_prepared_statement),
+                     id,
+                     std::move(parameters),
+                     shared_data);
+    shared_data->wait_for(timeout);
+
+    if (shared_data->status() == cv_wrapper::Status::Ok) {
+        return ChunkBatchReader::Make(to_arrow_schema(shared_data->result.schema),
+                                      std::move(shared_data->result.chunk),
+                                      batch_rows_);
+    } else if (shared_data->status() == cv_wrapper::Status::Empty) {
+        return nullptr;
+    } else if (shared_data->status() == cv_wrapper::Status::Timeout) {
+        log_->warn("Timeout while executing prepared statement: {}", id);
+        return arrow::Status::Invalid("Timeout while executing prepared statement");
+    } else {
+        log_->error("Error while executing prepared statement: {}", shared_data->error_message());
+        return arrow::Status::Invalid("Error while executing prepared statement: " + shared_data->error_message());
+    }
+}
+
 // Start the Flight SQL server
 arrow::Status SimpleFlightSQLServer::Start() {
     arrow::flight::FlightServerOptions options(location_);
@@ -14,6 +14,9 @@
 #include "../../scheduler/scheduler.hpp"
 #include "../../utility/shared_flight_data.hpp"
 #include "../../utility/table_info.hpp"
+#include "batch_reader.hpp"
+#include "result_spool.hpp"
+#include "ticket.hpp"
 
 #include <boost/mysql/results.hpp>
 #include <components/log/log.hpp>
@@ -26,8 +29,13 @@
 #include <actor-zeta.hpp>
 #include <otterbrix/otterbrix.hpp>
 
+#include <chrono>
+#include <memory>
 #include <memory_resource>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct Config {
     std::string host;
@@ -35,12 +43,18 @@ struct Config {
     std::pmr::memory_resource* resource{nullptr};
     actor_zeta::address_t catalog_address;
     actor_zeta::address_t scheduler_address;
-};
-
-struct TicketData {
-    std::string sql_query;
-    std::string transaction_id;
-    session_hash_t session_hash;
+    size_t batch_rows = ChunkBatchReader::DEFAULT_BATCH_ROWS;
+    // GetFlightInfoStatement executes the query and DoGetStatement streams the spooled result
+    bool spool_results = false;
+    std::chrono::milliseconds spool_ttl = std::chrono::seconds(60);
+    // results that don't fit are not spooled, DoGetStatement executes them as without spooling
+    int64_t spool_max_bytes = int64_t{1} << 30;
+    // a spooled result is split into up to this many endpoints, clients may DoGet them in parallel
+    size_t max_endpoints = 1;
+    // prepared statements the client never closed are closed once idle for prepared_ttl, or least recently
+    // used first once there are max_prepared_statements of them
+    std::chrono::milliseconds prepared_ttl = std::chrono::minutes(30);
+    size_t max_prepared_statements = 1024;
 };
 
 class SimpleFlightSQLServer : public arrow::flight::sql::FlightSqlServerBase {
@@ -61,12 +75,70 @@ public:
     DoGetTables(const arrow::flight::ServerCallContext& context, const arrow::flight::sql::GetTables& command) override;
     arrow::Result<int64_t> DoPutCommandStatementUpdate(const arrow::flight::ServerCallContext& context,
                                                        const arrow::flight::sql::StatementUpdate& command) override;
+    arrow::Result<arrow::flight::sql::ActionCreatePreparedStatementResult>
+    CreatePreparedStatement(const arrow::flight::ServerCallContext& context,
+                            const arrow::flight::sql::ActionCreatePreparedStatementRequest& request) override;
+    arrow::Status
+    ClosePreparedStatement(const arrow::flight::ServerCallContext& context,
+                           const arrow::flight::sql::ActionClosePreparedStatementRequest& request) override;
+    arrow::Result<std::string> DoPutPreparedStatementQuery(const arrow::flight::ServerCallContext& context,
+                                                           const arrow::flight::sql::PreparedStatementQuery& command,
+                                                           arrow::flight::FlightMessageReader* reader,
+                                                           arrow::flight::FlightMetadataWriter* writer) override;
+    arrow::Result<std::unique_ptr<arrow::flight::FlightInfo>>
+    GetFlightInfoPreparedStatement(const arrow::flight::ServerCallContext& context,
+                                   const arrow::flight::sql::PreparedStatementQuery& command,
+                                   const arrow::flight::FlightDescriptor& descriptor) override;
+    arrow::Result<std::unique_ptr<arrow::flight::FlightDataStream>>
+    DoGetPreparedStatement(const arrow::flight::ServerCallContext& context,
+                           const arrow::flight::sql::PreparedStatementQuery& command) override;
     arrow::Status Start();
 
 private:
+    // statement prepared by the scheduler under its own session, the handle is the session hash
+    struct prepared_statement_t {
+        session_hash_t session_hash;
+        std::string query;
+        std::shared_ptr<arrow::Schema> dataset_schema;
+        size_t parameter_count = 0;
+        // guarded by prepared_mtx_
+        std::chrono::steady_clock::time_point last_used;
+        // the scheduler runs one execution of a statement at a time, guards parameter_sets as well.
+        // a DoGet stream holds it until its last execution is read
+        std::mutex execution_mtx;
+        // every bound row is one execution, kept until the client binds again
+        std::vector<std::pmr::vector<components::types::logical_value_t>> parameter_sets;
+    };
+    using prepared_statement_ptr = std::shared_ptr<prepared_statement_t>;
+
+    arrow::Result<prepared_statement_ptr> FindPreparedStatement(const std::string& handle);
+    // called under prepared_mtx_ before a statement is added, sessions of the evicted ones are closed
+    void EvictPreparedStatements(std::chrono::steady_clock::time_point now);
+    // one execution of the statement plan with the given parameters, its rows are converted as they are read.
+    // nullptr if it returned nothing
+    arrow::Result<std::shared_ptr<ChunkBatchReader>>
+    ExecutePreparedStatement(session_hash_t id,
+                             std::pmr::vector<components::types::logical_value_t> parameters,
+                             std::chrono::milliseconds timeout);
+
+    // describes the statement and keeps its plan in the scheduler under the session for execution
+    arrow::Result<shared_flight_data> DescribeStatement(session_hash_t id, const std::string& query);
+    // runs the described statement of the session and spools its batches for the DoGet of the ticket,
+    // nullptr if the result is too large to be spooled
+    arrow::Result<ResultSpool::spooled_result_ptr> ExecuteToSpool(session_hash_t id,
+                                                                  const std::string& query,
+                                                                  std::shared_ptr<arrow::Schema> schema);
+
     log_t log_;
     arrow::flight::Location location_;
     std::pmr::memory_resource* resource_{nullptr};
     actor_zeta::address_t catalog_address_;
     actor_zeta::address_t scheduler_address_;
+    size_t batch_rows_;
+    size_t max_endpoints_;
+    std::chrono::milliseconds prepared_ttl_;
+    size_t max_prepared_statements_;
+    std::unique_ptr<ResultSpool> spool_;
+    std::mutex prepared_mtx_;
+    std::unordered_map<std::string, prepared_statement_ptr> prepared_statements_;
 };
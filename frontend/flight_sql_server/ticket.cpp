@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "ticket.hpp"
+
+#include "arrow/flight/sql/api.h"
+
+std::string EncodeStatementHandle(const TicketData& data) {
+    std::string handle = data.sql_query;
+    handle += ':';
+    handle += data.transaction_id;
+    handle += ':';
+    handle += std::to_string(data.session_hash);
+    handle += ':';
+    handle += std::to_string(data.endpoint);
+    handle += ':';
+    handle += data.spooled ? '1' : '0';
+    return handle;
+}
+
+arrow::Result<TicketData> DecodeTransactionQuery(const std::string& ticket) {
+    // endpoint & spooled flag
+    auto fourth_divider = ticket.rfind(':');
+    if (fourth_divider == std::string::npos || fourth_divider == 0) {
+        return arrow::Status::Invalid("Malformed ticket: missing fourth divider");
+    }
+
+    // session_hash & endpoint
+    auto third_divider = ticket.rfind(':', fourth_divider - 1);
+    if (third_divider == std::string::npos || third_divider == 0) {
+        return arrow::Status::Invalid("Malformed ticket: missing third divider");
+    }
+
+    // transaction_id & session_hash
+    auto second_divider = ticket.rfind(':', third_divider - 1);
+    if (second_divider == std::string::npos || second_divider == 0) {
+        return arrow::Status::Invalid("Malformed ticket: missing second divider");
+    }
+
+    // SQL & transaction_id
+    auto first_divider = ticket.rfind(':', second_divider - 1);
+    if (first_divider == std::string::npos) {
+        return arrow::Status::Invalid("Malformed ticket: missing first divider");
+    }
+
+    std::string sql_query = ticket.substr(0, first_divider);
+    std::string transaction_id = ticket.substr(first_divider + 1, second_divider - first_divider - 1);
+    std::string session_str = ticket.substr(second_divider + 1, third_divider - second_divider - 1);
+    std::string endpoint_str = ticket.substr(third_divider + 1, fourth_divider - third_divider - 1);
+    std::string spooled_str = ticket.substr(fourth_divider + 1);
+    if (spooled_str != "0" && spooled_str != "1") {
+        return arrow::Status::Invalid("Malformed ticket: spooled flag is " + spooled_str);
+    }
+
+    try {
+        size_t pos = 0;
+        size_t session_hash = std::stoul(session_str, &pos);
+        if (pos != session_str.size()) {
+            return arrow::Status::Invalid("Malformed ticket: session hash is " + session_str);
+        }
+        size_t endpoint = std::stoul(endpoint_str, &pos);
+        if (pos != endpoint_str.size()) {
+            return arrow::Status::Invalid("Malformed ticket: endpoint is " + endpoint_str);
+        }
+        return TicketData(std::move(sql_query), std::move(transaction_id), session_hash, endpoint, spooled_str == "1");
+    } catch (const std::exception& e) {
+        return arrow::Status::Invalid("Failed to extract session hash from ticket: " +
+                                      ticket.substr(second_divider + 1) + " error: " + e.what());
+    }
+}
+
+arrow::Result<arrow::flight::Ticket> EncodeTransactionQuery(const TicketData& data) {
+    ARROW_ASSIGN_OR_RAISE(auto ticket_string,
+                          arrow::flight::sql::CreateStatementQueryTicket(EncodeStatementHandle(data)));
+    return arrow::flight::Ticket{std::move(ticket_string)};
+}
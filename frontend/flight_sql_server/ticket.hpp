@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include "arrow/api.h"
+#include "arrow/flight/api.h"
+
+#include "../../utility/session.hpp"
+
+#include <string>
+
+struct TicketData {
+    std::string sql_query;
+    std::string transaction_id;
+    session_hash_t session_hash;
+    size_t endpoint = 0;
+    // the result waits in the spool, it is never executed again by DoGetStatement
+    bool spooled = false;
+};
+
+// statement handle "<sql>:<transaction id>:<session hash>:<endpoint>:<spooled>". fields are read from the end,
+// so the query may contain ':' and the transaction ID may not
+std::string EncodeStatementHandle(const TicketData& data);
+arrow::Result<TicketData> DecodeTransactionQuery(const std::string& ticket);
+
+// Create a Ticket that combines a SQL query, transaction ID, session hash, endpoint index and spooled flag.
+arrow::Result<arrow::flight::Ticket> EncodeTransactionQuery(const TicketData& data);
@@ -42,6 +42,13 @@ namespace frontend::mysql {
 
     void mysql_connection::start_impl() { send_handshake(); }
 
+    void mysql_connection::finish_impl() {
+        for (auto& [stmt_id, meta] : statement_id_map_) {
+            close_statement(meta.stmt_session);
+        }
+        statement_id_map_.clear();
+    }
+
     log_t& mysql_connection::get_logger_impl() { return log_; }
 
     uint32_t mysql_connection::get_header_size() const { return PACKET_HEADER_SIZE; }
@@ -49,6 +49,7 @@ namespace frontend::mysql {
 
     protected:
         void start_impl() override;
+        void finish_impl() override;
 
         log_t& get_logger_impl() override;
         uint32_t get_header_size() const override;
@@ -83,6 +84,7 @@ namespace frontend::mysql {
                               std::pmr::vector<uint16_t>& param_types,
                               packet_reader&& reader);
         void handle_execute_stmt(session_hash_t id, std::pmr::vector<components::types::logical_value_t> param_values);
+        void close_statement(session_hash_t id);
 
         void send_resultset(mysql_resultset&& result);
         void send_error(mysql_error error_code, std::string message);
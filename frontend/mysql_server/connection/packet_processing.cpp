@@ -172,7 +172,10 @@ namespace frontend::mysql {
                 packet_reader reader(std::move(payload));
                 reader.read_uint8(); // skip [0x25] - COM_STMT_CLOSE
                 uint32_t stmt_id = reader.read_uint32();
-                statement_id_map_.erase(stmt_id);
+                if (auto it_stmt = statement_id_map_.find(stmt_id); it_stmt != statement_id_map_.end()) {
+                    close_statement(it_stmt->second.stmt_session);
+                    statement_id_map_.erase(it_stmt);
+                }
                 read_packet(); // nothing is sent to client, read next
                 break;
             }
@@ -196,36 +199,36 @@ namespace frontend::mysql {
                          id.hash(),
                          shared_data,
                          query);
-        shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
-
-        switch (shared_data->status()) {
-            case cv_wrapper::Status::Ok:
-                if (!shared_data->result.chunk.empty()) {
-                    break;
-                }
-                // fallthrough otherwise
-            case cv_wrapper::Status::Empty:
-                send_packet(build_ok(writer_, sequence_id_, 0));
-                return;
-            case cv_wrapper::Status::Timeout:
-            case cv_wrapper::Status::Unknown:
-                send_error(mysql_error::ER_QUERY_TIMEOUT, "Query exceeded execution limit");
-                return;
-            case cv_wrapper::Status::Error:
-                // all connectors send "SET NAMES utf8mb4" and "SET AUTOCOMMIT=0" after auth, handle them separately
-                try_fix_variable_set_query(query, shared_data->error_message());
-                return;
-        }
+        await_result(shared_data, [this, shared_data, query = std::move(query)]() mutable {
+            switch (shared_data->status()) {
+                case cv_wrapper::Status::Ok:
+                    if (!shared_data->result.chunk.empty()) {
+                        break;
+                    }
+                    // fallthrough otherwise
+                case cv_wrapper::Status::Empty:
+                    send_packet(build_ok(writer_, sequence_id_, 0));
+                    return;
+                case cv_wrapper::Status::Timeout:
+                case cv_wrapper::Status::Unknown:
+                    send_error(mysql_error::ER_QUERY_TIMEOUT, "Query exceeded execution limit");
+                    return;
+                case cv_wrapper::Status::Error:
+                    // all connectors send "SET NAMES utf8mb4" and "SET AUTOCOMMIT=0" after auth, handle them separately
+                    try_fix_variable_set_query(query, shared_data->error_message());
+                    return;
+            }
 
-        // handle Ok
-        // empty db & table in metadata (not critical, but may be improved)
-        mysql_resultset result(writer_, result_encoding::TEXT);
-        result.add_chunk_columns(shared_data->result.chunk);
-        for (size_t i = 0; i < shared_data->result.chunk.size(); i++) {
-            result.add_row(shared_data->result.chunk, i);
-        }
+            // handle Ok
+            // empty db & table in metadata (not critical, but may be improved)
+            mysql_resultset result(writer_, result_encoding::TEXT);
+            result.add_chunk_columns(shared_data->result.chunk);
+            for (size_t i = 0; i < shared_data->result.chunk.size(); i++) {
+                result.add_row(shared_data->result.chunk, i);
+            }
 
-        send_resultset(std::move(result));
+            send_resultset(std::move(result));
+        });
     }
 
     void mysql_connection::try_fix_variable_set_query(std::string_view query, std::string error) {
@@ -291,56 +294,56 @@ namespace frontend::mysql {
                          id.hash(),
                          shared_data,
                          query);
-        shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
-
-        switch (shared_data->status()) {
-            case cv_wrapper::Status::Ok:
-            case cv_wrapper::Status::Empty:
-                break;
-            case cv_wrapper::Status::Timeout:
-            case cv_wrapper::Status::Unknown:
-                send_error(mysql_error::ER_QUERY_TIMEOUT, "Query exceeded execution limit");
-                return;
-            case cv_wrapper::Status::Error:
-                // ? case - postgres will not allow
-                try_fix_prepared_stmt(query, shared_data->error_message());
-                return;
-        }
+        await_result(shared_data, [this, shared_data, id = id.hash(), query = std::move(query)]() mutable {
+            switch (shared_data->status()) {
+                case cv_wrapper::Status::Ok:
+                case cv_wrapper::Status::Empty:
+                    break;
+                case cv_wrapper::Status::Timeout:
+                case cv_wrapper::Status::Unknown:
+                    send_error(mysql_error::ER_QUERY_TIMEOUT, "Query exceeded execution limit");
+                    return;
+                case cv_wrapper::Status::Error:
+                    // ? case - postgres will not allow
+                    try_fix_prepared_stmt(query, shared_data->error_message());
+                    return;
+            }
 
-        auto& result = shared_data->result;
-        std::vector<std::vector<uint8_t>> packets;
-
-        uint16_t column_cnt = result.schema != types::logical_type::NA ? result.schema.child_types().size() : 0;
-        packets.reserve(4 + column_cnt + result.parameter_count);
-        log_->info("[Connection {}] COM_STMT_PREPARE: id={} column_cnt={} param_cnt={}",
-                   connection_id_,
-                   next_statement_id_,
-                   column_cnt,
-                   result.parameter_count);
-        packets.push_back(
-            build_stmt_prepare_ok(writer_, sequence_id_++, next_statement_id_, column_cnt, result.parameter_count));
-        statement_id_map_.emplace(next_statement_id_++,
-                                  prepared_stmt_meta(resource_, id.hash(), result.parameter_count));
-
-        // params
-        if (result.parameter_count) {
-            for (size_t i = 0; i < result.parameter_count; ++i) {
-                column_definition_41 param("?", field_type::MYSQL_TYPE_STRING);
-                packets.push_back(column_definition_41::write_packet(std::move(param), writer_, sequence_id_++));
+            auto& result = shared_data->result;
+            std::vector<std::vector<uint8_t>> packets;
+
+            uint16_t column_cnt = result.schema != types::logical_type::NA ? result.schema.child_types().size() : 0;
+            packets.reserve(4 + column_cnt + result.parameter_count);
+            log_->info("[Connection {}] COM_STMT_PREPARE: id={} column_cnt={} param_cnt={}",
+                       connection_id_,
+                       next_statement_id_,
+                       column_cnt,
+                       result.parameter_count);
+            packets.push_back(
+                build_stmt_prepare_ok(writer_, sequence_id_++, next_statement_id_, column_cnt, result.parameter_count));
+            statement_id_map_.emplace(next_statement_id_++,
+                                      prepared_stmt_meta(resource_, id, result.parameter_count));
+
+            // params
+            if (result.parameter_count) {
+                for (size_t i = 0; i < result.parameter_count; ++i) {
+                    column_definition_41 param("?", field_type::MYSQL_TYPE_STRING);
+                    packets.push_back(column_definition_41::write_packet(std::move(param), writer_, sequence_id_++));
+                }
+                packets.push_back(build_eof(writer_, sequence_id_++));
             }
-            packets.push_back(build_eof(writer_, sequence_id_++));
-        }
 
-        // columns
-        if (column_cnt) {
-            for (auto& column : result.schema.child_types()) {
-                column_definition_41 col(column.alias(), get_field_type(column.type()));
-                packets.push_back(column_definition_41::write_packet(std::move(col), writer_, sequence_id_++));
+            // columns
+            if (column_cnt) {
+                for (auto& column : result.schema.child_types()) {
+                    column_definition_41 col(column.alias(), get_field_type(column.type()));
+                    packets.push_back(column_definition_41::write_packet(std::move(col), writer_, sequence_id_++));
+                }
+                packets.push_back(build_eof(writer_, sequence_id_++));
             }
-            packets.push_back(build_eof(writer_, sequence_id_++));
-        }
 
-        send_packet_sequence(std::move(packets), 0);
+            send_packet_sequence(std::move(packets), 0);
+        });
     }
 
     void mysql_connection::try_fix_prepared_stmt(std::string_view query, std::string error) {
@@ -491,33 +494,41 @@ namespace frontend::mysql {
                          id,
                          std::move(param_values),
                          shared_data);
-        shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
+        await_result(shared_data, [this, shared_data]() mutable {
+            switch (shared_data->status()) {
+                case cv_wrapper::Status::Ok:
+                    if (!shared_data->result.chunk.empty()) {
+                        break;
+                    }
+                    // fallthrough otherwise
+                case cv_wrapper::Status::Empty:
+                    send_packet(build_ok(writer_, sequence_id_, 0));
+                    return;
+                case cv_wrapper::Status::Timeout:
+                case cv_wrapper::Status::Unknown:
+                    send_error(mysql_error::ER_QUERY_TIMEOUT, "Query exceeded execution limit");
+                    return;
+                case cv_wrapper::Status::Error:
+                    send_error(mysql_error::ER_SYNTAX_ERROR, shared_data->error_message());
+                    return;
+            }
 
-        switch (shared_data->status()) {
-            case cv_wrapper::Status::Ok:
-                if (!shared_data->result.chunk.empty()) {
-                    break;
-                }
-                // fallthrough otherwise
-            case cv_wrapper::Status::Empty:
-                send_packet(build_ok(writer_, sequence_id_, 0));
-                return;
-            case cv_wrapper::Status::Timeout:
-            case cv_wrapper::Status::Unknown:
-                send_error(mysql_error::ER_QUERY_TIMEOUT, "Query exceeded execution limit");
-                return;
-            case cv_wrapper::Status::Error:
-                send_error(mysql_error::ER_SYNTAX_ERROR, shared_data->error_message());
-                return;
-        }
+            mysql_resultset result(writer_, result_encoding::BINARY);
+            result.add_chunk_columns(shared_data->result.chunk);
+            for (size_t i = 0; i < shared_data->result.chunk.size(); i++) {
+                result.add_row(shared_data->result.chunk, i);
+            }
 
-        mysql_resultset result(writer_, result_encoding::BINARY);
-        result.add_chunk_columns(shared_data->result.chunk);
-        for (size_t i = 0; i < shared_data->result.chunk.size(); i++) {
-            result.add_row(shared_data->result.chunk, i);
-        }
+            send_resultset(std::move(result));
+        });
+    }
 
-        send_resultset(std::move(result));
+    void mysql_connection::close_statement(session_hash_t id) {
+        // drops the plan kept by the scheduler for re-execution
+        actor_zeta::send(scheduler_->address(),
+                         scheduler_->address(),
+                         scheduler::handler_id(scheduler::route::close_statement),
+                         id);
     }
 
     void mysql_connection::send_resultset(mysql_resultset&& result) {
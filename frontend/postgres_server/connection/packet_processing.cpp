@@ -77,42 +77,42 @@ namespace frontend::postgres {
                          id.hash(),
                          shared_data,
                          query);
-        shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
-
-        switch (shared_data->status()) {
-            case cv_wrapper::Status::Ok:
-                if (!shared_data->result.chunk.empty()) {
-                    break;
-                }
-                // fallthrough otherwise
-            case cv_wrapper::Status::Empty:
-                send_packet_merged(
-                    {build_command_complete(writer_, command_complete_tag::simple_command(shared_data->result.tag)),
-                     build_ready_for_query(writer_, transaction_man_.get_transaction_status())});
-                return;
-            case cv_wrapper::Status::Timeout:
-            case cv_wrapper::Status::Unknown:
-                send_error_response(sql_state::QUERY_CANCELED, "Query exceeded execution limit");
-                return;
-            case cv_wrapper::Status::Error:
-                // may be a transaction block, handle them separately
-                // todo: psycopg2's PREPARE & EXECUTE
-                try_handle_transaction(std::move(query), shared_data->error_message());
-                return;
-        }
+        await_result(shared_data, [this, shared_data, query = std::move(query)]() mutable {
+            switch (shared_data->status()) {
+                case cv_wrapper::Status::Ok:
+                    if (!shared_data->result.chunk.empty()) {
+                        break;
+                    }
+                    // fallthrough otherwise
+                case cv_wrapper::Status::Empty:
+                    send_packet_merged(
+                        {build_command_complete(writer_, command_complete_tag::simple_command(shared_data->result.tag)),
+                         build_ready_for_query(writer_, transaction_man_.get_transaction_status())});
+                    return;
+                case cv_wrapper::Status::Timeout:
+                case cv_wrapper::Status::Unknown:
+                    send_error_response(sql_state::QUERY_CANCELED, "Query exceeded execution limit");
+                    return;
+                case cv_wrapper::Status::Error:
+                    // may be a transaction block, handle them separately
+                    // todo: psycopg2's PREPARE & EXECUTE
+                    try_handle_transaction(std::move(query), shared_data->error_message());
+                    return;
+            }
 
-        // handle Ok
-        int32_t rows_cnt = shared_data->result.chunk.size();
-        postgres_resultset result(writer_);
-        result.add_chunk_columns(shared_data->result.chunk); // default text encoding
-        for (size_t i = 0; i < rows_cnt; i++) {
-            result.add_row(shared_data->result.chunk, i);
-        }
+            // handle Ok
+            int32_t rows_cnt = shared_data->result.chunk.size();
+            postgres_resultset result(writer_);
+            result.add_chunk_columns(shared_data->result.chunk); // default text encoding
+            for (size_t i = 0; i < rows_cnt; i++) {
+                result.add_row(shared_data->result.chunk, i);
+            }
 
-        auto response = postgres_resultset::build_packets(std::move(result));
-        response.emplace_back(build_command_complete(writer_, command_complete_tag::select(rows_cnt)));
-        response.emplace_back(build_ready_for_query(writer_, transaction_man_.get_transaction_status()));
-        send_packet_merged(std::move(response));
+            auto response = postgres_resultset::build_packets(std::move(result));
+            response.emplace_back(build_command_complete(writer_, command_complete_tag::select(rows_cnt)));
+            response.emplace_back(build_ready_for_query(writer_, transaction_man_.get_transaction_status()));
+            send_packet_merged(std::move(response));
+        });
     }
 
     void postgres_connection::try_handle_transaction(std::string query, std::string error) {
@@ -202,42 +202,48 @@ namespace frontend::postgres {
                          id.hash(),
                          shared_data,
                          query);
-        shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
-
-        switch (shared_data->status()) {
-            case cv_wrapper::Status::Ok:
-            case cv_wrapper::Status::Empty:
-                break;
-            case cv_wrapper::Status::Timeout:
-            case cv_wrapper::Status::Unknown:
-                send_error_response(sql_state::QUERY_CANCELED, "Query exceeded execution limit");
-                return;
-            case cv_wrapper::Status::Error:
-                send_error_response(sql_state::SYNTAX_ERROR, "Syntax error: " + shared_data->error_message());
-                return;
-        }
+        await_result(shared_data, [this,
+                                   shared_data,
+                                   id = id.hash(),
+                                   stmt = std::move(stmt),
+                                   query = std::move(query),
+                                   specified_types = std::move(specified_types)]() mutable {
+            switch (shared_data->status()) {
+                case cv_wrapper::Status::Ok:
+                case cv_wrapper::Status::Empty:
+                    break;
+                case cv_wrapper::Status::Timeout:
+                case cv_wrapper::Status::Unknown:
+                    send_error_response(sql_state::QUERY_CANCELED, "Query exceeded execution limit");
+                    return;
+                case cv_wrapper::Status::Error:
+                    send_error_response(sql_state::SYNTAX_ERROR, "Syntax error: " + shared_data->error_message());
+                    return;
+            }
 
-        auto& result = shared_data->result;
-        log_->debug("[Connection {}] PARSE stmt: query: \"{}\", param_cnt={}",
-                    connection_id_,
-                    query,
-                    result.parameter_count);
+            auto& result = shared_data->result;
+            log_->debug("[Connection {}] PARSE stmt: query: \"{}\", param_cnt={}",
+                        connection_id_,
+                        query,
+                        result.parameter_count);
 
-        if (result.parameter_count != specified_types.size()) {
-            send_error_response(sql_state::UNDEFINED_PARAMETER,
-                                "Parameter type left unspecified: specified " + std::to_string(specified_types.size()) +
-                                    " out of " + std::to_string(result.parameter_count));
-            return;
-        }
+            if (result.parameter_count != specified_types.size()) {
+                send_error_response(sql_state::UNDEFINED_PARAMETER,
+                                    "Parameter type left unspecified: specified " +
+                                        std::to_string(specified_types.size()) + " out of " +
+                                        std::to_string(result.parameter_count));
+                return;
+            }
 
-        statement_name_map_.erase(stmt); // statements with identical name replace each other
-        statement_name_map_.emplace(std::move(stmt),
-                                    prepared_stmt_meta(resource_,
-                                                       id.hash(),
-                                                       result.parameter_count,
-                                                       std::move(result.schema),
-                                                       std::move(specified_types)));
-        send_packet(build_parse_complete(writer_));
+            do_close(describe_close_arg::STATEMENT, stmt); // statements with identical name replace each other
+            statement_name_map_.emplace(std::move(stmt),
+                                        prepared_stmt_meta(resource_,
+                                                           id,
+                                                           result.parameter_count,
+                                                           std::move(result.schema),
+                                                           std::move(specified_types)));
+            send_packet(build_parse_complete(writer_));
+        });
     }
 
     void postgres_connection::handle_bind(std::string stmt,
@@ -443,7 +449,10 @@ namespace frontend::postgres {
         }
 
         auto& portal_meta = it->second;
-        auto& stmt = portal_meta.statement.get();
+        const auto& stmt = portal_meta.statement.get();
+        // the statement may be closed before the result is in, the reply only needs what it knows now
+        bool is_schema_known = stmt.is_schema_known_;
+        auto format = stmt.format;
         auto shared_data = create_cv_wrapper(flight_data(resource_));
         actor_zeta::send(scheduler_->address(),
                          scheduler_->address(),
@@ -451,46 +460,46 @@ namespace frontend::postgres {
                          stmt.stmt_session,
                          portal_meta.portal,
                          shared_data);
-        shared_data->wait_for(cv_wrapper::DEFAULT_TIMEOUT);
-
-        switch (shared_data->status()) {
-            case cv_wrapper::Status::Ok:
-                if (!shared_data->result.chunk.empty()) {
-                    break;
-                }
-                // fallthrough otherwise
-            case cv_wrapper::Status::Empty:
-                send_packet(
-                    build_command_complete(writer_, command_complete_tag::simple_command(shared_data->result.tag)));
-                return;
-            case cv_wrapper::Status::Timeout:
-            case cv_wrapper::Status::Unknown:
-                send_error_response(sql_state::QUERY_CANCELED, "Query exceeded execution limit");
-                return;
-            case cv_wrapper::Status::Error:
-                send_error_response(sql_state::SYNTAX_ERROR, "Syntax error: " + shared_data->error_message());
-                return;
-        }
+        await_result(shared_data, [this, shared_data, is_schema_known, format = std::move(format), limit]() mutable {
+            switch (shared_data->status()) {
+                case cv_wrapper::Status::Ok:
+                    if (!shared_data->result.chunk.empty()) {
+                        break;
+                    }
+                    // fallthrough otherwise
+                case cv_wrapper::Status::Empty:
+                    send_packet(
+                        build_command_complete(writer_, command_complete_tag::simple_command(shared_data->result.tag)));
+                    return;
+                case cv_wrapper::Status::Timeout:
+                case cv_wrapper::Status::Unknown:
+                    send_error_response(sql_state::QUERY_CANCELED, "Query exceeded execution limit");
+                    return;
+                case cv_wrapper::Status::Error:
+                    send_error_response(sql_state::SYNTAX_ERROR, "Syntax error: " + shared_data->error_message());
+                    return;
+            }
 
-        // TODO: PortalSuspended
-        int32_t rows_cnt = shared_data->result.chunk.size();
-        if (limit != 0) {
-            rows_cnt = std::min(static_cast<size_t>(limit), shared_data->result.chunk.size());
-        }
+            // TODO: PortalSuspended
+            int32_t rows_cnt = shared_data->result.chunk.size();
+            if (limit != 0) {
+                rows_cnt = std::min(static_cast<size_t>(limit), shared_data->result.chunk.size());
+            }
 
-        postgres_resultset result(writer_, stmt.is_schema_known_);
-        if (!stmt.is_schema_known_) {
-            result.add_chunk_columns(shared_data->result.chunk);
-        }
-        result.add_encoding(stmt.format);
+            postgres_resultset result(writer_, is_schema_known);
+            if (!is_schema_known) {
+                result.add_chunk_columns(shared_data->result.chunk);
+            }
+            result.add_encoding(std::move(format));
 
-        for (size_t i = 0; i < rows_cnt; i++) {
-            result.add_row(shared_data->result.chunk, i);
-        }
+            for (size_t i = 0; i < rows_cnt; i++) {
+                result.add_row(shared_data->result.chunk, i);
+            }
 
-        auto response = postgres_resultset::build_packets(std::move(result));
-        response.emplace_back(build_command_complete(writer_, command_complete_tag::select(rows_cnt)));
-        send_packet_merged(std::move(response));
+            auto response = postgres_resultset::build_packets(std::move(result));
+            response.emplace_back(build_command_complete(writer_, command_complete_tag::select(rows_cnt)));
+            send_packet_merged(std::move(response));
+        });
     }
 
     void postgres_connection::handle_close(describe_close_arg type, std::string name) {
@@ -505,6 +514,11 @@ namespace frontend::postgres {
                 for (auto&& p : it->second.portal_names) {
                     do_close(describe_close_arg::PORTAL, std::move(p));
                 }
+                // drops the plan kept by the scheduler for re-execution
+                actor_zeta::send(scheduler_->address(),
+                                 scheduler_->address(),
+                                 scheduler::handler_id(scheduler::route::close_statement),
+                                 it->second.stmt_session);
                 statement_name_map_.erase(it);
             }
         } else {
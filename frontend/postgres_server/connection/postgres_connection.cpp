@@ -47,6 +47,13 @@ namespace frontend::postgres {
 
     void postgres_connection::start_impl() { read_initial_message(); }
 
+    void postgres_connection::finish_impl() {
+        portals_.clear();
+        while (!statement_name_map_.empty()) {
+            do_close(describe_close_arg::STATEMENT, statement_name_map_.begin()->first);
+        }
+    }
+
     log_t& postgres_connection::get_logger_impl() { return log_; }
 
     uint32_t postgres_connection::get_header_size() const { return PACKET_HEADER_SIZE; }
@@ -63,6 +63,7 @@ namespace frontend::postgres {
 
     protected:
         void start_impl() override;
+        void finish_impl() override;
 
         log_t& get_logger_impl() override;
         uint32_t get_header_size() const override;
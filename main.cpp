@@ -29,6 +29,13 @@ int main(int argc, char* argv[]) {
     uint16_t mysql_port = 8816;
     uint16_t postgres_port = 8817;
     uint16_t http_port = 8085;
+    size_t flight_batch_rows = ChunkBatchReader::DEFAULT_BATCH_ROWS;
+    bool flight_spool_results = false;
+    size_t flight_spool_ttl = 60;
+    size_t flight_spool_max_mb = 1024;
+    size_t flight_endpoints = 1;
+    bool partial_aggregation = false;
+    bool analyze_statistics = false;
 
     // Define command-line options
     po::options_description desc("Allowed options");
@@ -39,6 +46,21 @@ int main(int argc, char* argv[]) {
     ("port-flight",
     po::value<uint16_t>(&flight_port)->default_value(flight_port),
     "FlightSQL server port")
+    ("flight-batch-rows",
+    po::value<size_t>(&flight_batch_rows)->default_value(flight_batch_rows),
+    "Rows per FlightSQL record batch")
+    ("flight-spool-results",
+    po::value<bool>(&flight_spool_results)->default_value(flight_spool_results),
+    "Execute queries in GetFlightInfoStatement and keep the result for DoGetStatement")
+    ("flight-spool-ttl",
+    po::value<size_t>(&flight_spool_ttl)->default_value(flight_spool_ttl),
+    "Seconds a spooled FlightSQL result waits for its DoGetStatement")
+    ("flight-spool-max-mb",
+    po::value<size_t>(&flight_spool_max_mb)->default_value(flight_spool_max_mb),
+    "Megabytes all spooled FlightSQL results may take, larger results are executed by DoGetStatement")
+    ("flight-endpoints",
+    po::value<size_t>(&flight_endpoints)->default_value(flight_endpoints),
+    "Maximum number of FlightSQL endpoints a spooled result is split into")
     ("port-mysql",
     po::value<uint16_t>(&mysql_port)->default_value(mysql_port),
     "MySQL server port")
@@ -47,7 +69,13 @@ int main(int argc, char* argv[]) {
     "PostgreSQL server port")
     ("port-http",
     po::value<uint16_t>(&http_port)->default_value(http_port),
-    "Connection manager HTTP server port");
+    "Connection manager HTTP server port")
+    ("partial-aggregation",
+    po::value<bool>(&partial_aggregation)->default_value(partial_aggregation),
+    "Split aggregates over joins into remote partial and local final steps")
+    ("analyze-statistics",
+    po::value<bool>(&analyze_statistics)->default_value(analyze_statistics),
+    "Run ANALYZE TABLE on remote tables before reading their statistics");
 
     // Parse arguments
     po::variables_map vm;
@@ -75,6 +103,8 @@ int main(int argc, char* argv[]) {
 
     // Create component manager
     ComponentManager cmanager(make_create_config("/tmp/test_collection_sql/base"));
+    cmanager.set_partial_aggregation(partial_aggregation);
+    cmanager.set_analyze_statistics(analyze_statistics);
 
     // Configure the Flight SQL server
     Config config{
@@ -83,6 +113,11 @@ int main(int argc, char* argv[]) {
         .resource = cmanager.getResource(),
         .catalog_address = cmanager.catalog_address(),
         .scheduler_address = cmanager.scheduler_address(),
+        .batch_rows = flight_batch_rows,
+        .spool_results = flight_spool_results,
+        .spool_ttl = std::chrono::seconds(flight_spool_ttl),
+        .spool_max_bytes = static_cast<int64_t>(flight_spool_max_mb) << 20,
+        .max_endpoints = flight_endpoints,
     };
 
     SimpleFlightSQLServer server(config);
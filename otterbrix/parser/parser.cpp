@@ -3,12 +3,34 @@
 
 #include "parser.hpp"
 
+#include <components/expressions/aggregate_expression.hpp>
+#include <components/expressions/compare_expression.hpp>
+#include <components/expressions/scalar_expression.hpp>
+#include <components/expressions/sort_expression.hpp>
+#include <components/logical_plan/node_aggregate.hpp>
+#include <components/logical_plan/node_delete.hpp>
 #include <components/logical_plan/node_function.hpp>
+#include <components/logical_plan/node_group.hpp>
+#include <components/logical_plan/node_insert.hpp>
+#include <components/logical_plan/node_join.hpp>
+#include <components/logical_plan/node_limit.hpp>
+#include <components/logical_plan/node_match.hpp>
+#include <components/logical_plan/node_sort.hpp>
+#include <components/logical_plan/node_update.hpp>
+#include <components/logical_plan/param_storage.hpp>
 #include <components/sql/parser/parser.h>
 #include <components/sql/transformer/utils.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
 #include <deque>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace components;
 
@@ -65,24 +87,13 @@ static size_t get_external_nodes(std::pmr::memory_resource* resource,
         auto& n = nodes_lookup.front();
         // log_.trace("checking nodes: type: {}; collection: {}", to_string((*n.ptr)->type()), (*n.ptr)->collection_full_name().to_string());
         if (!(*n.ptr)->collection_full_name().unique_identifier.empty() && is_valid_external((*n.ptr)->type())) {
-            {
-                // TODO: remove this segment when connection pool will be added
-                // For now uid call can not repeat inside a batch
-                auto it = std::find_if(external_nodes[n.batch_index].begin(),
-                                       external_nodes[n.batch_index].end(),
-                                       [&n](const auto& external_node) {
-                                           return (*external_node)->collection_full_name().unique_identifier ==
-                                                  (*n.ptr)->collection_full_name().unique_identifier;
-                                       });
-                if (it != external_nodes[n.batch_index].end()) {
-                    ++n.batch_index;
-                    if (external_nodes.size() == n.batch_index) {
-                        external_nodes.emplace_back();
-                    }
-                }
-            }
             external_nodes[n.batch_index].emplace_back(n.ptr);
             ++size;
+            if ((*n.ptr)->type() == logical_plan::node_type::aggregate_t) {
+                // the whole subtree is generated into the query of this node
+                nodes_lookup.pop_front();
+                continue;
+            }
         }
         bool mutable_node = is_mutable((*n.ptr)->type());
         if (mutable_node) {
@@ -100,14 +111,296 @@ static size_t get_external_nodes(std::pmr::memory_resource* resource,
     return size;
 }
 
+// the generated join names each scan after its table, a key qualified with anything else (a user alias) would
+// not resolve on the backend
+static bool qualified_by_tables(const expressions::key_t& key, const std::unordered_set<std::string>& tables) {
+    if (key.is_null()) {
+        return true;
+    }
+    const auto name = key.as_string();
+    const auto pos = name.rfind('.');
+    return pos == std::string::npos || tables.count(name.substr(0, pos));
+}
+
+static bool qualified_by_tables(const expressions::expression_ptr& expr_ptr,
+                                const std::unordered_set<std::string>& tables) {
+    auto params_qualified = [&tables](const auto& params) {
+        return std::all_of(params.begin(), params.end(), [&tables](const auto& param) {
+            return !std::holds_alternative<expressions::key_t>(param) ||
+                   qualified_by_tables(std::get<expressions::key_t>(param), tables);
+        });
+    };
+    switch (expr_ptr->group()) {
+        case expressions::expression_group::compare: {
+            auto& expr = static_cast<const expressions::compare_expression_t&>(*expr_ptr);
+            return qualified_by_tables(expr.key_left(), tables) && qualified_by_tables(expr.key_right(), tables) &&
+                   std::all_of(expr.children().begin(), expr.children().end(), [&tables](const auto& child) {
+                       return qualified_by_tables(child, tables);
+                   });
+        }
+        case expressions::expression_group::aggregate: {
+            auto& expr = static_cast<const expressions::aggregate_expression_t&>(*expr_ptr);
+            return expr.params().empty() ? qualified_by_tables(expr.key(), tables) : params_qualified(expr.params());
+        }
+        case expressions::expression_group::scalar: {
+            auto& expr = static_cast<const expressions::scalar_expression_t&>(*expr_ptr);
+            return expr.params().empty() ? qualified_by_tables(expr.key(), tables) : params_qualified(expr.params());
+        }
+        case expressions::expression_group::sort:
+            return qualified_by_tables(static_cast<const expressions::sort_expression_t&>(*expr_ptr).key(), tables);
+        default:
+            return false;
+    }
+}
+
+// a join whose scans all go through the same connection is sent as one query: the root aggregate
+// takes the identifier of the scans and becomes the only external node
+static void push_colocated_join(std::pmr::memory_resource* resource, logical_plan::node_ptr& node) {
+    if (node->type() != logical_plan::node_type::aggregate_t ||
+        !node->collection_full_name().unique_identifier.empty()) {
+        return;
+    }
+
+    const logical_plan::node_ptr* join = nullptr;
+    for (const auto& child : node->children()) {
+        switch (child->type()) {
+            case logical_plan::node_type::join_t:
+                if (join) {
+                    return;
+                }
+                join = &child;
+                break;
+            case logical_plan::node_type::group_t:
+            case logical_plan::node_type::match_t:
+            case logical_plan::node_type::sort_t:
+            case logical_plan::node_type::limit_t:
+                break;
+            default:
+                return;
+        }
+    }
+    if (!join) {
+        return;
+    }
+
+    std::optional<collection_full_name_t> scan_name;
+    std::unordered_set<std::string> tables;
+    std::vector<const expressions::expression_ptr*> keyed;
+    std::deque<const logical_plan::node_ptr*> nodes_lookup{join};
+    while (!nodes_lookup.empty()) {
+        const auto& n = *nodes_lookup.front();
+        nodes_lookup.pop_front();
+        if (n->type() == logical_plan::node_type::join_t) {
+            // mysql has no FULL JOIN, otterbrix keeps doing those along with semi and anti joins
+            switch (static_cast<const logical_plan::node_join_t&>(*n).type()) {
+                case logical_plan::join_type::inner:
+                case logical_plan::join_type::left:
+                case logical_plan::join_type::right:
+                case logical_plan::join_type::cross:
+                    break;
+                default:
+                    return;
+            }
+            for (const auto& expr : n->expressions()) {
+                keyed.push_back(&expr);
+            }
+            for (const auto& child : n->children()) {
+                nodes_lookup.push_back(&child);
+            }
+            continue;
+        }
+
+        const auto& name = n->collection_full_name();
+        if (n->type() != logical_plan::node_type::aggregate_t || !n->children().empty() ||
+            name.unique_identifier.empty() || (scan_name && scan_name->unique_identifier != name.unique_identifier)) {
+            return;
+        }
+        // a self-join or tables of the same name in two databases would share an alias
+        if (!tables.insert(name.collection).second) {
+            return;
+        }
+        if (!scan_name) {
+            scan_name = name;
+        }
+    }
+
+    for (const auto& child : node->children()) {
+        if (child->type() != logical_plan::node_type::join_t) {
+            for (const auto& expr : child->expressions()) {
+                keyed.push_back(&expr);
+            }
+        }
+    }
+    if (!std::all_of(keyed.begin(), keyed.end(), [&tables](const auto* expr) {
+            return qualified_by_tables(*expr, tables);
+        })) {
+        return;
+    }
+
+    auto pushed = logical_plan::make_node_aggregate(resource, *scan_name);
+    for (const auto& child : node->children()) {
+        pushed->append_child(child);
+    }
+    node = pushed;
+}
+
+// the generator translates one WHERE filter, the group, the sort and the limit of an aggregate. an external root
+// with anything else (a HAVING filter next to the WHERE one) only fetches its rows, otterbrix aggregates them
+static void split_local_aggregation(std::pmr::memory_resource* resource, logical_plan::node_ptr& node) {
+    if (node->type() != logical_plan::node_type::aggregate_t ||
+        node->collection_full_name().unique_identifier.empty()) {
+        return;
+    }
+
+    size_t matches = 0;
+    bool translated = true;
+    for (const auto& child : node->children()) {
+        switch (child->type()) {
+            case logical_plan::node_type::match_t:
+                ++matches;
+                break;
+            case logical_plan::node_type::join_t:
+            case logical_plan::node_type::group_t:
+            case logical_plan::node_type::sort_t:
+            case logical_plan::node_type::limit_t:
+                break;
+            default:
+                translated = false;
+                break;
+        }
+    }
+    if (translated && matches < 2) {
+        return;
+    }
+
+    // which filter is the WHERE is not known here, all of them stay local
+    auto scan = logical_plan::make_node_aggregate(resource, node->collection_full_name());
+    auto local = logical_plan::make_node_aggregate(resource, collection_full_name_t());
+    local->append_child(scan);
+    for (const auto& child : node->children()) {
+        if (child->type() == logical_plan::node_type::join_t) {
+            scan->append_child(child);
+        } else {
+            local->append_child(child);
+        }
+    }
+    node = local;
+}
+
+template<typename Node>
+static logical_plan::node_ptr copy_node(const logical_plan::node_ptr& node) {
+    return logical_plan::node_ptr(new Node(static_cast<const Node&>(*node)));
+}
+
+// copies every node planning or execution may change in place, expressions are shared since they are only
+// ever appended to new nodes. data and schema nodes are leaves that are only replaced in their parent's slot
+static logical_plan::node_ptr clone_plan(const logical_plan::node_ptr& node) {
+    logical_plan::node_ptr copy;
+    switch (node->type()) {
+        case logical_plan::node_type::aggregate_t:
+            copy = copy_node<logical_plan::node_aggregate_t>(node);
+            break;
+        case logical_plan::node_type::join_t:
+            copy = copy_node<logical_plan::node_join_t>(node);
+            break;
+        case logical_plan::node_type::match_t:
+            copy = copy_node<logical_plan::node_match_t>(node);
+            break;
+        case logical_plan::node_type::group_t:
+            copy = copy_node<logical_plan::node_group_t>(node);
+            break;
+        case logical_plan::node_type::sort_t:
+            copy = copy_node<logical_plan::node_sort_t>(node);
+            break;
+        case logical_plan::node_type::limit_t:
+            copy = copy_node<logical_plan::node_limit_t>(node);
+            break;
+        case logical_plan::node_type::insert_t:
+            copy = copy_node<logical_plan::node_insert_t>(node);
+            break;
+        case logical_plan::node_type::update_t:
+            copy = copy_node<logical_plan::node_update_t>(node);
+            break;
+        case logical_plan::node_type::delete_t:
+            copy = copy_node<logical_plan::node_delete_t>(node);
+            break;
+        default:
+            return node;
+    }
+    for (auto& child : copy->children()) {
+        child = clone_plan(child);
+    }
+    return copy;
+}
+
+// child slots of the template mapped to the slots at the same place in its clone
+static void map_slots(const logical_plan::node_ptr& original,
+                      logical_plan::node_ptr& clone,
+                      std::unordered_map<const logical_plan::node_ptr*, logical_plan::node_ptr*>& slots) {
+    if (original == clone) {
+        return;
+    }
+    auto& from = original->children();
+    auto& to = clone->children();
+    for (size_t i = 0; i < from.size(); ++i) {
+        slots.emplace(&from[i], &to[i]);
+        map_slots(from[i], to[i], slots);
+    }
+}
+
 ParsedQueryData::ParsedQueryData(OtterbrixStatementPtr otterbrix_params,
                                  components::sql::transform::transform_result&& binder,
                                  NodeTag tag)
+    : ParsedQueryData(std::move(otterbrix_params),
+                      std::make_shared<components::sql::transform::transform_result>(std::move(binder)),
+                      tag) {}
+
+ParsedQueryData::ParsedQueryData(OtterbrixStatementPtr otterbrix_params,
+                                 std::shared_ptr<components::sql::transform::transform_result> binder,
+                                 NodeTag tag)
     : otterbrix_params(std::move(otterbrix_params))
-    , binder_(std::move(binder))
-    , tag(tag) {}
+    , tag(tag)
+    , binder_(std::move(binder)) {}
+
+components::sql::transform::transform_result& ParsedQueryData::binder() {
+    if (!binder_) {
+        throw std::logic_error("Statement instance has no binder, parameters are bound on its template");
+    }
+    return *binder_;
+}
+
+ParsedQueryDataPtr ParsedQueryData::instantiate() const {
+    const auto& params = *otterbrix_params;
+    auto node = clone_plan(params.node);
+    auto params_node = logical_plan::parameter_node_ptr(new logical_plan::parameter_node_t(*params.params_node));
+    auto instance = ParsedQueryDataPtr(new ParsedQueryData(std::make_unique<OtterbrixStatement>(
+                                                               std::vector<std::vector<logical_plan::node_ptr*>>{},
+                                                               std::move(params_node),
+                                                               std::move(node),
+                                                               params.external_nodes_count,
+                                                               params.parameters_count),
+                                                           nullptr,
+                                                           tag));
 
-components::sql::transform::transform_result& ParsedQueryData::binder() { return binder_; }
+    std::unordered_map<const logical_plan::node_ptr*, logical_plan::node_ptr*> slots;
+    slots.emplace(&params.node, &instance->otterbrix_params->node);
+    map_slots(params.node, instance->otterbrix_params->node, slots);
+
+    auto& instance_batches = instance->otterbrix_params->external_nodes;
+    instance_batches.reserve(params.external_nodes.size());
+    for (const auto& batch : params.external_nodes) {
+        auto& instance_batch = instance_batches.emplace_back();
+        instance_batch.reserve(batch.size());
+        for (const auto* slot : batch) {
+            auto it = slots.find(slot);
+            if (it == slots.end()) {
+                throw std::logic_error("External node of a statement template sits below a node that is not copied");
+            }
+            instance_batch.push_back(it->second);
+        }
+    }
+    return instance;
+}
 
 GreenplumParser::GreenplumParser(std::pmr::memory_resource* resource)
     : resource_(resource) {
@@ -134,7 +427,205 @@ ParsedQueryDataPtr GreenplumParser::parse(const std::string& sql) {
         std::move(binder),
         tag);
 
+    push_colocated_join(resource_, result->otterbrix_params->node);
+    split_local_aggregation(resource_, result->otterbrix_params->node);
     result->otterbrix_params->external_nodes_count =
         get_external_nodes(resource_, result->otterbrix_params->node, result->otterbrix_params->external_nodes);
     return result;
-}
\ No newline at end of file
+}
+std::optional<parameterized_query_t> parameterize_query(std::pmr::memory_resource* resource, std::string_view sql) {
+    auto is_identifier = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    auto is_space = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+    // typed literals and casts keep their text, the type is part of the plan
+    auto followed_by_cast = [&](size_t pos) {
+        while (pos < sql.size() && is_space(sql[pos])) {
+            ++pos;
+        }
+        return sql.substr(pos).starts_with("::");
+    };
+
+    parameterized_query_t result{std::string{}, std::pmr::vector<types::logical_value_t>(resource)};
+    result.sql.reserve(sql.size());
+
+    // last significant token, keywords upper-cased
+    std::string previous;
+    bool first_word = true;
+    bool in_list = false;
+    bool between = false;
+    auto takes_parameter = [&] {
+        return previous == "=" || previous == "<>" || previous == "!=" || previous == "<" || previous == ">" ||
+               previous == "<=" || previous == ">=" || previous == "LIKE" || previous == "BETWEEN" ||
+               (between && previous == "AND") || (in_list && (previous == "(" || previous == ","));
+    };
+    auto add_parameter = [&](types::logical_value_t value) {
+        result.values.push_back(std::move(value));
+        result.sql += '$';
+        result.sql += std::to_string(result.values.size());
+        if (previous == "AND") {
+            between = false;
+        }
+    };
+
+    size_t i = 0;
+    while (i < sql.size()) {
+        const char c = sql[i];
+        if (is_space(c)) {
+            result.sql += c;
+            ++i;
+            continue;
+        }
+
+        if (sql.substr(i).starts_with("--") || sql.substr(i).starts_with("/*")) {
+            auto end = sql[i] == '-' ? sql.find('\n', i) : sql.find("*/", i + 2);
+            end = end == std::string_view::npos ? sql.size() : end + (sql[i] == '-' ? 0 : 2);
+            result.sql.append(sql.substr(i, end - i));
+            i = end;
+            continue;
+        }
+
+        if (c == '"' || c == '`') {
+            // quoted identifier, doubled quotes escape
+            size_t end = i + 1;
+            while (end < sql.size() && (sql[end] != c || (end + 1 < sql.size() && sql[end + 1] == c))) {
+                end += sql[end] == c ? 2 : 1;
+            }
+            end = std::min(end + 1, sql.size());
+            result.sql.append(sql.substr(i, end - i));
+            previous = "IDENT";
+            i = end;
+            continue;
+        }
+
+        if (c == '\'') {
+            if (!result.sql.empty() && is_identifier(result.sql.back())) {
+                // E'', B'', X'' and friends
+                return std::nullopt;
+            }
+            std::string value;
+            size_t end = i + 1;
+            for (;; ++end) {
+                if (end >= sql.size() || sql[end] == '\\') {
+                    return std::nullopt;
+                }
+                if (sql[end] == '\'') {
+                    if (end + 1 < sql.size() && sql[end + 1] == '\'') {
+                        value += '\'';
+                        ++end;
+                        continue;
+                    }
+                    break;
+                }
+                value += sql[end];
+            }
+            ++end;
+            if (takes_parameter() && !followed_by_cast(end)) {
+                add_parameter(types::logical_value_t(std::move(value)));
+            } else {
+                result.sql.append(sql.substr(i, end - i));
+            }
+            previous = "LITERAL";
+            i = end;
+            continue;
+        }
+
+        if (c == '$' || c == '?') {
+            // already parameterized or dollar-quoted
+            return std::nullopt;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(c)) &&
+            (result.sql.empty() || (!is_identifier(result.sql.back()) && result.sql.back() != '.'))) {
+            size_t end = i;
+            bool fractional = false;
+            while (end < sql.size() && std::isdigit(static_cast<unsigned char>(sql[end]))) {
+                ++end;
+            }
+            if (end < sql.size() && sql[end] == '.') {
+                fractional = true;
+                ++end;
+                while (end < sql.size() && std::isdigit(static_cast<unsigned char>(sql[end]))) {
+                    ++end;
+                }
+            }
+            if (end < sql.size() && (sql[end] == 'e' || sql[end] == 'E')) {
+                size_t exponent = end + 1;
+                if (exponent < sql.size() && (sql[exponent] == '+' || sql[exponent] == '-')) {
+                    ++exponent;
+                }
+                if (exponent < sql.size() && std::isdigit(static_cast<unsigned char>(sql[exponent]))) {
+                    fractional = true;
+                    end = exponent;
+                    while (end < sql.size() && std::isdigit(static_cast<unsigned char>(sql[end]))) {
+                        ++end;
+                    }
+                }
+            }
+
+            const auto text = sql.substr(i, end - i);
+            std::optional<types::logical_value_t> value;
+            if (end < sql.size() && is_identifier(sql[end])) {
+                // not a number after all
+            } else if (fractional) {
+                value.emplace(std::strtod(std::string(text).c_str(), nullptr));
+            } else if (int64_t number;
+                       std::from_chars(text.data(), text.data() + text.size(), number).ec == std::errc{}) {
+                value.emplace(number);
+            }
+            if (value && takes_parameter() && !followed_by_cast(end)) {
+                add_parameter(std::move(*value));
+            } else {
+                result.sql.append(text);
+            }
+            previous = "LITERAL";
+            i = end;
+            continue;
+        }
+
+        if (is_identifier(c)) {
+            size_t end = i;
+            while (end < sql.size() && is_identifier(sql[end])) {
+                ++end;
+            }
+            const auto word = sql.substr(i, end - i);
+            std::string keyword(word);
+            std::transform(keyword.begin(), keyword.end(), keyword.begin(), [](unsigned char ch) {
+                return static_cast<char>(std::toupper(ch));
+            });
+            if (first_word && keyword != "SELECT" && keyword != "WITH") {
+                return std::nullopt;
+            }
+            first_word = false;
+            if (keyword == "BETWEEN") {
+                between = true;
+            } else if (previous == "AND") {
+                // the upper bound of BETWEEN is not a literal
+                between = false;
+            }
+            result.sql.append(word);
+            previous = std::move(keyword);
+            i = end;
+            continue;
+        }
+
+        size_t end = i + 1;
+        if (c == '<' || c == '>' || c == '!' || c == '=') {
+            while (end < sql.size() && (sql[end] == '=' || sql[end] == '>') && end - i < 2) {
+                ++end;
+            }
+        }
+        const auto op = sql.substr(i, end - i);
+        if (op == "(") {
+            in_list = previous == "IN";
+        } else if (op == ")") {
+            in_list = false;
+        }
+        result.sql.append(op);
+        previous = std::string(op);
+        i = end;
+    }
+
+    if (first_word) {
+        return std::nullopt;
+    }
+    return result;
+}
@@ -10,26 +10,59 @@
 #include <components/logical_plan/node_data.hpp>
 #include <components/sql/transformer/transform_result.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+struct ParsedQueryData;
+using ParsedQueryDataPtr = std::unique_ptr<ParsedQueryData>;
+
 struct ParsedQueryData {
     explicit ParsedQueryData(OtterbrixStatementPtr otterbrix_params,
                              components::sql::transform::transform_result&& binder,
                              NodeTag tag);
 
     components::sql::transform::transform_result& binder();
+    // instances have none, every value of their plan is bound already
+    bool has_binder() const noexcept { return binder_ != nullptr; }
+
+    // execution copy of a prepared plan with its own nodes and parameters, bound values included.
+    // the instance has no binder, parameters are bound on the template before it is instantiated
+    ParsedQueryDataPtr instantiate() const;
 
     OtterbrixStatementPtr otterbrix_params;
 
     NodeTag tag;
 
+    // set on instances of a plan cache entry: the scheduler hands the template back once the session is done
+    ParsedQueryDataPtr cached_template;
+    std::string cache_key;
+    // catalog version the result schema of a cached query is described against
+    uint64_t schema_version = 0;
+    // types of the client's placeholders the catalog could tell from the filters, NA where unknown
+    std::vector<components::types::complex_logical_type> parameter_types;
+
 private:
-    components::sql::transform::transform_result binder_;
+    ParsedQueryData(OtterbrixStatementPtr otterbrix_params,
+                    std::shared_ptr<components::sql::transform::transform_result> binder,
+                    NodeTag tag);
+
+    std::shared_ptr<components::sql::transform::transform_result> binder_;
 };
 
-using ParsedQueryDataPtr = std::unique_ptr<ParsedQueryData>;
+// sql with the literals compared against replaced by $n parameters, values hold the literals in order
+struct parameterized_query_t {
+    std::string sql;
+    std::pmr::vector<components::types::logical_value_t> values;
+};
+
+// nullopt for statements other than queries and for text that already has parameters or quoting it can't tell
+// apart. literals in other places (projections, ORDER BY, LIMIT, typed literals, casts) are kept in the text
+std::optional<parameterized_query_t> parameterize_query(std::pmr::memory_resource* resource, std::string_view sql);
 
 class IParser {
 public:
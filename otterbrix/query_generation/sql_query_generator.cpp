@@ -19,10 +19,20 @@
 #include <components/logical_plan/node_drop_index.hpp>
 #include <components/logical_plan/node_group.hpp>
 #include <components/logical_plan/node_insert.hpp>
+#include <components/logical_plan/node_join.hpp>
+#include <components/logical_plan/node_limit.hpp>
 #include <components/logical_plan/node_match.hpp>
 #include <components/logical_plan/node_sort.hpp>
 #include <components/logical_plan/node_update.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <set>
+#include <sstream>
+
 using namespace components::types;
 using namespace components::logical_plan;
 using namespace components::expressions;
@@ -30,6 +40,9 @@ using namespace components::types;
 
 namespace {
 
+    // single column of the temporary tables built by generate_key_table
+    constexpr std::string_view KEY_TABLE_COLUMN = "k";
+
     template<class OStream>
     OStream& operator<<(OStream& stream, logical_type type) {
         switch (type) {
@@ -82,6 +95,20 @@ namespace {
         return stream;
     }
 
+    // single quotes are a string in every sql_mode, double quotes are an identifier under ANSI_QUOTES.
+    // quotes inside are doubled, a doubled backslash would stay two backslashes under NO_BACKSLASH_ESCAPES
+    template<class OStream>
+    void quote_string(OStream& stream, std::string_view value) {
+        stream << '\'';
+        for (char c : value) {
+            if (c == '\'') {
+                stream << c;
+            }
+            stream << c;
+        }
+        stream << '\'';
+    }
+
     template<class OStream>
     OStream& operator<<(OStream& stream, const components::types::logical_value_t& value) {
         switch (value.type().type()) {
@@ -92,7 +119,8 @@ namespace {
                 stream << (value.value<bool>() ? "TRUE" : "FALSE");
                 break;
             case logical_type::TINYINT:
-                stream << value.value<int8_t>();
+                // widened, a char would be printed as a character
+                stream << static_cast<int32_t>(value.value<int8_t>());
                 break;
             case logical_type::SMALLINT:
                 stream << value.value<int16_t>();
@@ -113,7 +141,7 @@ namespace {
                 stream << value.value<double>();
                 break;
             case logical_type::UTINYINT:
-                stream << value.value<uint8_t>();
+                stream << static_cast<uint32_t>(value.value<uint8_t>());
                 break;
             case logical_type::USMALLINT:
                 stream << value.value<uint16_t>();
@@ -128,7 +156,7 @@ namespace {
                 stream << value.value<components::types::uint128_t>();
                 break;
             case logical_type::STRING_LITERAL:
-                stream << "\"" << *value.value<std::string*>() << "\"";
+                quote_string(stream, *value.value<std::string*>());
                 break;
             case logical_type::STRUCT: {
                 stream << "ROW(";
@@ -163,6 +191,95 @@ namespace {
         return stream;
     }
 
+    // literal of a key value fetched from a backend. floating keys keep every digit, so they load into a key table
+    // column of their own type unchanged. types a key column can't have throw
+    // integers order the same here and on the backend. strings don't under case-insensitive collations,
+    // and printed floating values don't compare equal to the stored ones
+    bool is_ordered_key(logical_type type) {
+        switch (type) {
+            case logical_type::BOOLEAN:
+            case logical_type::TINYINT:
+            case logical_type::SMALLINT:
+            case logical_type::INTEGER:
+            case logical_type::BIGINT:
+            case logical_type::HUGEINT:
+            case logical_type::UTINYINT:
+            case logical_type::USMALLINT:
+            case logical_type::UINTEGER:
+            case logical_type::UBIGINT:
+            case logical_type::UHUGEINT:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // mysql column type of a key table holding keys of the given type, max_length bounds string keys in bytes
+    std::string key_column_type(logical_type type, size_t max_length) {
+        // the longest VARCHAR of 4-byte characters that still fits a row
+        constexpr size_t MAX_VARCHAR_LENGTH = 16383;
+        switch (type) {
+            case logical_type::BOOLEAN:
+                return "BOOLEAN";
+            case logical_type::TINYINT:
+                return "TINYINT";
+            case logical_type::UTINYINT:
+                return "TINYINT UNSIGNED";
+            case logical_type::SMALLINT:
+                return "SMALLINT";
+            case logical_type::USMALLINT:
+                return "SMALLINT UNSIGNED";
+            case logical_type::INTEGER:
+                return "INT";
+            case logical_type::UINTEGER:
+                return "INT UNSIGNED";
+            case logical_type::BIGINT:
+                return "BIGINT";
+            case logical_type::UBIGINT:
+                return "BIGINT UNSIGNED";
+            case logical_type::FLOAT:
+                return "FLOAT";
+            case logical_type::DOUBLE:
+                return "DOUBLE";
+            case logical_type::STRING_LITERAL:
+                if (max_length > MAX_VARCHAR_LENGTH) {
+                    return "TEXT";
+                }
+                return "VARCHAR(" + std::to_string(std::max<size_t>(max_length, 1)) + ")";
+            default:
+                throw std::runtime_error("Encountered an unsupported key table type during query generation");
+        }
+    }
+
+    std::string generate_literal(const logical_value_t& value) {
+        std::stringstream stream;
+        switch (value.type().type()) {
+            case logical_type::FLOAT:
+                stream << std::setprecision(std::numeric_limits<float>::max_digits10) << value.value<float>();
+                break;
+            case logical_type::DOUBLE:
+                stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value.value<double>();
+                break;
+            case logical_type::BOOLEAN:
+            case logical_type::TINYINT:
+            case logical_type::SMALLINT:
+            case logical_type::INTEGER:
+            case logical_type::BIGINT:
+            case logical_type::HUGEINT:
+            case logical_type::UTINYINT:
+            case logical_type::USMALLINT:
+            case logical_type::UINTEGER:
+            case logical_type::UBIGINT:
+            case logical_type::UHUGEINT:
+            case logical_type::STRING_LITERAL:
+                stream << value;
+                break;
+            default:
+                throw std::runtime_error("Encountered an unsupported key type during query generation");
+        }
+        return stream.str();
+    }
+
     void generate_compare_expr(std::stringstream& stream,
                                const compare_expression_ptr& expr,
                                const storage_parameters* parameters) {
@@ -371,18 +488,124 @@ namespace {
         }
     }
 
-    void
-    generate_select(std::stringstream& stream, const node_aggregate_ptr& node, const storage_parameters* parameters) {
+    // scans are aliased by their table name, so keys qualified with it resolve on the backend
+    void generate_join_source(std::stringstream& stream, const node_ptr& node, const storage_parameters* parameters) {
+        if (node->type() != node_type::join_t) {
+            stream << node->collection_full_name().to_string() << " AS " << node->collection_full_name().collection;
+            return;
+        }
+
+        auto join = reinterpret_cast<const node_join_ptr&>(node);
+        generate_join_source(stream, join->children().front(), parameters);
+        switch (join->type()) {
+            case join_type::inner:
+                stream << " JOIN ";
+                break;
+            case join_type::left:
+                stream << " LEFT JOIN ";
+                break;
+            case join_type::right:
+                stream << " RIGHT JOIN ";
+                break;
+            case join_type::cross:
+                stream << " CROSS JOIN ";
+                break;
+            default:
+                throw std::logic_error("unsupported join type for generate_query");
+        }
+        const auto& right = join->children().back();
+        if (right->type() == node_type::join_t) {
+            stream << "(";
+            generate_join_source(stream, right, parameters);
+            stream << ")";
+        } else {
+            generate_join_source(stream, right, parameters);
+        }
+        if (join->type() != join_type::cross && !join->expressions().empty()) {
+            stream << " ON ";
+            bool conjunction = false;
+            for (const auto& expr : join->expressions()) {
+                if (conjunction) {
+                    stream << " AND ";
+                }
+                generate_compare_expr(stream, reinterpret_cast<const compare_expression_ptr&>(expr), parameters);
+                conjunction = true;
+            }
+        }
+    }
+
+    // backends return SUM and AVG of exact types as DECIMAL, convert them to what the schema node promised.
+    // CAST(... AS DOUBLE) is missing from older MySQL and MariaDB, adding a float zero works everywhere
+    std::string
+    cast_to_schema(std::string call, const aggregate_expression_ptr& expr, const complex_logical_type* schema) {
+        if (!schema || (expr->type() != aggregate_type::sum && expr->type() != aggregate_type::avg)) {
+            return call;
+        }
+        for (const auto& field : schema->child_types()) {
+            if (field.alias() != expr->key().as_string()) {
+                continue;
+            }
+            switch (field.type()) {
+                case logical_type::BIGINT:
+                    return "CAST(" + call + " AS SIGNED)";
+                case logical_type::DOUBLE:
+                    return "(" + call + " + 0E0)";
+                default:
+                    return call;
+            }
+        }
+        return call;
+    }
+
+    // grouping keys are the plain columns next to the aggregates, constants are not grouped by
+    std::vector<std::string> group_by_keys(const node_group_ptr& group) {
+        std::vector<std::string> keys;
+        bool has_aggregate = false;
+        for (const auto& expr : group->expressions()) {
+            if (expr->group() == expression_group::aggregate) {
+                has_aggregate = true;
+            } else if (expr->group() == expression_group::scalar) {
+                auto scalar_expr = reinterpret_cast<const scalar_expression_ptr&>(expr);
+                if (scalar_expr->params().empty()) {
+                    keys.emplace_back(scalar_expr->key().as_string());
+                } else if (std::holds_alternative<components::expressions::key_t>(scalar_expr->params().front())) {
+                    keys.emplace_back(
+                        std::get<components::expressions::key_t>(scalar_expr->params().front()).as_string());
+                }
+            }
+        }
+        if (!has_aggregate) {
+            keys.clear();
+        }
+        return keys;
+    }
+
+    void generate_select(std::stringstream& stream,
+                         const node_aggregate_ptr& node,
+                         const storage_parameters* parameters,
+                         const complex_logical_type* schema,
+                         std::string_view filter) {
         node_group_ptr group = nullptr;
         node_match_ptr match = nullptr;
         node_sort_ptr sort = nullptr;
+        node_limit_ptr limit = nullptr;
+        node_ptr join = nullptr;
+        // a HAVING or any other child left out of the query filters rows after the backend limited them
+        bool translated = true;
         for (const auto& child : node->children()) {
-            if (child->type() == node_type::group_t) {
+            if (child->type() == node_type::join_t) {
+                join = child;
+            } else if (child->type() == node_type::group_t) {
                 group = reinterpret_cast<const node_group_ptr&>(child);
             } else if (child->type() == node_type::match_t) {
+                translated = translated && !match;
                 match = reinterpret_cast<const node_match_ptr&>(child);
             } else if (child->type() == node_type::sort_t) {
                 sort = reinterpret_cast<const node_sort_ptr&>(child);
+            } else if (child->type() == node_type::limit_t) {
+                limit = reinterpret_cast<const node_limit_ptr&>(child);
+            } else {
+                translated = false;
             }
         }
         stream << "SELECT ";
@@ -394,29 +617,33 @@ namespace {
                     switch (expr->group()) {
                         case expression_group::aggregate: {
                             auto agg_expr = reinterpret_cast<const aggregate_expression_ptr&>(expr);
+                            std::string call;
                             switch (agg_expr->type()) {
                                 case aggregate_type::count:
-                                    fields.emplace_back("COUNT(");
+                                    call = "COUNT(";
                                     break;
                                 case aggregate_type::sum:
-                                    fields.emplace_back("SUM(");
+                                    call = "SUM(";
                                     break;
                                 case aggregate_type::min:
-                                    fields.emplace_back("MIN(");
+                                    call = "MIN(";
                                     break;
                                 case aggregate_type::max:
-                                    fields.emplace_back("MAX(");
+                                    call = "MAX(";
                                     break;
                                 case aggregate_type::avg:
-                                    fields.emplace_back("AVG(");
+                                    call = "AVG(";
                                     break;
                             }
                             if (agg_expr->params().empty()) {
-                                fields.back().append(agg_expr->key().as_string() + ")");
+                                call.append(agg_expr->key().as_string() + ")");
+                                fields.emplace_back(cast_to_schema(std::move(call), agg_expr, schema));
                             } else {
-                                fields.back().append(
+                                call.append(
                                     std::get<components::expressions::key_t>(agg_expr->params().front()).as_string() +
-                                    ") AS " + agg_expr->key().as_string());
+                                    ")");
+                                fields.emplace_back(cast_to_schema(std::move(call), agg_expr, schema) + " AS " +
+                                                    agg_expr->key().as_string());
                             }
                             break;
                         }
@@ -463,21 +690,48 @@ namespace {
                 stream << "*";
             }
             stream << " FROM ";
-            stream << node->collection_full_name().to_string();
+            if (join) {
+                // join of scans behind one connection
+                generate_join_source(stream, join, parameters);
+            } else {
+                // a single table is aliased like a scan of a join, filters pushed below a join keep their keys
+                generate_join_source(stream, node, parameters);
+            }
         }
         // where
         {
-            if (match) {
+            if (match || !filter.empty()) {
                 stream << " WHERE ";
+            }
+            if (match) {
                 generate_compare_expr(stream,
                                       reinterpret_cast<const compare_expression_ptr&>(match->expressions().front()),
                                       parameters);
+                if (!filter.empty()) {
+                    stream << " AND ";
+                }
             }
+            stream << filter;
         }
         // group by
         {
+            if (group) {
+                auto keys = group_by_keys(group);
+                if (!keys.empty()) {
+                    stream << " GROUP BY ";
+                    bool comma = false;
+                    for (const auto& key : keys) {
+                        if (comma) {
+                            stream << ", ";
+                        }
 
-        } // order by
+                        stream << key;
+                        comma = true;
+                    }
+                }
+            }
+        }
+        // order by
         {
             if (sort) {
                 stream << " ORDER BY ";
@@ -493,6 +747,12 @@ namespace {
                 }
             }
         }
+        // limit, together with order by the backend only returns the top rows
+        {
+            if (limit && translated && limit->limit().limit() >= 0) {
+                stream << " LIMIT " << limit->limit().limit();
+            }
+        }
     }
 
     void generate_create_collection(std::stringstream& stream, const node_create_collection_ptr& node) {
@@ -593,7 +853,11 @@ namespace {
             assert(node->children().front()->type() == node_type::aggregate_t);
             assert(node->collection_full_name().unique_identifier ==
                    node->children().front()->collection_full_name().unique_identifier);
-            generate_select(stream, reinterpret_cast<const node_aggregate_ptr&>(node->children().front()), parameters);
+            generate_select(stream,
+                            reinterpret_cast<const node_aggregate_ptr&>(node->children().front()),
+                            parameters,
+                            nullptr,
+                            {});
         }
     }
 
@@ -653,10 +917,14 @@ namespace sql_gen {
         }
     }
 
-    void generate_query(std::stringstream& stream, const node_ptr& node, const storage_parameters* parameters) {
+    void generate_query(std::stringstream& stream,
+                        const node_ptr& node,
+                        const storage_parameters* parameters,
+                        const complex_logical_type* schema,
+                        std::string_view filter) {
         switch (node->type()) {
             case node_type::aggregate_t:
-                generate_select(stream, reinterpret_cast<const node_aggregate_ptr&>(node), parameters);
+                generate_select(stream, reinterpret_cast<const node_aggregate_ptr&>(node), parameters, schema, filter);
                 break;
             case node_type::create_collection_t:
                 generate_create_collection(stream, reinterpret_cast<const node_create_collection_ptr&>(node));
@@ -690,11 +958,161 @@ namespace sql_gen {
         }
     }
 
-    std::string generate_query(const node_ptr& node, const storage_parameters* parameters) {
+    std::string generate_query(const node_ptr& node,
+                               const storage_parameters* parameters,
+                               const complex_logical_type* schema,
+                               std::string_view filter) {
         std::stringstream stream;
-        generate_query(stream, node, parameters);
+        generate_query(stream, node, parameters, schema, filter);
         stream << ";";
         return stream.str();
     }
 
-} // namespace sql_gen
\ No newline at end of file
+    std::string generate_key_filter(std::string_view key,
+                                    const components::vector::data_chunk_t& chunk,
+                                    size_t column,
+                                    size_t max_in_list) {
+        const auto type = chunk.types()[column].type();
+        const bool ordered = is_ordered_key(type);
+        std::set<std::string> distinct;
+        std::optional<logical_value_t> min;
+        std::optional<logical_value_t> max;
+        for (size_t row = 0; row < chunk.size(); ++row) {
+            auto value = chunk.value(column, row);
+            if (value.type().type() == logical_type::NA) {
+                // NULL never matches in an inner join
+                continue;
+            }
+            if (ordered && (!min || value < *min)) {
+                min = value;
+            }
+            if (ordered && (!max || *max < value)) {
+                max = value;
+            }
+            if (distinct.size() <= max_in_list) {
+                distinct.insert(generate_literal(value));
+            }
+        }
+
+        std::stringstream stream;
+        if (distinct.empty()) {
+            stream << "1 = 0";
+        } else if (type == logical_type::FLOAT || type == logical_type::DOUBLE) {
+            // no literal matches a floating key exactly, the target is read unfiltered
+            return {};
+        } else if (distinct.size() <= max_in_list) {
+            stream << key << " IN (";
+            bool comma = false;
+            for (const auto& value : distinct) {
+                if (comma) {
+                    stream << ", ";
+                }
+
+                stream << value;
+                comma = true;
+            }
+            stream << ")";
+        } else if (ordered) {
+            stream << "(" << key << " >= " << generate_literal(*min) << " AND " << key
+                   << " <= " << generate_literal(*max) << ")";
+        } else {
+            // the bounds of a string range depend on the target's collation
+            return {};
+        }
+        return stream.str();
+    }
+
+    std::vector<std::string> generate_key_table(std::string_view table,
+                                                const components::vector::data_chunk_t& chunk,
+                                                size_t column,
+                                                size_t rows_per_insert) {
+        const auto type = chunk.types()[column].type();
+        std::set<std::string> distinct;
+        size_t max_length = 0;
+        for (size_t row = 0; row < chunk.size(); ++row) {
+            auto value = chunk.value(column, row);
+            if (value.type().type() == logical_type::NA) {
+                continue;
+            }
+            if (type == logical_type::STRING_LITERAL) {
+                max_length = std::max(max_length, value.value<std::string*>()->size());
+            }
+            distinct.insert(generate_literal(value));
+        }
+
+        std::vector<std::string> statements;
+        std::stringstream create;
+        create << "CREATE TEMPORARY TABLE " << table << " (" << KEY_TABLE_COLUMN << " "
+               << key_column_type(type, max_length) << ");";
+        statements.emplace_back(create.str());
+
+        rows_per_insert = std::max<size_t>(rows_per_insert, 1);
+        auto it = distinct.begin();
+        while (it != distinct.end()) {
+            std::stringstream insert;
+            insert << "INSERT INTO " << table << " VALUES ";
+            for (size_t i = 0; i < rows_per_insert && it != distinct.end(); ++i, ++it) {
+                if (i != 0) {
+                    insert << ", ";
+                }
+                insert << "(" << *it << ")";
+            }
+            insert << ";";
+            statements.emplace_back(insert.str());
+        }
+        return statements;
+    }
+
+    std::string generate_key_table_filter(std::string_view key, std::string_view table) {
+        std::stringstream stream;
+        stream << key << " IN (SELECT " << KEY_TABLE_COLUMN << " FROM " << table << ")";
+        return stream.str();
+    }
+
+    std::string generate_drop_key_table(std::string_view table) {
+        std::stringstream stream;
+        stream << "DROP TEMPORARY TABLE IF EXISTS " << table << ";";
+        return stream.str();
+    }
+
+    std::string normalize_query(std::string_view query) {
+        auto is_identifier = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+        std::string shape;
+        shape.reserve(query.size());
+        size_t i = 0;
+        while (i < query.size()) {
+            const char c = query[i];
+            if (c == '\'' || c == '"') {
+                // quotes are escaped by doubling or with a backslash
+                ++i;
+                while (i < query.size()) {
+                    if (query[i] == '\\') {
+                        i += 2;
+                    } else if (query[i] == c && i + 1 < query.size() && query[i + 1] == c) {
+                        i += 2;
+                    } else if (query[i] == c) {
+                        ++i;
+                        break;
+                    } else {
+                        ++i;
+                    }
+                }
+            } else if (std::isdigit(static_cast<unsigned char>(c)) && (shape.empty() || !is_identifier(shape.back()))) {
+                while (i < query.size() && (is_identifier(query[i]) || query[i] == '.')) {
+                    ++i;
+                }
+            } else {
+                shape += c;
+                ++i;
+                continue;
+            }
+
+            shape += '?';
+            if (std::string_view(shape).ends_with("?, ?")) {
+                shape.resize(shape.size() - 3);
+            }
+        }
+        return shape;
+    }
+
+} // namespace sql_gen
@@ -9,13 +9,45 @@
 #include <components/types/types.hpp>
 #include <components/vector/data_chunk.hpp>
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace sql_gen {
 
     void generate_values(std::stringstream& stream, const components::vector::data_chunk_t& chunk);
+    // schema is the struct the result is expected in, aggregates pushed to the backend are cast to it.
+    // filter is an extra SQL condition and-ed to the WHERE clause of a select
     void generate_query(std::stringstream& stream,
                         const components::logical_plan::node_ptr& node,
-                        const components::logical_plan::storage_parameters* parameters);
+                        const components::logical_plan::storage_parameters* parameters,
+                        const components::types::complex_logical_type* schema = nullptr,
+                        std::string_view filter = {});
     std::string generate_query(const components::logical_plan::node_ptr& node,
-                               const components::logical_plan::storage_parameters* parameters);
+                               const components::logical_plan::storage_parameters* parameters,
+                               const components::types::complex_logical_type* schema = nullptr,
+                               std::string_view filter = {});
+
+    // condition restricting key to the distinct values of a chunk column: an IN-list of up to max_in_list values,
+    // a min/max range of integer keys above that. empty when the keys can't be matched exactly: floating keys, or
+    // too many string keys
+    std::string generate_key_filter(std::string_view key,
+                                    const components::vector::data_chunk_t& chunk,
+                                    size_t column,
+                                    size_t max_in_list);
+
+    // session temporary table holding the distinct values of a chunk column: a CREATE TEMPORARY TABLE statement
+    // followed by multi-row INSERTs of up to rows_per_insert values each
+    std::vector<std::string> generate_key_table(std::string_view table,
+                                                const components::vector::data_chunk_t& chunk,
+                                                size_t column,
+                                                size_t rows_per_insert);
+    // condition restricting key to the values loaded by generate_key_table
+    std::string generate_key_table_filter(std::string_view key, std::string_view table);
+    std::string generate_drop_key_table(std::string_view table);
+
+    // shape of a generated query: numbers and quoted strings become ?, lists of them collapse to a single ?,
+    // so queries differing only in literals or IN-list length share a shape
+    std::string normalize_query(std::string_view query);
 
 } // namespace sql_gen
\ No newline at end of file
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "arrow_to_value.hpp"
+
+#include <string>
+
+using namespace components;
+using namespace components::types;
+
+namespace tsl {
+    namespace {
+        template<typename ArrayType>
+        const ArrayType& as(const arrow::Array& array) {
+            return static_cast<const ArrayType&>(array);
+        }
+    } // namespace
+
+    arrow::Result<logical_value_t> arrow_to_value(const arrow::Array& array, int64_t row) {
+        if (array.IsNull(row)) {
+            return logical_value_t(nullptr);
+        }
+
+        switch (array.type_id()) {
+            case arrow::Type::NA:
+                return logical_value_t(nullptr);
+            case arrow::Type::BOOL:
+                return logical_value_t(as<arrow::BooleanArray>(array).Value(row));
+            case arrow::Type::INT8:
+                return logical_value_t(as<arrow::Int8Array>(array).Value(row));
+            case arrow::Type::UINT8:
+                return logical_value_t(as<arrow::UInt8Array>(array).Value(row));
+            case arrow::Type::INT16:
+                return logical_value_t(as<arrow::Int16Array>(array).Value(row));
+            case arrow::Type::UINT16:
+                return logical_value_t(as<arrow::UInt16Array>(array).Value(row));
+            case arrow::Type::INT32:
+                return logical_value_t(as<arrow::Int32Array>(array).Value(row));
+            case arrow::Type::UINT32:
+                return logical_value_t(as<arrow::UInt32Array>(array).Value(row));
+            case arrow::Type::INT64:
+                return logical_value_t(as<arrow::Int64Array>(array).Value(row));
+            case arrow::Type::UINT64:
+                return logical_value_t(as<arrow::UInt64Array>(array).Value(row));
+            case arrow::Type::FLOAT:
+                return logical_value_t(as<arrow::FloatArray>(array).Value(row));
+            case arrow::Type::DOUBLE:
+                return logical_value_t(as<arrow::DoubleArray>(array).Value(row));
+            case arrow::Type::STRING:
+                return logical_value_t(std::string(as<arrow::StringArray>(array).GetView(row)));
+            case arrow::Type::LARGE_STRING:
+                return logical_value_t(std::string(as<arrow::LargeStringArray>(array).GetView(row)));
+            case arrow::Type::STRING_VIEW:
+                return logical_value_t(std::string(as<arrow::StringViewArray>(array).GetView(row)));
+            default:
+                return arrow::Status::NotImplemented("Unsupported parameter type: " + array.type()->ToString());
+        }
+    }
+
+    arrow::Result<std::vector<std::pmr::vector<logical_value_t>>>
+    arrow_to_parameter_sets(std::pmr::memory_resource* resource, const arrow::RecordBatch& batch) {
+        std::vector<std::pmr::vector<logical_value_t>> sets;
+        sets.reserve(static_cast<size_t>(batch.num_rows()));
+        for (int64_t row = 0; row < batch.num_rows(); ++row) {
+            std::pmr::vector<logical_value_t> values(resource);
+            values.reserve(static_cast<size_t>(batch.num_columns()));
+            for (int column = 0; column < batch.num_columns(); ++column) {
+                ARROW_ASSIGN_OR_RAISE(auto value, arrow_to_value(*batch.column(column), row));
+                values.push_back(std::move(value));
+            }
+            sets.push_back(std::move(values));
+        }
+        return sets;
+    }
+} // namespace tsl
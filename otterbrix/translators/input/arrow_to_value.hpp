@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include <arrow/api.h>
+#include <components/types/types.hpp>
+
+#include <memory_resource>
+#include <vector>
+
+namespace tsl {
+    // value of one cell, NotImplemented for arrow types without a scalar counterpart
+    arrow::Result<components::types::logical_value_t> arrow_to_value(const arrow::Array& array, int64_t row);
+    // every row of the batch becomes one set of statement parameters, columns in parameter order
+    arrow::Result<std::vector<std::pmr::vector<components::types::logical_value_t>>>
+    arrow_to_parameter_sets(std::pmr::memory_resource* resource, const arrow::RecordBatch& batch);
+} // namespace tsl
@@ -6,169 +6,28 @@
 namespace tsl {
 
     namespace impl {
-        using rows_to_otterbrix = std::function<void(data_chunk_t&, const boost::mysql::rows_view&, size_t, size_t)>;
-
-        bool is_signed_int(const boost::mysql::row_view& row, size_t index) {
-            const auto row_kind = row.at(index).kind();
-            switch (row_kind) {
-                case boost::mysql::field_kind::uint64:
-                    return false;
-                case boost::mysql::field_kind::int64:
-                    return true;
-                default:
-                    return true;
-            }
-        }
-
-        void set_int8(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<int8_t>(rows.at(row_index).at(column_index).as_int64())});
-        }
-
-        void
-        set_int16(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<int16_t>(rows.at(row_index).at(column_index).as_int64())});
-        }
-
-        void
-        set_int32(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<int32_t>(rows.at(row_index).at(column_index).as_int64())});
-        }
-
-        void
-        set_int64(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<int64_t>(rows.at(row_index).at(column_index).as_int64())});
-        }
-
-        void
-        set_uint8(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<uint8_t>(rows.at(row_index).at(column_index).as_uint64())});
-        }
-
-        void
-        set_uint16(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<uint16_t>(rows.at(row_index).at(column_index).as_uint64())});
-        }
-
-        void
-        set_uint32(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<uint32_t>(rows.at(row_index).at(column_index).as_uint64())});
-        }
-
-        void
-        set_uint64(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(
-                column_index,
-                row_index,
-                types::logical_value_t{static_cast<uint64_t>(rows.at(row_index).at(column_index).as_uint64())});
-        }
-
-        void
-        set_float(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(column_index,
-                            row_index,
-                            types::logical_value_t{rows.at(row_index).at(column_index).as_float()});
-        }
-
-        void
-        set_double(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(column_index,
-                            row_index,
-                            types::logical_value_t{rows.at(row_index).at(column_index).as_double()});
-        }
-
-        void set_bit(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
-            }
-            chunk.set_value(column_index,
-                            row_index,
-                            types::logical_value_t{rows.at(row_index).at(column_index).as_uint64()});
-        }
-
-        void
-        set_string(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
+        void append_string(vector_t& vec, size_t index, std::string_view value) {
+            if (!vec.auxiliary()) {
+                vec.set_auxiliary(std::make_shared<string_vector_buffer_t>(vec.resource()));
             }
-            chunk.set_value(column_index,
-                            row_index,
-                            types::logical_value_t{std::string(rows.at(row_index).at(column_index).as_string())});
+            auto* heap = static_cast<string_vector_buffer_t*>(vec.auxiliary().get());
+            auto* ptr = static_cast<const char*>(heap->insert(const_cast<char*>(value.data()), value.size()));
+            vec.data<std::string_view>()[index] = std::string_view(ptr, value.size());
         }
 
-        void set_blob(data_chunk_t& chunk, const boost::mysql::rows_view& rows, size_t row_index, size_t column_index) {
-            if (rows.at(row_index).at(column_index).kind() == boost::mysql::field_kind::null) {
-                chunk.set_value(column_index, row_index, types::logical_value_t{nullptr});
-                return;
+        size_t field_bytes(boost::mysql::field_view field) noexcept {
+            if (field.is_string()) {
+                return field.get_string().size();
+            } else if (field.is_blob()) {
+                return field.get_blob().size();
+            } else if (!field.is_null()) {
+                return sizeof(int64_t);
             }
-            auto blob = rows.at(row_index).at(column_index).as_blob();
-            chunk.set_value(column_index, row_index, types::logical_value_t{std::string(blob.begin(), blob.end())});
+            return 0;
         }
 
         struct value_translator_t {
-            rows_to_otterbrix conversion_func;
+            column_decoder_t decoder;
             types::complex_logical_type type;
         };
 
@@ -177,62 +36,62 @@ namespace tsl {
                 case boost::mysql::column_type::tinyint: {
                     if (is_signed) {
                         // spdlog::debug("Set int8 handler");
-                        return {set_int8, {types::logical_type::TINYINT, column.column_name()}};
+                        return {column_decoder_t::int8, {types::logical_type::TINYINT, column.column_name()}};
                     } else {
                         // spdlog::debug("Set uint8 handler");
-                        return {set_uint8, {types::logical_type::UTINYINT, column.column_name()}};
+                        return {column_decoder_t::uint8, {types::logical_type::UTINYINT, column.column_name()}};
                     }
                 }
                 case boost::mysql::column_type::smallint: {
                     if (is_signed) {
                         // spdlog::debug("Set int16 handler");
-                        return {set_int16, {types::logical_type::SMALLINT, column.column_name()}};
+                        return {column_decoder_t::int16, {types::logical_type::SMALLINT, column.column_name()}};
                     } else {
                         // spdlog::debug("Set uint16 handler");
-                        return {set_uint16, {types::logical_type::USMALLINT, column.column_name()}};
+                        return {column_decoder_t::uint16, {types::logical_type::USMALLINT, column.column_name()}};
                     }
                 }
                 case boost::mysql::column_type::mediumint: {
                     if (is_signed) {
                         // spdlog::debug("Set int32 handler");
-                        return {set_int32, {types::logical_type::INTEGER, column.column_name()}};
+                        return {column_decoder_t::int32, {types::logical_type::INTEGER, column.column_name()}};
                     } else {
                         // spdlog::debug("Set uint32 handler");
-                        return {set_uint32, {types::logical_type::UINTEGER, column.column_name()}};
+                        return {column_decoder_t::uint32, {types::logical_type::UINTEGER, column.column_name()}};
                     }
                 }
                 case boost::mysql::column_type::bigint:
                 case boost::mysql::column_type::int_: {
                     if (is_signed) {
                         // spdlog::debug("Set int64 handler");
-                        return {set_int64, {types::logical_type::BIGINT, column.column_name()}};
+                        return {column_decoder_t::int64, {types::logical_type::BIGINT, column.column_name()}};
                     } else {
                         // spdlog::debug("Set uint64 handler");
-                        return {set_uint64, {types::logical_type::UBIGINT, column.column_name()}};
+                        return {column_decoder_t::uint64, {types::logical_type::UBIGINT, column.column_name()}};
                     }
                 }
                 case boost::mysql::column_type::bit: {
                     // spdlog::debug("Set bit handler");
-                    return {set_bit, {types::logical_type::BOOLEAN, column.column_name()}};
+                    return {column_decoder_t::bit, {types::logical_type::BOOLEAN, column.column_name()}};
                 }
                 case boost::mysql::column_type::float_: {
                     // spdlog::debug("Set float handler");
-                    return {set_float, {types::logical_type::FLOAT, column.column_name()}};
+                    return {column_decoder_t::float32, {types::logical_type::FLOAT, column.column_name()}};
                 }
                 case boost::mysql::column_type::double_: {
                     // spdlog::debug("Set double handler");
-                    return {set_double, {types::logical_type::DOUBLE, column.column_name()}};
+                    return {column_decoder_t::float64, {types::logical_type::DOUBLE, column.column_name()}};
                 }
                 case boost::mysql::column_type::decimal:
                 case boost::mysql::column_type::text:
                 case boost::mysql::column_type::char_:
                 case boost::mysql::column_type::varchar: {
                     // spdlog::debug("Set string handler");
-                    return {set_string, {types::logical_type::STRING_LITERAL, column.column_name()}};
+                    return {column_decoder_t::string, {types::logical_type::STRING_LITERAL, column.column_name()}};
                 }
                 case boost::mysql::column_type::blob: {
                     // spdlog::debug("Set blob handler");
-                    return {set_blob, {types::logical_type::STRING_LITERAL, column.column_name()}};
+                    return {column_decoder_t::blob, {types::logical_type::STRING_LITERAL, column.column_name()}};
                 }
                 default: {
                     std::stringstream oss;
@@ -244,47 +103,82 @@ namespace tsl {
 
     } // namespace impl
 
-    // callback to handle mysql results
-    data_chunk_t mysql_to_chunk(std::pmr::memory_resource* resource, const boost::mysql::results& result) {
-        const auto& metadata = result.meta();
-
-        const auto ncolumns = result.rows().num_columns();
-        const auto nrows = result.rows().size();
-        // spdlog::debug("nrows: {}", nrows);
-        // spdlog::debug("ncolumns: {}", ncolumns);
+    mysql_chunk_stream_t::mysql_chunk_stream_t(std::pmr::memory_resource* resource,
+                                               size_t chunk_rows,
+                                               size_t expected_rows)
+        : resource_(resource)
+        , chunk_rows_(std::max<size_t>(chunk_rows, 1))
+        , first_chunk_rows_(std::max(chunk_rows_, expected_rows))
+        , types_(resource) {}
+
+    void mysql_chunk_stream_t::resolve(const boost::mysql::metadata_collection_view& metadata) {
+        std::vector<impl::column_decoder_t> decoders;
+        std::pmr::vector<types::complex_logical_type> types(resource_);
+        decoders.reserve(metadata.size());
+        types.reserve(metadata.size());
+        for (const auto& column : metadata) {
+            // signedness comes from column metadata, so empty results resolve the same way as full ones
+            auto translator = impl::to_local_translator(column, !column.is_unsigned());
+            decoders.emplace_back(translator.decoder);
+            types.emplace_back(std::move(translator.type));
+        }
+        resolve(std::move(decoders), std::move(types));
+    }
 
-        std::pmr::vector<impl::value_translator_t> translators(resource);
-        std::pmr::vector<types::complex_logical_type> types(resource);
-        translators.reserve(ncolumns);
-        types.reserve(ncolumns);
+    void mysql_chunk_stream_t::resolve(std::vector<impl::column_decoder_t> decoders,
+                                       std::pmr::vector<types::complex_logical_type> types) {
+        assert(decoders.size() == types.size());
+        decoders_ = std::move(decoders);
+        types_ = std::move(types);
+        resolved_ = true;
+    }
 
-        // spdlog::debug("Schema Information:");
-        size_t counter = 0;
-        // simple wrapper to check if the data is signed
-        auto is_signed = [&](size_t index) {
-            return nrows > 0 ? impl::is_signed_int(result.rows().at(0), counter) : true;
-        };
-        // spdlog::debug("Collecting schema information");
-        for (const auto& column : metadata) {
-            // spdlog::debug("column.database(): {}", column.database());
-            // spdlog::debug("column.column_name(): {}", column.column_name());
-            // spdlog::debug("column.original_column_name(): {}", column.original_column_name());
+    void mysql_chunk_stream_t::append(const boost::mysql::metadata_collection_view& metadata,
+                                      const boost::mysql::rows_view& rows) {
+        if (!resolved_) {
+            resolve(metadata);
+        }
+        // rows_view is only valid until the next read, so the rows are decoded right away
+        append_rows(rows);
+    }
 
-            // In case where the rows is empty we assume that the numeric data is signed
-            translators.emplace_back(impl::to_local_translator(column, is_signed(counter)));
-            types.emplace_back(translators.back().type);
+    data_chunk_t& mysql_chunk_stream_t::open_chunk() {
+        if (chunks_.empty() || chunks_.back()->size() >= capacity(chunks_.size() - 1)) {
+            chunks_.push_back(std::make_unique<data_chunk_t>(resource_, types_, capacity(chunks_.size())));
         }
+        return *chunks_.back();
+    }
 
-        data_chunk_t chunk(resource, types, nrows);
-        chunk.set_cardinality(nrows);
+    std::vector<std::unique_ptr<data_chunk_t>> mysql_chunk_stream_t::finish() {
+        if (chunks_.empty()) {
+            chunks_.push_back(std::make_unique<data_chunk_t>(resource_, types_, 0));
+        }
+        return std::move(chunks_);
+    }
 
-        // spdlog::debug("Converting mysql rows to otterbrix data chunk");
-        for (size_t i = 0; i < nrows; i++) {
-            for (size_t j = 0; j < ncolumns; j++) {
-                translators.at(j).conversion_func(chunk, result.rows(), i, j);
-            }
+    std::unique_ptr<data_chunk_t> concat_chunks(std::pmr::memory_resource* resource,
+                                                std::vector<std::unique_ptr<data_chunk_t>> chunks) {
+        assert(!chunks.empty());
+        if (chunks.size() == 1) {
+            return std::move(chunks.front());
+        }
+        size_t total = 0;
+        for (const auto& chunk : chunks) {
+            total += chunk->size();
         }
-        return chunk;
+        auto result = std::make_unique<data_chunk_t>(resource, chunks.front()->types(), total);
+        for (auto& chunk : chunks) {
+            result->append(*chunk, true);
+            chunk.reset();
+        }
+        return result;
+    }
+
+    // callback to handle mysql results
+    data_chunk_t mysql_to_chunk(std::pmr::memory_resource* resource, const boost::mysql::results& result) {
+        mysql_chunk_stream_t stream(resource);
+        stream.append(result.meta(), result.rows());
+        return std::move(*concat_chunks(resource, stream.finish()));
     }
 
     std::optional<std::pmr::vector<types::complex_logical_type>>
@@ -13,15 +13,206 @@
 
 #include <boost/mysql.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <exception>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 using namespace components::vector;
 using namespace components;
 
 namespace tsl {
 
+    namespace impl {
+        // storage layout of one result column, picked once per query
+        enum class column_decoder_t : uint8_t
+        {
+            int8,
+            int16,
+            int32,
+            int64,
+            uint8,
+            uint16,
+            uint32,
+            uint64,
+            float32,
+            float64,
+            bit,
+            string,
+            blob
+        };
+
+        // string payload goes to the vector's string heap, the slot keeps a view into it
+        void append_string(vector_t& vec, size_t index, std::string_view value);
+        // string and blob lengths, 8 bytes for any other non-NULL value
+        size_t field_bytes(boost::mysql::field_view field) noexcept;
+
+        // Rows is anything with rows[i][column] -> field_view, so rows_view and plain containers decode alike.
+        // rows [begin, begin + count) are written to vec starting at offset
+        template<typename T, typename Rows, typename Getter>
+        void decode_fixed(vector_t& vec,
+                          const Rows& rows,
+                          size_t column,
+                          size_t begin,
+                          size_t count,
+                          size_t offset,
+                          Getter get) {
+            auto* out = vec.data<T>();
+            for (size_t i = 0; i < count; ++i) {
+                const boost::mysql::field_view field = rows[begin + i][column];
+                if (field.is_null()) {
+                    vec.set_null(offset + i, true);
+                    continue;
+                }
+                out[offset + i] = static_cast<T>(get(field));
+            }
+        }
+
+        template<typename Rows, typename Getter>
+        void decode_strings(vector_t& vec,
+                            const Rows& rows,
+                            size_t column,
+                            size_t begin,
+                            size_t count,
+                            size_t offset,
+                            Getter get) {
+            for (size_t i = 0; i < count; ++i) {
+                const boost::mysql::field_view field = rows[begin + i][column];
+                if (field.is_null()) {
+                    vec.set_null(offset + i, true);
+                    continue;
+                }
+                append_string(vec, offset + i, get(field));
+            }
+        }
+
+        template<typename Rows>
+        void decode_column(column_decoder_t decoder,
+                           vector_t& vec,
+                           const Rows& rows,
+                           size_t column,
+                           size_t begin,
+                           size_t count,
+                           size_t offset) {
+            using boost::mysql::field_view;
+            // types are known up front, so the field accessors skip the kind checks
+            auto as_int = [](const field_view& f) { return f.get_int64(); };
+            auto as_uint = [](const field_view& f) { return f.get_uint64(); };
+            auto as_float = [](const field_view& f) { return f.get_float(); };
+            auto as_double = [](const field_view& f) { return f.get_double(); };
+            auto as_bit = [](const field_view& f) { return f.get_uint64() != 0; };
+            switch (decoder) {
+                case column_decoder_t::int8:
+                    return decode_fixed<int8_t>(vec, rows, column, begin, count, offset, as_int);
+                case column_decoder_t::int16:
+                    return decode_fixed<int16_t>(vec, rows, column, begin, count, offset, as_int);
+                case column_decoder_t::int32:
+                    return decode_fixed<int32_t>(vec, rows, column, begin, count, offset, as_int);
+                case column_decoder_t::int64:
+                    return decode_fixed<int64_t>(vec, rows, column, begin, count, offset, as_int);
+                case column_decoder_t::uint8:
+                    return decode_fixed<uint8_t>(vec, rows, column, begin, count, offset, as_uint);
+                case column_decoder_t::uint16:
+                    return decode_fixed<uint16_t>(vec, rows, column, begin, count, offset, as_uint);
+                case column_decoder_t::uint32:
+                    return decode_fixed<uint32_t>(vec, rows, column, begin, count, offset, as_uint);
+                case column_decoder_t::uint64:
+                    return decode_fixed<uint64_t>(vec, rows, column, begin, count, offset, as_uint);
+                case column_decoder_t::float32:
+                    return decode_fixed<float>(vec, rows, column, begin, count, offset, as_float);
+                case column_decoder_t::float64:
+                    return decode_fixed<double>(vec, rows, column, begin, count, offset, as_double);
+                case column_decoder_t::bit:
+                    return decode_fixed<bool>(vec, rows, column, begin, count, offset, as_bit);
+                case column_decoder_t::string:
+                    return decode_strings(vec, rows, column, begin, count, offset, [](const field_view& f) {
+                        return f.get_string();
+                    });
+                case column_decoder_t::blob:
+                    return decode_strings(vec, rows, column, begin, count, offset, [](const field_view& f) {
+                        auto blob = f.get_blob();
+                        return std::string_view(reinterpret_cast<const char*>(blob.data()), blob.size());
+                    });
+            }
+        }
+    } // namespace impl
+
+    // decodes rows read with read_some_rows into chunks of at most chunk_rows rows. every chunk is allocated once
+    // at full capacity, so peak memory is the decoded rows plus one open chunk, never a reallocated copy.
+    // with expected_rows the first chunk takes that many rows, a result that fits it never has to be joined
+    class mysql_chunk_stream_t {
+    public:
+        static constexpr size_t DEFAULT_CHUNK_ROWS = 8192;
+
+        explicit mysql_chunk_stream_t(std::pmr::memory_resource* resource,
+                                      size_t chunk_rows = DEFAULT_CHUNK_ROWS,
+                                      size_t expected_rows = 0);
+
+        void append(const boost::mysql::metadata_collection_view& metadata, const boost::mysql::rows_view& rows);
+        // for row sources without mysql metadata, the column layout is given up front
+        void resolve(std::vector<impl::column_decoder_t> decoders,
+                     std::pmr::vector<types::complex_logical_type> types);
+        // Rows as in impl::decode_column, the stream must be resolved
+        template<typename Rows>
+        void append_rows(const Rows& rows);
+        // chunks in arrival order, an empty result still yields one empty chunk with the column types
+        std::vector<std::unique_ptr<data_chunk_t>> finish();
+
+        size_t size() const noexcept { return rows_; }
+        size_t batches() const noexcept { return batches_; }
+        size_t chunk_rows() const noexcept { return chunk_rows_; }
+        // payload received so far, see impl::field_bytes
+        size_t bytes() const noexcept { return bytes_; }
+
+    private:
+        void resolve(const boost::mysql::metadata_collection_view& metadata);
+        // last chunk if it has room, a new one otherwise
+        data_chunk_t& open_chunk();
+        size_t capacity(size_t chunk) const noexcept { return chunk == 0 ? first_chunk_rows_ : chunk_rows_; }
+
+        std::pmr::memory_resource* resource_;
+        size_t chunk_rows_;
+        size_t first_chunk_rows_;
+        std::pmr::vector<types::complex_logical_type> types_;
+        std::vector<impl::column_decoder_t> decoders_;
+        std::vector<std::unique_ptr<data_chunk_t>> chunks_;
+        size_t rows_ = 0;
+        size_t batches_ = 0;
+        size_t bytes_ = 0;
+        bool resolved_ = false;
+    };
+
+    template<typename Rows>
+    void mysql_chunk_stream_t::append_rows(const Rows& rows) {
+        assert(resolved_);
+        const size_t nrows = rows.size();
+        for (size_t begin = 0; begin < nrows;) {
+            auto& chunk = open_chunk();
+            const size_t offset = chunk.size();
+            const size_t count = std::min(nrows - begin, capacity(chunks_.size() - 1) - offset);
+            for (size_t j = 0; j < decoders_.size(); ++j) {
+                impl::decode_column(decoders_[j], chunk.data[j], rows, j, begin, count, offset);
+            }
+            chunk.set_cardinality(offset + count);
+            begin += count;
+        }
+        for (size_t i = 0; i < nrows; ++i) {
+            for (size_t j = 0; j < decoders_.size(); ++j) {
+                bytes_ += impl::field_bytes(rows[i][j]);
+            }
+        }
+        rows_ += nrows;
+        ++batches_;
+    }
+
+    // one chunk with every row, the parts are released as soon as they are copied
+    std::unique_ptr<data_chunk_t> concat_chunks(std::pmr::memory_resource* resource,
+                                                std::vector<std::unique_ptr<data_chunk_t>> chunks);
+
     data_chunk_t mysql_to_chunk(std::pmr::memory_resource* res, const boost::mysql::results& result);
 
     std::optional<std::pmr::vector<types::complex_logical_type>>
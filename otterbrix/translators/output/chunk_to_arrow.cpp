@@ -3,6 +3,12 @@
 
 #include "chunk_to_arrow.hpp"
 
+#include <arrow/util/bit_util.h>
+#include <arrow/util/bitmap_ops.h>
+
+#include <cstring>
+#include <limits>
+
 using namespace components::vector;
 using namespace components::types;
 using namespace components;
@@ -91,4 +97,152 @@ std::shared_ptr<arrow::Schema> to_arrow_schema(const components::types::complex_
     }
 
     return arrow::schema(std::move(field_vector));
-}
\ No newline at end of file
+}
+
+namespace {
+    struct arrow_validity_t {
+        std::shared_ptr<arrow::Buffer> bitmap;
+        int64_t null_count = 0;
+    };
+
+    // validity_mask_t keeps one bit per row in little-endian words, which is the arrow bitmap layout
+    arrow::Result<arrow_validity_t> copy_validity(const vector_t& vec, size_t offset, size_t length) {
+        const auto* mask = reinterpret_cast<const uint8_t*>(vec.validity().data());
+        if (!mask || length == 0) {
+            return arrow_validity_t{};
+        }
+        ARROW_ASSIGN_OR_RAISE(auto bitmap, arrow::AllocateBitmap(static_cast<int64_t>(length)));
+        arrow::internal::CopyBitmap(mask, offset, length, bitmap->mutable_data(), 0);
+        const auto valid = arrow::internal::CountSetBits(bitmap->data(), 0, length);
+        if (valid == static_cast<int64_t>(length)) {
+            return arrow_validity_t{};
+        }
+        return arrow_validity_t{std::move(bitmap), static_cast<int64_t>(length) - valid};
+    }
+
+    template<typename T>
+    arrow::Result<std::shared_ptr<arrow::Array>> fixed_width_array(const vector_t& vec,
+                                                                   const std::shared_ptr<arrow::DataType>& type,
+                                                                   size_t offset,
+                                                                   size_t length) {
+        ARROW_ASSIGN_OR_RAISE(auto values, arrow::AllocateBuffer(static_cast<int64_t>(length * sizeof(T))));
+        if (length > 0) {
+            std::memcpy(values->mutable_data(), vec.data<T>() + offset, length * sizeof(T));
+        }
+        ARROW_ASSIGN_OR_RAISE(auto validity, copy_validity(vec, offset, length));
+        auto data = arrow::ArrayData::Make(type,
+                                           static_cast<int64_t>(length),
+                                           {std::move(validity.bitmap), std::move(values)},
+                                           validity.null_count);
+        return arrow::MakeArray(std::move(data));
+    }
+
+    // bool vectors are byte per value, arrow packs them into bits
+    arrow::Result<std::shared_ptr<arrow::Array>> boolean_array(const vector_t& vec,
+                                                               const std::shared_ptr<arrow::DataType>& type,
+                                                               size_t offset,
+                                                               size_t length) {
+        ARROW_ASSIGN_OR_RAISE(auto values, arrow::AllocateEmptyBitmap(static_cast<int64_t>(length)));
+        const auto* src = vec.data<bool>() + offset;
+        auto* dst = values->mutable_data();
+        for (size_t i = 0; i < length; ++i) {
+            if (src[i]) {
+                arrow::bit_util::SetBit(dst, static_cast<int64_t>(i));
+            }
+        }
+        ARROW_ASSIGN_OR_RAISE(auto validity, copy_validity(vec, offset, length));
+        auto data = arrow::ArrayData::Make(type,
+                                           static_cast<int64_t>(length),
+                                           {std::move(validity.bitmap), std::move(values)},
+                                           validity.null_count);
+        return arrow::MakeArray(std::move(data));
+    }
+
+    // one pass for offsets, one memcpy per value into a single data buffer
+    arrow::Result<std::shared_ptr<arrow::Array>> string_array(const vector_t& vec,
+                                                              const std::shared_ptr<arrow::DataType>& type,
+                                                              size_t offset,
+                                                              size_t length) {
+        ARROW_ASSIGN_OR_RAISE(auto validity, copy_validity(vec, offset, length));
+        const auto* views = vec.data<std::string_view>() + offset;
+        auto is_valid = [&](size_t i) {
+            return !validity.bitmap || arrow::bit_util::GetBit(validity.bitmap->data(), static_cast<int64_t>(i));
+        };
+
+        ARROW_ASSIGN_OR_RAISE(auto offsets, arrow::AllocateBuffer(static_cast<int64_t>((length + 1) * sizeof(int32_t))));
+        auto* raw_offsets = reinterpret_cast<int32_t*>(offsets->mutable_data());
+        int64_t total = 0;
+        for (size_t i = 0; i < length; ++i) {
+            raw_offsets[i] = static_cast<int32_t>(total);
+            if (is_valid(i)) {
+                total += static_cast<int64_t>(views[i].size());
+            }
+            if (total > std::numeric_limits<int32_t>::max()) {
+                return arrow::Status::CapacityError("Chunk to arrow: string column exceeds 2GB in one batch");
+            }
+        }
+        raw_offsets[length] = static_cast<int32_t>(total);
+
+        ARROW_ASSIGN_OR_RAISE(auto values, arrow::AllocateBuffer(total));
+        auto* dst = values->mutable_data();
+        for (size_t i = 0; i < length; ++i) {
+            if (is_valid(i) && !views[i].empty()) {
+                std::memcpy(dst + raw_offsets[i], views[i].data(), views[i].size());
+            }
+        }
+        auto data = arrow::ArrayData::Make(type,
+                                           static_cast<int64_t>(length),
+                                           {std::move(validity.bitmap), std::move(offsets), std::move(values)},
+                                           validity.null_count);
+        return arrow::MakeArray(std::move(data));
+    }
+} // namespace
+
+arrow::Result<std::shared_ptr<arrow::Array>> to_arrow_array(const vector_t& vec,
+                                                            const std::shared_ptr<arrow::DataType>& type,
+                                                            size_t offset,
+                                                            size_t length) {
+    const auto physical = vec.type().to_physical_type();
+    auto mismatch = [&]() {
+        return arrow::Status::NotImplemented("Chunk to arrow: no bulk path from physical type ",
+                                             static_cast<int>(physical),
+                                             " to ",
+                                             type->ToString());
+    };
+    switch (type->id()) {
+        case arrow::Type::BOOL:
+            return physical == physical_type::BOOL ? boolean_array(vec, type, offset, length) : mismatch();
+        case arrow::Type::INT8:
+            return physical == physical_type::INT8 ? fixed_width_array<int8_t>(vec, type, offset, length) : mismatch();
+        case arrow::Type::INT16:
+            return physical == physical_type::INT16 ? fixed_width_array<int16_t>(vec, type, offset, length)
+                                                    : mismatch();
+        case arrow::Type::INT32:
+            return physical == physical_type::INT32 ? fixed_width_array<int32_t>(vec, type, offset, length)
+                                                    : mismatch();
+        case arrow::Type::INT64:
+            return physical == physical_type::INT64 ? fixed_width_array<int64_t>(vec, type, offset, length)
+                                                    : mismatch();
+        case arrow::Type::UINT8:
+            return physical == physical_type::UINT8 ? fixed_width_array<uint8_t>(vec, type, offset, length)
+                                                    : mismatch();
+        case arrow::Type::UINT16:
+            return physical == physical_type::UINT16 ? fixed_width_array<uint16_t>(vec, type, offset, length)
+                                                     : mismatch();
+        case arrow::Type::UINT32:
+            return physical == physical_type::UINT32 ? fixed_width_array<uint32_t>(vec, type, offset, length)
+                                                     : mismatch();
+        case arrow::Type::UINT64:
+            return physical == physical_type::UINT64 ? fixed_width_array<uint64_t>(vec, type, offset, length)
+                                                     : mismatch();
+        case arrow::Type::FLOAT:
+            return physical == physical_type::FLOAT ? fixed_width_array<float>(vec, type, offset, length) : mismatch();
+        case arrow::Type::DOUBLE:
+            return physical == physical_type::DOUBLE ? fixed_width_array<double>(vec, type, offset, length)
+                                                     : mismatch();
+        case arrow::Type::STRING:
+            return physical == physical_type::STRING ? string_array(vec, type, offset, length) : mismatch();
+        default:
+            return mismatch();
+    }
+}
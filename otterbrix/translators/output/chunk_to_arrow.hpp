@@ -12,4 +12,11 @@
 #include <otterbrix/otterbrix.hpp>
 
 std::shared_ptr<arrow::Schema> to_arrow_schema(const std::pmr::vector<components::types::complex_logical_type>& types);
-std::shared_ptr<arrow::Schema> to_arrow_schema(const components::types::complex_logical_type& struct_t);
\ No newline at end of file
+std::shared_ptr<arrow::Schema> to_arrow_schema(const components::types::complex_logical_type& struct_t);
+
+// copies a slice of a flat vector into arrow buffers in bulk,
+// NotImplemented if the vector layout does not match the requested arrow type
+arrow::Result<std::shared_ptr<arrow::Array>> to_arrow_array(const components::vector::vector_t& vec,
+                                                            const std::shared_ptr<arrow::DataType>& type,
+                                                            size_t offset,
+                                                            size_t length);
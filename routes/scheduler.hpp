@@ -18,6 +18,7 @@ namespace scheduler {
         execute_failed,
         get_catalog_schema_finish,
         get_otterbrix_schema_finish,
+        close_statement,
     };
 
     constexpr auto handler_id(route type) { return handler_id(group_id_t::scheduler, type); }
@@ -15,13 +15,53 @@
 
 using namespace components;
 
+namespace {
+    std::vector<std::unique_ptr<IParser>> single_parser(std::unique_ptr<IParser> parser) {
+        std::vector<std::unique_ptr<IParser>> parsers;
+        parsers.push_back(std::move(parser));
+        return parsers;
+    }
+
+    // statements after which described result schemas may be out of date
+    bool changes_schema(NodeTag tag) {
+        switch (tag) {
+            case T_CreateStmt:
+            case T_CreateTableAsStmt:
+            case T_CreateSchemaStmt:
+            case T_CreatedbStmt:
+            case T_AlterTableStmt:
+            case T_DropStmt:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // remote scans go through the catalog before they are sent: schema nodes, pruned projections, pushed filters
+    bool needs_planning(const ParsedQueryData& data) {
+        const auto& params = *data.otterbrix_params;
+        return params.node->type() == logical_plan::node_type::aggregate_t && params.external_nodes_count;
+    }
+
+    // placeholders written by the client, a cached plan also counts the literals taken out of the text
+    size_t user_parameters(const ParsedQueryData& data) {
+        return data.has_binder() ? data.otterbrix_params->parameters_count : 0;
+    }
+} // namespace
+
 Scheduler::Scheduler(std::pmr::memory_resource* res,
                      std::unique_ptr<IParser> parser,
                      actor_zeta::address_t sql_connection_manager,
                      actor_zeta::address_t otterbrix_manager,
                      actor_zeta::address_t catalog_manager)
+    : Scheduler(res, single_parser(std::move(parser)), sql_connection_manager, otterbrix_manager, catalog_manager) {}
+
+Scheduler::Scheduler(std::pmr::memory_resource* res,
+                     std::vector<std::unique_ptr<IParser>> parsers,
+                     actor_zeta::address_t sql_connection_manager,
+                     actor_zeta::address_t otterbrix_manager,
+                     actor_zeta::address_t catalog_manager)
     : actor_zeta::cooperative_supervisor<Scheduler>(res)
-    , parser_(std::move(parser))
     , execute_(actor_zeta::make_behavior(resource(),
                                          scheduler::handler_id(scheduler::route::execute),
                                          this,
@@ -68,16 +108,27 @@ Scheduler::Scheduler(std::pmr::memory_resource* res,
                                     scheduler::handler_id(scheduler::route::get_otterbrix_schema_finish),
                                     this,
                                     &Scheduler::get_otterbrix_schema_finish))
+    , close_statement_(actor_zeta::make_behavior(resource(),
+                                                 scheduler::handler_id(scheduler::route::close_statement),
+                                                 this,
+                                                 &Scheduler::close_statement))
     , sql_connection_manager_(sql_connection_manager)
     , otterbrix_manager_(otterbrix_manager)
     , catalog_manager_(catalog_manager)
     , log_(get_logger(logger_tag::SCHEDULER)) {
     assert(log_.is_valid());
     assert(res != nullptr);
-    assert(parser_ != nullptr);
-    worker_.start(); // Start the worker thread manager
+    assert(!parsers.empty());
+    shards_.reserve(parsers.size());
+    for (auto& parser : parsers) {
+        assert(parser != nullptr);
+        shards_.push_back(std::make_unique<shard_t>(std::move(parser)));
+    }
+    log_->debug("Scheduler started with {} shards", shards_.size());
 }
 
+void Scheduler::set_schema_cache(schema_cache_ptr cache) { schema_cache_ = std::move(cache); }
+
 actor_zeta::behavior_t Scheduler::behavior() {
     return actor_zeta::make_behavior(resource(), [this](actor_zeta::message* msg) -> void {
         switch (msg->command()) {
@@ -121,6 +172,10 @@ actor_zeta::behavior_t Scheduler::behavior() {
                 get_otterbrix_schema_finish_(msg);
                 break;
             }
+            case scheduler::handler_id(scheduler::route::close_statement): {
+                close_statement_(msg);
+                break;
+            }
         }
     });
 }
@@ -132,8 +187,8 @@ auto Scheduler::make_scheduler() noexcept -> actor_zeta::scheduler_abstract_t* {
     return nullptr;
 }
 
+// no actor-wide lock: handlers only touch the state of the shard owning their session, see scheduler.hpp
 auto Scheduler::enqueue_impl(actor_zeta::message_ptr msg, actor_zeta::execution_unit*) -> void {
-    std::unique_lock<std::mutex> _(input_mtx_);
     auto tmp = std::move(msg);
     behavior()(tmp.get());
 }
@@ -144,8 +199,10 @@ auto Scheduler::execute(session_hash_t id, shared_flight_data sdata, std::string
         // log_->trace("execute thread: {}, sql: {}, id hash: {}", std::this_thread::get_id(), sql, id);  // fmt v11 doesn't format thread::id
         log_->trace("execute sql: {}, id hash: {}", sql, id);
         register_session(id, sdata); // in case parse() throws
-        auto parsed = parser_->parse(sql);
-        update_metadata(id, std::move(parsed)); // skip schema computing
+        auto parsed = parse(id, sql);
+        // result schema is not computed, the catalog only plans the remote scans
+        const bool planned = !needs_planning(*parsed);
+        update_metadata(id, std::move(parsed), {}, planned);
         execute_statement(id, std::move(sdata));
     } catch (const std::exception& e) {
         log_->error("execute caught exception: {}", e.what());
@@ -163,18 +220,15 @@ void Scheduler::execute_statement(session_hash_t id, shared_flight_data sdata) {
 
         log_->debug("execute_statement send to sql");
         auto task = [this, id]() {
-            if (auto data_ptr = get_statement(id); data_ptr) {
-                // log_->trace("execute_statement send task: {}", std::this_thread::get_id());  // fmt v11 doesn't format thread::id
-                actor_zeta::send(this->sql_connection_manager_,
-                                 this->address(),
-                                 sql_connection_manager::handler_id(sql_connection_manager::route::execute),
+            if (auto unplanned = take_unplanned(id); unplanned) {
+                actor_zeta::send(catalog_manager_,
+                                 address(),
+                                 catalog_manager::handler_id(catalog_manager::route::get_catalog_schema),
                                  id,
-                                 std::move(data_ptr));
+                                 std::move(unplanned));
                 return;
             }
-            complete_session_on_error(
-                id,
-                "No needed metadata found, unable to DoGet. A GetFlightInfoStatement call is required");
+            dispatch_statement(id);
         };
         worker_.addTask(std::move(task));
         log_->debug("execute_statement send to sql done");
@@ -184,23 +238,55 @@ void Scheduler::execute_statement(session_hash_t id, shared_flight_data sdata) {
     }
 }
 
+void Scheduler::dispatch_statement(session_hash_t id) {
+    if (auto data_ptr = get_statement(id); data_ptr) {
+        // log_->trace("execute_statement send task: {}", std::this_thread::get_id());  // fmt v11 doesn't format thread::id
+        actor_zeta::send(sql_connection_manager_,
+                         address(),
+                         sql_connection_manager::handler_id(sql_connection_manager::route::execute),
+                         id,
+                         std::move(data_ptr));
+        return;
+    }
+    complete_session_on_error(id,
+                              "No needed metadata found, unable to DoGet. A GetFlightInfoStatement call is required");
+}
+
 auto Scheduler::execute_prepared_statement(session_hash_t id,
                                            std::pmr::vector<types::logical_value_t> parameters,
                                            shared_flight_data sdata) -> void {
     try {
         Timer timer("Scheduler::execute_prepared_statement");
+        switch (begin_prepared_execution(id)) {
+            case prepared_execution::started:
+                break;
+            case prepared_execution::missing:
+                // nothing to register the session against, answer directly instead of leaving it to time out
+                sdata->release_on_error("Prepared statement not found, it has to be prepared first");
+                return;
+            case prepared_execution::in_flight:
+                // the running execution owns the session slot, answer this one directly
+                sdata->release_on_error("Prepared statement is already being executed");
+                return;
+        }
         register_session(id, sdata);
 
-        auto& meta = get_metadata(id);
-        auto& binder = meta.query_data_ptr->binder();
-        for (size_t i = 0; i < parameters.size(); ++i) {
-            binder.bind(i + 1, parameters.at(i));
-        }
+        auto& statement = *get_metadata(id).query_data_ptr;
+        if (statement.has_binder()) {
+            auto& binder = statement.binder();
+            for (size_t i = 0; i < parameters.size(); ++i) {
+                binder.bind(i + 1, parameters.at(i));
+            }
 
-        if (auto result = binder.finalize(); std::holds_alternative<sql::transform::bind_error>(result)) {
-            complete_session_on_error(id,
-                                      "Argument binding failed: " +
-                                          std::get<sql::transform::bind_error>(result).what());
+            if (auto result = binder.finalize(); std::holds_alternative<sql::transform::bind_error>(result)) {
+                complete_session_on_error(id,
+                                          "Argument binding failed: " +
+                                              std::get<sql::transform::bind_error>(result).what());
+                return;
+            }
+        } else if (!parameters.empty()) {
+            // an instance of a cached plan, the literals of its text are its only parameters
+            complete_session_on_error(id, "Argument binding failed: statement has no parameters");
             return;
         }
 
@@ -219,7 +305,15 @@ auto Scheduler::prepare_schema(session_hash_t id, shared_flight_data sdata, std:
         log_->trace("prepare_schema sql: {}, id hash: {}", sql, id);
 
         register_session(id, std::move(sdata));
-        auto parsed = parser_->parse(sql);
+        auto parsed = parse_prepared(id, sql);
+
+        if (schema_cache_ && !parsed->cache_key.empty()) {
+            if (auto schema = schema_cache_->lookup(parsed->cache_key); schema) {
+                describe_cached(id, std::move(parsed), std::move(*schema));
+                return;
+            }
+            parsed->schema_version = schema_cache_->version();
+        }
 
         if (parsed->otterbrix_params->node->type() != logical_plan::node_type::aggregate_t) {
             // node is not aggregate nor join - result is empty schema
@@ -301,10 +395,21 @@ auto Scheduler::get_catalog_schema_finish(session_hash_t id,
                                           ParsedQueryDataPtr&& data,
                                           catalog::catalog_error err) -> void {
     if (err) {
+        if (finish_planning(id, data, false)) {
+            // planning only narrows the remote queries, the statement still runs with what was planned so far
+            log_->warn("Scheduler::get_catalog_schema_finish planning failed, executing as parsed: {}", err.what());
+            worker_.addTask([this, id]() { dispatch_statement(id); });
+            return;
+        }
         complete_session_on_error(id, err.what());
         return;
     }
 
+    if (finish_planning(id, data)) {
+        worker_.addTask([this, id]() { dispatch_statement(id); });
+        return;
+    }
+
     if (data->otterbrix_params->node->type() == logical_plan::node_type::unused) {
         // schema nodes are tagged with this - just output resulting schema
         get_otterbrix_schema_finish(
@@ -355,87 +460,291 @@ auto Scheduler::get_otterbrix_schema_finish(session_hash_t id,
     if (cursor->size()) {
         schema = cursor->type_data()[0];
     }
-    const size_t param_cnt = data->otterbrix_params->parameters_count;
+    if (schema_cache_ && !data->cache_key.empty() &&
+        schema_cache_->store(data->cache_key, data->schema_version, schema)) {
+        log_->trace("Scheduler::get_otterbrix_schema_finish schema cached: {}", data->cache_key);
+    }
+    const size_t param_cnt = user_parameters(*data);
     const NodeTag tag = data->tag;
+    auto parameter_types = std::move(data->parameter_types);
     update_metadata(id, std::move(data), schema);
+    flight_data result{std::move(schema), data_chunk_t{resource(), {}, 0}, param_cnt, tag};
+    result.parameter_types = std::move(parameter_types);
+    complete_session(id, std::move(result), session_type::GET_FLIGHT_INFO);
+}
+
+void Scheduler::describe_cached(session_hash_t id, ParsedQueryDataPtr data, types::complex_logical_type schema) {
+    log_->trace("Scheduler::describe_cached {}", data->cache_key);
+    const bool planned = !needs_planning(*data);
+    const size_t param_cnt = user_parameters(*data);
+    const NodeTag tag = data->tag;
+    update_metadata(id, std::move(data), schema, planned);
     complete_session(id,
                      flight_data{std::move(schema), data_chunk_t{resource(), {}, 0}, param_cnt, tag},
                      session_type::GET_FLIGHT_INFO);
 }
 
+auto Scheduler::close_statement(session_hash_t id) -> void {
+    log_->trace("Scheduler::close_statement id hash: {}", id);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    if (auto it = shard.metadata_map.find(id); it != shard.metadata_map.end()) {
+        if (it->second.in_flight) {
+            // dropped when the running execution completes
+            it->second.prepared = false;
+        } else {
+            return_cached_plan(shard, it->second);
+            shard.metadata_map.erase(it);
+        }
+    }
+}
+
+Scheduler::shard_t& Scheduler::shard_for(session_hash_t id) const { return *shards_[id % shards_.size()]; }
+
+ParsedQueryDataPtr Scheduler::parse(session_hash_t id, const std::string& sql) {
+    auto& shard = shard_for(id);
+    if (auto query = parameterize_query(resource(), sql); query) {
+        if (auto instance = instantiate_cached(shard, std::move(*query)); instance) {
+            return instance;
+        }
+    }
+    std::lock_guard<std::mutex> lock(shard.parser_mtx);
+    return shard.parser->parse(sql);
+}
+
+ParsedQueryDataPtr Scheduler::parse_prepared(session_hash_t id, const std::string& sql) {
+    auto& shard = shard_for(id);
+    auto query = parameterize_query(resource(), sql);
+    if (query) {
+        if (auto instance = instantiate_cached(shard, *query); instance) {
+            // the instance owns a copy of the plan with every value bound, later statements reuse the template
+            std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+            shard.plan_cache.put(instance->cache_key, std::move(instance->cached_template));
+            return instance;
+        }
+    }
+    ParsedQueryDataPtr parsed;
+    {
+        std::lock_guard<std::mutex> lock(shard.parser_mtx);
+        parsed = shard.parser->parse(sql);
+    }
+    if (query && parsed->tag == T_SelectStmt) {
+        parsed->cache_key = std::move(query->sql);
+    }
+    return parsed;
+}
+
+ParsedQueryDataPtr Scheduler::instantiate_cached(shard_t& shard, parameterized_query_t query) {
+    ParsedQueryDataPtr plan;
+    {
+        std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+        if (auto entry = shard.plan_cache.take(query.sql); entry) {
+            if (!*entry) {
+                shard.plan_cache.put(std::move(query.sql), nullptr);
+                return nullptr;
+            }
+            plan = std::move(*entry);
+        }
+    }
+
+    if (!plan) {
+        try {
+            std::lock_guard<std::mutex> lock(shard.parser_mtx);
+            plan = shard.parser->parse(query.sql);
+        } catch (const std::exception& e) {
+            log_->debug("Scheduler::instantiate_cached parameterized query failed to parse: {}", e.what());
+        }
+        // only queries are cached, and only if every literal became a parameter of the plan
+        if (!plan || plan->tag != T_SelectStmt ||
+            plan->otterbrix_params->parameters_count != query.values.size()) {
+            std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+            shard.plan_cache.put(std::move(query.sql), nullptr);
+            return nullptr;
+        }
+        log_->trace("Scheduler::instantiate_cached new plan: {}", query.sql);
+    }
+
+    if (!query.values.empty()) {
+        auto& binder = plan->binder();
+        for (size_t i = 0; i < query.values.size(); ++i) {
+            binder.bind(i + 1, query.values.at(i));
+        }
+        if (auto result = binder.finalize(); std::holds_alternative<sql::transform::bind_error>(result)) {
+            // the plan is dropped, a fresh parse of the literal text takes over
+            log_->debug("Scheduler::instantiate_cached binding failed: {}",
+                        std::get<sql::transform::bind_error>(result).what());
+            return nullptr;
+        }
+    }
+
+    auto instance = plan->instantiate();
+    instance->cache_key = std::move(query.sql);
+    instance->cached_template = std::move(plan);
+    return instance;
+}
+
+void Scheduler::return_cached_plan(shard_t& shard, metadata_t& meta) {
+    if (!meta.cached_template) {
+        return;
+    }
+    shard.plan_cache.put(std::move(meta.cache_key), std::move(meta.cached_template));
+}
+
 void Scheduler::register_session(session_hash_t id, shared_flight_data sdata) {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
-    shared_data_map_[id] = std::move(sdata);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    shard.shared_data_map[id] = std::move(sdata);
     log_->trace("Scheduler::register_session");
 }
 
-void Scheduler::update_metadata(session_hash_t id, ParsedQueryDataPtr metadata, types::complex_logical_type schema) {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
+void Scheduler::update_metadata(session_hash_t id,
+                                ParsedQueryDataPtr metadata,
+                                types::complex_logical_type schema,
+                                bool planned) {
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
     log_->trace("Scheduler::update_metadata start");
     NodeTag tag = metadata->tag;
-    metadata_map_[id] = metadata_t(std::move(schema), std::move(metadata), tag);
+    auto cached_template = std::move(metadata->cached_template);
+    auto cache_key = std::move(metadata->cache_key);
+    auto& meta = shard.metadata_map[id] = metadata_t(std::move(schema), std::move(metadata), tag);
+    meta.cached_template = std::move(cached_template);
+    meta.cache_key = std::move(cache_key);
+    meta.planned = planned;
     log_->trace("Scheduler::update_metadata finish");
 }
 
 void Scheduler::complete_session(session_hash_t id) {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
     log_->trace("Scheduler::complete_session empty start");
 
-    if (auto it = shared_data_map_.find(id);
-        it != shared_data_map_.end() && it->second->status() == cv_wrapper::Status::Unknown) {
+    if (auto it = shard.shared_data_map.find(id);
+        it != shard.shared_data_map.end() && it->second->status() == cv_wrapper::Status::Unknown) {
         log_->trace("Scheduler::complete_session updated");
         it->second->release_empty();
     }
     log_->trace("Scheduler::complete_session empty finish");
-    shared_data_map_.erase(id);
-    metadata_map_.erase(id);
+    shard.shared_data_map.erase(id);
+    release_metadata(shard, id);
 }
 
 void Scheduler::complete_session(session_hash_t id, flight_data data, session_type type) {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
     log_->trace("Scheduler::complete_session start");
 
-    if (auto it = shared_data_map_.find(id);
-        it != shared_data_map_.end() && it->second->status() == cv_wrapper::Status::Unknown) {
+    if (auto it = shard.shared_data_map.find(id);
+        it != shard.shared_data_map.end() && it->second->status() == cv_wrapper::Status::Unknown) {
         log_->trace("Scheduler::complete_session updated");
         it->second->result = std::move(data);
         it->second->release();
     }
     log_->trace("Scheduler::complete_session finish");
-    shared_data_map_.erase(id);
+    shard.shared_data_map.erase(id);
 
     if (type == session_type::DO_GET) {
         // metadata not needed anymore
-        metadata_map_.erase(id);
+        release_metadata(shard, id);
     }
 }
 
 void Scheduler::complete_session_on_error(session_hash_t id, std::string error_msg) {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
     log_->trace("Scheduler::complete_session_on_error start");
 
-    if (auto it = shared_data_map_.find(id); it != shared_data_map_.end()) {
+    if (auto it = shard.shared_data_map.find(id); it != shard.shared_data_map.end()) {
         it->second->release_on_error(std::move(error_msg));
     }
     log_->trace("Scheduler::complete_session_on_error finish");
-    shared_data_map_.erase(id);
-    metadata_map_.erase(id);
+    shard.shared_data_map.erase(id);
+    release_metadata(shard, id);
 }
 
 ParsedQueryDataPtr Scheduler::get_statement(session_hash_t id) {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
-    if (auto it = metadata_map_.find(id); it != metadata_map_.end()) {
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    if (auto it = shard.metadata_map.find(id); it != shard.metadata_map.end()) {
+        if (it->second.prepared && it->second.query_data_ptr) {
+            return it->second.query_data_ptr->instantiate();
+        }
         return std::move(it->second.query_data_ptr);
     }
     return nullptr; // signals missing parsing session
 }
 
+ParsedQueryDataPtr Scheduler::take_unplanned(session_hash_t id) {
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    auto it = shard.metadata_map.find(id);
+    if (it == shard.metadata_map.end() || it->second.planned || !it->second.query_data_ptr) {
+        return nullptr;
+    }
+    // prepared statements are planned once, their template keeps the plan for later executions
+    it->second.planned = true;
+    it->second.planning = true;
+    return std::move(it->second.query_data_ptr);
+}
+
+bool Scheduler::finish_planning(session_hash_t id, ParsedQueryDataPtr& data, bool planned) {
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    auto it = shard.metadata_map.find(id);
+    if (it == shard.metadata_map.end() || !it->second.planning) {
+        return false;
+    }
+    it->second.planning = false;
+    it->second.planned = planned;
+    it->second.query_data_ptr = std::move(data);
+    return true;
+}
+
+auto Scheduler::begin_prepared_execution(session_hash_t id) -> prepared_execution {
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    auto it = shard.metadata_map.find(id);
+    if (it == shard.metadata_map.end()) {
+        return prepared_execution::missing;
+    }
+    auto& meta = it->second;
+    if (meta.in_flight) {
+        return prepared_execution::in_flight;
+    }
+    if (!meta.query_data_ptr) {
+        return prepared_execution::missing;
+    }
+    meta.prepared = true;
+    meta.in_flight = true;
+    return prepared_execution::started;
+}
+
+void Scheduler::release_metadata(shard_t& shard, session_hash_t id) {
+    auto it = shard.metadata_map.find(id);
+    if (it == shard.metadata_map.end()) {
+        return;
+    }
+    auto& meta = it->second;
+    if (schema_cache_ && changes_schema(meta.tag)) {
+        schema_cache_->invalidate();
+    }
+    if (!meta.prepared || !meta.query_data_ptr) {
+        return_cached_plan(shard, meta);
+        shard.metadata_map.erase(it);
+        return;
+    }
+    // the execution ran on its own copy of the plan, the template is left as it was
+    meta.in_flight = false;
+}
+
 auto Scheduler::get_metadata(session_hash_t id) const -> const metadata_t& {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
-    return metadata_map_.at(id);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    return shard.metadata_map.at(id);
 }
 
 bool Scheduler::session_exists(session_hash_t id) const {
-    std::lock_guard<std::mutex> lock(data_map_mtx_);
-    return shared_data_map_.contains(id) && metadata_map_.contains(id);
+    auto& shard = shard_for(id);
+    std::lock_guard<std::mutex> lock(shard.data_map_mtx);
+    return shard.shared_data_map.contains(id) && shard.metadata_map.contains(id);
 }
@@ -14,6 +14,8 @@
 #include "routes/catalog_manager.hpp"
 #include "schema_utils.hpp"
 #include "utility/cv_wrapper.hpp"
+#include "utility/lru_cache.hpp"
+#include "utility/schema_cache.hpp"
 #include "utility/session.hpp"
 #include "utility/shared_flight_data.hpp"
 #include "utility/worker.hpp"
@@ -30,6 +32,9 @@
 #include <unordered_set>
 #include <vector>
 
+// messages are not serialized: every handler runs on the sender's thread, concurrently with the others.
+// state of a session lives in its shard and is only touched under the shard's mutexes, a shard's parser
+// runs one query at a time. res is shared by all shards and must be thread-safe.
 class Scheduler final : public actor_zeta::cooperative_supervisor<Scheduler> {
 public:
     Scheduler(std::pmr::memory_resource* res,
@@ -37,6 +42,17 @@ public:
               actor_zeta::address_t sql_connection_manager,
               actor_zeta::address_t otterbrix_manager,
               actor_zeta::address_t catalog_manager);
+    // one shard per parser, sessions are routed to shards by their hash
+    Scheduler(std::pmr::memory_resource* res,
+              std::vector<std::unique_ptr<IParser>> parsers,
+              actor_zeta::address_t sql_connection_manager,
+              actor_zeta::address_t otterbrix_manager,
+              actor_zeta::address_t catalog_manager);
+
+    size_t shard_count() const noexcept { return shards_.size(); }
+    // described queries are answered from the cache without going through the catalog and otterbrix,
+    // set before the first message is sent
+    void set_schema_cache(schema_cache_ptr cache);
 
     actor_zeta::behavior_t behavior();
     auto make_scheduler() noexcept -> actor_zeta::scheduler_abstract_t*;
@@ -50,23 +66,80 @@ private:
         components::types::complex_logical_type schema;
         ParsedQueryDataPtr query_data_ptr;
         NodeTag tag;
+        // prepared statements keep their plan as a template between executions until close_statement
+        bool prepared = false;
+        bool in_flight = false;
+        // plan cache entry the statement was instantiated from, handed back when the metadata is dropped
+        ParsedQueryDataPtr cached_template;
+        std::string cache_key;
+        // executed without a describe or described from the schema cache: the catalog plans the remote scans
+        // on the first execution
+        bool planned = true;
+        bool planning = false;
+    };
+
+    // parsed plans per shard keyed by the parameterized sql, a null entry marks a shape that can't be cached
+    static constexpr size_t PLAN_CACHE_CAPACITY = 256;
+
+    // sessions of one shard share a parser and session maps, shards never touch each other's state
+    struct shard_t {
+        explicit shard_t(std::unique_ptr<IParser> parser)
+            : parser(std::move(parser)) {}
+
+        std::mutex parser_mtx;
+        std::unique_ptr<IParser> parser;
+        mutable std::mutex data_map_mtx;
+        std::unordered_map<session_hash_t, shared_flight_data> shared_data_map;
+        std::unordered_map<session_hash_t, metadata_t> metadata_map;
+        // guarded by data_map_mtx, entries are taken out while a session runs them
+        LruCache<std::string, ParsedQueryDataPtr> plan_cache{PLAN_CACHE_CAPACITY};
     };
 
-    std::unordered_map<session_hash_t, shared_flight_data> shared_data_map_;
     log_t log_;
-    std::unordered_map<session_hash_t, metadata_t> metadata_map_;
 
+    shard_t& shard_for(session_hash_t id) const;
+    ParsedQueryDataPtr parse(session_hash_t id, const std::string& sql);
+    // statements that may be prepared own their plan: an instance of the cached plan, its template goes back to the
+    // cache at once, or a fresh parse with a binder for client placeholders. the cache key is set either way,
+    // described schemas are cached under it
+    ParsedQueryDataPtr parse_prepared(session_hash_t id, const std::string& sql);
+    // instance of the cached plan of the query with its literals bound, null if the query can't be cached
+    ParsedQueryDataPtr instantiate_cached(shard_t& shard, parameterized_query_t query);
+    // called under data_map_mtx before the metadata is erased
+    void return_cached_plan(shard_t& shard, metadata_t& meta);
     void register_session(session_hash_t id, shared_flight_data sdata);
-    void update_metadata(session_hash_t id, ParsedQueryDataPtr metadata, types::complex_logical_type schema = {});
+    void update_metadata(session_hash_t id,
+                         ParsedQueryDataPtr metadata,
+                         types::complex_logical_type schema = {},
+                         bool planned = true);
+    // answers prepare_schema with a schema described earlier
+    void describe_cached(session_hash_t id, ParsedQueryDataPtr data, types::complex_logical_type schema);
+    // sends the statement to execution, or fails the session if it was never described
+    void dispatch_statement(session_hash_t id);
+    // moves out a statement the catalog has yet to plan, the plan goes back with finish_planning().
+    // a statement whose planning failed is planned again on its next execution
+    ParsedQueryDataPtr take_unplanned(session_hash_t id);
+    bool finish_planning(session_hash_t id, ParsedQueryDataPtr& data, bool planned = true);
     void complete_session(session_hash_t id);
     void complete_session(session_hash_t id, flight_data data, session_type type);
     void complete_session_on_error(session_hash_t id, std::string error_msg);
     ParsedQueryDataPtr get_statement(session_hash_t id);
     const metadata_t& get_metadata(session_hash_t id) const;
+    enum class prepared_execution
+    {
+        started,
+        missing,
+        in_flight
+    };
+    // marks the prepared statement as executing
+    prepared_execution begin_prepared_execution(session_hash_t id);
+    // called under data_map_mtx once the session is done: prepared statements keep their template,
+    // other metadata is erased
+    void release_metadata(shard_t& shard, session_hash_t id);
     bool session_exists(session_hash_t id) const;
 
 private:
-    std::unique_ptr<IParser> parser_;
+    std::vector<std::unique_ptr<shard_t>> shards_;
     // Behaviors
     actor_zeta::behavior_t execute_;
     actor_zeta::behavior_t execute_statement_;
@@ -78,6 +151,7 @@ private:
     actor_zeta::behavior_t execute_failed_;
     actor_zeta::behavior_t get_catalog_schema_finish_;
     actor_zeta::behavior_t get_otterbrix_schema_finish_;
+    actor_zeta::behavior_t close_statement_;
 
     /// async method
     auto execute(session_hash_t id, shared_flight_data sdata, std::string sql) -> void;
@@ -94,13 +168,13 @@ private:
     auto get_otterbrix_schema_finish(session_hash_t id,
                                      components::cursor::cursor_t_ptr cursor,
                                      ParsedQueryDataPtr&& data) -> void;
+    auto close_statement(session_hash_t id) -> void;
 
     actor_zeta::address_t sql_connection_manager_;
     actor_zeta::address_t otterbrix_manager_;
     actor_zeta::address_t catalog_manager_;
 
-    mutable std::mutex data_map_mtx_;
-    std::mutex input_mtx_;
-
-    TaskManager<std::function<void()>> worker_;
+    schema_cache_ptr schema_cache_;
+    // declared last, queued tasks finish before the state they read is destroyed
+    TaskGroup worker_;
 };
@@ -3,6 +3,13 @@
 
 #include "schema_utils.hpp"
 
+#include <components/logical_plan/node_limit.hpp>
+#include <components/logical_plan/node_match.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
 using namespace components;
 using namespace components::types;
 
@@ -41,6 +48,350 @@ namespace {
                 return logical_type::NA;
         }
     }
+
+    // keys may be qualified with the table name, only the column part is matched against table schemas
+    std::string column_name(std::string name) {
+        if (auto pos = name.rfind('.'); pos != std::string::npos) {
+            name.erase(0, pos + 1);
+        }
+        return name;
+    }
+
+    std::string column_name(const expressions::key_t& key) { return column_name(key.as_string()); }
+
+    bool collect_key(const expressions::key_t& key, std::unordered_set<std::string>& columns) {
+        if (key.is_null()) {
+            return true;
+        }
+        auto name = column_name(key);
+        if (name == "*") {
+            return false;
+        }
+        columns.insert(std::move(name));
+        return true;
+    }
+
+    template<typename Params>
+    bool collect_params(const Params& params, std::unordered_set<std::string>& columns) {
+        for (const auto& param : params) {
+            if (std::holds_alternative<expressions::key_t>(param)) {
+                if (!collect_key(std::get<expressions::key_t>(param), columns)) {
+                    return false;
+                }
+            } else if (!std::holds_alternative<core::parameter_id_t>(param)) {
+                // nested expression
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool collect_expression(const expressions::expression_ptr& expr_ptr, std::unordered_set<std::string>& columns) {
+        switch (expr_ptr->group()) {
+            case expressions::expression_group::compare: {
+                auto& expr = static_cast<const expressions::compare_expression_t&>(*expr_ptr);
+                switch (expr.type()) {
+                    case expressions::compare_type::union_and:
+                    case expressions::compare_type::union_or:
+                    case expressions::compare_type::union_not:
+                        for (const auto& child : expr.children()) {
+                            if (!collect_expression(child, columns)) {
+                                return false;
+                            }
+                        }
+                        return true;
+                    default:
+                        return collect_key(expr.key_left(), columns) && collect_key(expr.key_right(), columns);
+                }
+            }
+            case expressions::expression_group::aggregate: {
+                // without params the key is the column, otherwise it is an alias
+                auto& expr = static_cast<const expressions::aggregate_expression_t&>(*expr_ptr);
+                return expr.params().empty() ? collect_key(expr.key(), columns)
+                                             : collect_params(expr.params(), columns);
+            }
+            case expressions::expression_group::scalar: {
+                auto& expr = static_cast<const expressions::scalar_expression_t&>(*expr_ptr);
+                return expr.params().empty() ? collect_key(expr.key(), columns)
+                                             : collect_params(expr.params(), columns);
+            }
+            case expressions::expression_group::sort:
+                return collect_key(static_cast<const expressions::sort_expression_t&>(*expr_ptr).key(), columns);
+            default:
+                return false;
+        }
+    }
+
+    bool collect_columns(const logical_plan::node_ptr& node, std::unordered_set<std::string>& columns) {
+        switch (node->type()) {
+            case logical_plan::node_type::aggregate_t: {
+                if (!node->collection_full_name().unique_identifier.empty()) {
+                    // external scan, its own filters and sorts are sent along with it
+                    return true;
+                }
+                auto group = std::find_if(node->children().begin(),
+                                          node->children().end(),
+                                          [](const logical_plan::node_ptr& child) {
+                                              return child->type() == logical_plan::node_type::group_t;
+                                          });
+                if (group == node->children().end() || (*group)->expressions().empty()) {
+                    // SELECT * over the scans
+                    return false;
+                }
+                break;
+            }
+            case logical_plan::node_type::join_t:
+            case logical_plan::node_type::group_t:
+            case logical_plan::node_type::match_t:
+            case logical_plan::node_type::sort_t:
+            case logical_plan::node_type::limit_t:
+            case logical_plan::node_type::data_t:
+            case logical_plan::node_type::unused:
+                break;
+            default:
+                return false;
+        }
+
+        for (const auto& expr : node->expressions()) {
+            if (!collect_expression(expr, columns)) {
+                return false;
+            }
+        }
+        for (const auto& child : node->children()) {
+            if (!collect_columns(child, columns)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // column an aggregate reads, empty if it is not a single plain column
+    std::string aggregate_column(const expressions::aggregate_expression_t& expr) {
+        if (expr.params().empty()) {
+            return column_name(expr.key());
+        }
+        if (expr.params().size() == 1 && std::holds_alternative<expressions::key_t>(expr.params().front())) {
+            return column_name(std::get<expressions::key_t>(expr.params().front()));
+        }
+        return {};
+    }
+
+    // schema nodes under a tree of inner joins, join keys are collected on the way
+    bool collect_join_sources(logical_plan::node_ptr& node,
+                              std::vector<logical_plan::node_ptr*>& sources,
+                              std::unordered_set<std::string>& columns) {
+        switch (node->type()) {
+            case logical_plan::node_type::join_t: {
+                // outer joins would turn partial counts of unmatched rows into NULLs
+                if (static_cast<const logical_plan::node_join_t&>(*node).type() != logical_plan::join_type::inner) {
+                    return false;
+                }
+                for (const auto& expr : node->expressions()) {
+                    if (!collect_expression(expr, columns)) {
+                        return false;
+                    }
+                }
+                for (auto& child : node->children()) {
+                    if (!collect_join_sources(child, sources, columns)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case logical_plan::node_type::unused:
+                sources.push_back(&node);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // remote aggregate behind a batch slot, either still raw or already wrapped into a schema node
+    const logical_plan::node_t* scan_of(const logical_plan::node_ptr& node) {
+        if (node->type() == logical_plan::node_type::unused) {
+            return static_cast<schema_utils::schema_node_t&>(*node).agg_node().get();
+        }
+        return node->type() == logical_plan::node_type::aggregate_t ? node.get() : nullptr;
+    }
+
+    bool has_filter(const logical_plan::node_t& scan) {
+        return std::any_of(scan.children().begin(), scan.children().end(), [](const logical_plan::node_ptr& child) {
+            return child->type() == logical_plan::node_type::match_t;
+        });
+    }
+
+    // a qualified key belongs to the scan of that table, a plain one to the scan whose schema has it
+    bool owns_key(const logical_plan::node_ptr& slot, const logical_plan::node_t& scan, const std::string& key) {
+        if (auto pos = key.rfind('.'); pos != std::string::npos) {
+            return key.substr(0, pos) == scan.collection_full_name().collection;
+        }
+        if (slot->type() != logical_plan::node_type::unused) {
+            return false;
+        }
+        const auto& schema = static_cast<const schema_utils::schema_node_t&>(*slot).schema();
+        return std::any_of(schema.child_types().begin(), schema.child_types().end(), [&key](const auto& field) {
+            return field.alias() == key;
+        });
+    }
+
+    void compare_keys(const expressions::compare_expression_t& expr, std::vector<std::string>& keys) {
+        switch (expr.type()) {
+            case expressions::compare_type::union_and:
+            case expressions::compare_type::union_or:
+            case expressions::compare_type::union_not:
+                for (const auto& child : expr.children()) {
+                    compare_keys(static_cast<const expressions::compare_expression_t&>(*child), keys);
+                }
+                return;
+            default:
+                if (!expr.key_left().is_null()) {
+                    keys.emplace_back(expr.key_left().as_string());
+                }
+                if (!expr.key_right().is_null()) {
+                    keys.emplace_back(expr.key_right().as_string());
+                }
+        }
+    }
+
+    // a scan reduces the other one only when it is expected to be this many times smaller
+    constexpr int64_t SEMI_JOIN_MIN_RATIO = 4;
+
+    // fractions of rows a predicate keeps where statistics say nothing better
+    constexpr double EQ_SELECTIVITY = 0.1;
+    constexpr double RANGE_SELECTIVITY = 1.0 / 3;
+    constexpr double OTHER_SELECTIVITY = 0.5;
+
+    double selectivity(const expressions::compare_expression_t& expr, const schema_utils::table_stats_t& stats) {
+        auto child_selectivity = [&stats](const expressions::expression_ptr& child) {
+            return selectivity(static_cast<const expressions::compare_expression_t&>(*child), stats);
+        };
+        switch (expr.type()) {
+            case expressions::compare_type::union_and: {
+                double result = 1.0;
+                for (const auto& child : expr.children()) {
+                    result *= child_selectivity(child);
+                }
+                return result;
+            }
+            case expressions::compare_type::union_or: {
+                double result = 0.0;
+                for (const auto& child : expr.children()) {
+                    result += child_selectivity(child);
+                }
+                return std::min(result, 1.0);
+            }
+            case expressions::compare_type::union_not:
+                return expr.children().empty() ? 1.0 : 1.0 - child_selectivity(expr.children().front());
+            case expressions::compare_type::eq: {
+                auto it = stats.index_cardinality.find(column_name(expr.key_left()));
+                if (expr.key_right().is_null() && it != stats.index_cardinality.end() && it->second > 0) {
+                    return 1.0 / static_cast<double>(it->second);
+                }
+                return EQ_SELECTIVITY;
+            }
+            case expressions::compare_type::ne:
+                return 1.0 - EQ_SELECTIVITY;
+            case expressions::compare_type::gt:
+            case expressions::compare_type::lt:
+            case expressions::compare_type::gte:
+            case expressions::compare_type::lte:
+                return RANGE_SELECTIVITY;
+            default:
+                return OTHER_SELECTIVITY;
+        }
+    }
+
+    // groups of an aggregate: one without keys, at most the product of the key cardinalities otherwise
+    double group_rows(const logical_plan::node_t& group, double rows, const schema_utils::table_stats_t& stats) {
+        bool aggregates = false;
+        double groups = 1.0;
+        for (const auto& expr : group.expressions()) {
+            if (expr->group() == expressions::expression_group::aggregate) {
+                aggregates = true;
+                continue;
+            }
+            std::string column;
+            if (expr->group() == expressions::expression_group::scalar) {
+                const auto& scalar = static_cast<const expressions::scalar_expression_t&>(*expr);
+                if (scalar.params().empty()) {
+                    column = column_name(scalar.key());
+                } else if (std::holds_alternative<expressions::key_t>(scalar.params().front())) {
+                    column = column_name(std::get<expressions::key_t>(scalar.params().front()));
+                }
+            }
+            auto it = stats.index_cardinality.find(column);
+            groups *= it != stats.index_cardinality.end() && it->second > 0 ? static_cast<double>(it->second) : rows;
+        }
+        // a group without aggregates is a projection
+        return aggregates ? std::min(groups, rows) : rows;
+    }
+
+    // types a client can send for a parameter, the rest have no arrow field of their own
+    bool is_parameter_type(logical_type type) {
+        switch (type) {
+            case logical_type::BOOLEAN:
+            case logical_type::TINYINT:
+            case logical_type::SMALLINT:
+            case logical_type::INTEGER:
+            case logical_type::BIGINT:
+            case logical_type::UTINYINT:
+            case logical_type::USMALLINT:
+            case logical_type::UINTEGER:
+            case logical_type::UBIGINT:
+            case logical_type::FLOAT:
+            case logical_type::DOUBLE:
+            case logical_type::STRING_LITERAL:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void compare_parameter_types(const expressions::compare_expression_t& expr,
+                                 const complex_logical_type& table,
+                                 std::vector<complex_logical_type>& types) {
+        switch (expr.type()) {
+            case expressions::compare_type::union_and:
+            case expressions::compare_type::union_or:
+            case expressions::compare_type::union_not:
+                for (const auto& child : expr.children()) {
+                    compare_parameter_types(static_cast<const expressions::compare_expression_t&>(*child),
+                                            table,
+                                            types);
+                }
+                return;
+            case expressions::compare_type::eq:
+            case expressions::compare_type::ne:
+            case expressions::compare_type::gt:
+            case expressions::compare_type::lt:
+            case expressions::compare_type::gte:
+            case expressions::compare_type::lte:
+                break;
+            default:
+                return;
+        }
+        if (expr.key_left().is_null() || !expr.key_right().is_null()) {
+            return;
+        }
+        const auto id = static_cast<size_t>(expr.value());
+        if (id >= types.size() || types[id].type() != logical_type::NA) {
+            return;
+        }
+        const auto name = column_name(expr.key_left());
+        for (const auto& field : table.child_types()) {
+            if (field.alias() == name && is_parameter_type(field.type())) {
+                types[id] = field.type();
+                return;
+            }
+        }
+    }
+
+    int64_t estimated_rows(const logical_plan::node_ptr& slot) {
+        if (slot->type() != logical_plan::node_type::unused) {
+            return -1;
+        }
+        return static_cast<const schema_utils::schema_node_t&>(*slot).estimated_rows();
+    }
 } // namespace
 
 namespace schema_utils {
@@ -55,6 +406,10 @@ namespace schema_utils {
 
     const components::logical_plan::node_aggregate_ptr schema_node_t::agg_node() { return agg_node_; }
 
+    int64_t schema_node_t::estimated_rows() const noexcept { return estimated_rows_; }
+
+    void schema_node_t::set_estimated_rows(int64_t rows) noexcept { estimated_rows_ = rows; }
+
     expressions::hash_t schema_node_t::hash_impl() const { return 0; }
 
     std::string schema_node_t::to_string_impl() const { return ""; }
@@ -88,12 +443,48 @@ namespace schema_utils {
             switch (expr_ptr->group()) {
                 case expressions::expression_group::aggregate: {
                     auto& expr = static_cast<expressions::aggregate_expression_t&>(*expr_ptr);
+                    // type of the aggregated column, if it is known
+                    types::complex_logical_type column = types::logical_type::NA;
+                    {
+                        auto name = expr.key().as_string();
+                        if (!expr.params().empty() &&
+                            std::holds_alternative<expressions::key_t>(expr.params().front())) {
+                            name = std::get<expressions::key_t>(expr.params().front()).as_string();
+                        }
+                        auto cur = schema.find_field(name.c_str());
+                        if (cur->is_success()) {
+                            column = cur->type_data().front();
+                        }
+                    }
                     switch (expr.type()) {
                         case expressions::aggregate_type::count:
+                            agg = types::logical_type::BIGINT;
+                            break;
                         case expressions::aggregate_type::sum:
+                            // sums of integers stay exact, DECIMAL and unknown columns keep their fraction
+                            switch (column.type()) {
+                                case types::logical_type::TINYINT:
+                                case types::logical_type::SMALLINT:
+                                case types::logical_type::INTEGER:
+                                case types::logical_type::BIGINT:
+                                case types::logical_type::UTINYINT:
+                                case types::logical_type::USMALLINT:
+                                case types::logical_type::UINTEGER:
+                                case types::logical_type::UBIGINT:
+                                    agg = types::logical_type::BIGINT;
+                                    break;
+                                default:
+                                    agg = types::logical_type::DOUBLE;
+                                    break;
+                            }
+                            break;
                         case expressions::aggregate_type::min:
                         case expressions::aggregate_type::max:
-                            agg = types::logical_type::BIGINT;
+                            if (column.type() == types::logical_type::NA) {
+                                agg = types::logical_type::BIGINT;
+                            } else {
+                                agg = column;
+                            }
                             break;
                         case expressions::aggregate_type::avg:
                             agg = types::logical_type::DOUBLE;
@@ -197,6 +588,490 @@ namespace schema_utils {
         return merge_schemas(right, left);
     }
 
+    std::optional<std::unordered_set<std::string>> required_columns(const logical_plan::node_ptr& node) {
+        if (!node->collection_full_name().unique_identifier.empty()) {
+            // whole query goes to a single backend, it projects by itself
+            return std::nullopt;
+        }
+
+        std::unordered_set<std::string> columns;
+        if (!collect_columns(node, columns)) {
+            return std::nullopt;
+        }
+        return columns;
+    }
+
+    bool prune_projection(logical_plan::node_aggregate_t& node,
+                          const std::unordered_set<std::string>& columns,
+                          const complex_logical_type& table_schema) {
+        if (table_schema.type() != logical_type::STRUCT) {
+            return false;
+        }
+        for (const auto& child : node.children()) {
+            if (child->type() == logical_plan::node_type::group_t) {
+                return false;
+            }
+        }
+
+        // keep table order, so the generated query does not depend on hashing
+        auto group = logical_plan::make_node_group(node.resource(), node.collection_full_name());
+        for (const auto& column : catalog::to_struct(table_schema).child_types()) {
+            if (columns.count(column.alias())) {
+                group->append_expression(expressions::make_scalar_expression(node.resource(),
+                                                                             expressions::scalar_type::get_field,
+                                                                             expressions::key_t(column.alias())));
+            }
+        }
+
+        if (group->expressions().empty() ||
+            group->expressions().size() == catalog::to_struct(table_schema).child_types().size()) {
+            // nothing matched or nothing to cut, SELECT * is fine
+            return false;
+        }
+        node.append_child(group);
+        return true;
+    }
+
+    bool push_partial_aggregation(logical_plan::node_ptr& node, logical_plan::parameter_node_t* params) {
+        if (node->type() != logical_plan::node_type::aggregate_t ||
+            !node->collection_full_name().unique_identifier.empty()) {
+            return false;
+        }
+
+        // columns read outside of the aggregates: join keys, grouping keys, filters and sorts
+        std::unordered_set<std::string> referenced;
+        logical_plan::node_ptr* group_slot = nullptr;
+        logical_plan::node_ptr* join_slot = nullptr;
+        for (auto& child : node->children()) {
+            switch (child->type()) {
+                case logical_plan::node_type::group_t:
+                    group_slot = &child;
+                    break;
+                case logical_plan::node_type::join_t:
+                    join_slot = &child;
+                    break;
+                case logical_plan::node_type::limit_t:
+                case logical_plan::node_type::match_t:
+                case logical_plan::node_type::sort_t:
+                    for (const auto& expr : child->expressions()) {
+                        if (!collect_expression(expr, referenced)) {
+                            return false;
+                        }
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+        if (!group_slot || !join_slot) {
+            return false;
+        }
+
+        std::vector<logical_plan::node_ptr*> sources;
+        if (!collect_join_sources(*join_slot, sources, referenced) || sources.size() < 2) {
+            return false;
+        }
+
+        // index of the source owning the column, -1 if none does, -2 if it is ambiguous
+        auto owner_of = [&sources](const std::string& column) {
+            int owner = -1;
+            for (size_t i = 0; i < sources.size(); ++i) {
+                const auto& schema = static_cast<const schema_node_t&>(**sources[i]).schema();
+                for (const auto& field : schema.child_types()) {
+                    if (field.alias() == column) {
+                        if (owner != -1) {
+                            return -2;
+                        }
+                        owner = static_cast<int>(i);
+                    }
+                }
+            }
+            return owner;
+        };
+
+        // every aggregate has to read a plain column of the same source
+        const auto& group = *group_slot;
+        int side = -1;
+        bool aggregated = false;
+        for (const auto& expr : group->expressions()) {
+            if (expr->group() != expressions::expression_group::aggregate) {
+                if (!collect_expression(expr, referenced)) {
+                    return false;
+                }
+                continue;
+            }
+            const auto& agg = static_cast<const expressions::aggregate_expression_t&>(*expr);
+            aggregated = true;
+            switch (agg.type()) {
+                case expressions::aggregate_type::count:
+                case expressions::aggregate_type::sum:
+                case expressions::aggregate_type::min:
+                case expressions::aggregate_type::max:
+                    break;
+                default:
+                    // avg could be sent as sum and count, but the final group has no way to divide them
+                    return false;
+            }
+            auto column = aggregate_column(agg);
+            if (column == "*" && agg.type() == expressions::aggregate_type::count) {
+                // counts rows of whichever source is aggregated, partial counts of it sum up to the joined rows
+                continue;
+            }
+            if (column.empty() || column == "*") {
+                return false;
+            }
+            auto owner = owner_of(column);
+            if (owner < 0 || (side != -1 && owner != side)) {
+                return false;
+            }
+            side = owner;
+        }
+        if (!aggregated) {
+            return false;
+        }
+        if (side == -1) {
+            // only COUNT(*), any source will do
+            side = 0;
+        }
+
+        std::unordered_set<std::string> keys;
+        for (const auto& column : referenced) {
+            auto owner = owner_of(column);
+            if (owner == -2) {
+                return false;
+            }
+            if (owner == side) {
+                keys.insert(column);
+            }
+        }
+
+        auto& source = static_cast<schema_node_t&>(**sources[side]);
+        logical_plan::node_aggregate_t agg(*source.agg_node());
+        for (const auto& child : agg.children()) {
+            // a remote sort or limit would apply to groups instead of rows
+            if (child->type() != logical_plan::node_type::group_t &&
+                child->type() != logical_plan::node_type::match_t) {
+                return false;
+            }
+        }
+
+        auto* resource = node->resource();
+        auto partial = logical_plan::make_node_group(resource, agg.collection_full_name());
+        for (const auto& field : source.schema().child_types()) {
+            if (keys.count(field.alias())) {
+                partial->append_expression(expressions::make_scalar_expression(resource,
+                                                                               expressions::scalar_type::get_field,
+                                                                               expressions::key_t(field.alias())));
+            }
+        }
+
+        // count is combined as a sum of counts, the others combine with themselves
+        auto final_group = logical_plan::make_node_group(resource, group->collection_full_name());
+        size_t index = 0;
+        for (const auto& expr : group->expressions()) {
+            if (expr->group() != expressions::expression_group::aggregate) {
+                final_group->append_expression(expr);
+                continue;
+            }
+            const auto& agg_expr = static_cast<const expressions::aggregate_expression_t&>(*expr);
+            expressions::key_t partial_key("__partial_" + std::to_string(index++));
+
+            auto remote = expressions::make_aggregate_expression(resource, agg_expr.type(), partial_key);
+            remote->append_param(expressions::key_t(aggregate_column(agg_expr)));
+            partial->append_expression(remote);
+
+            auto combine = expressions::make_aggregate_expression(resource,
+                                                                  agg_expr.type() == expressions::aggregate_type::count
+                                                                      ? expressions::aggregate_type::sum
+                                                                      : agg_expr.type(),
+                                                                  agg_expr.key());
+            combine->append_param(partial_key);
+            final_group->append_expression(combine);
+        }
+
+        bool replaced = false;
+        for (auto& child : agg.children()) {
+            if (child->type() == logical_plan::node_type::group_t) {
+                child = partial;
+                replaced = true;
+            }
+        }
+        if (!replaced) {
+            agg.append_child(partial);
+        }
+
+        auto name = source.collection_full_name();
+        auto schema = aggregate_filter_schema(agg, params, catalog::schema(resource, source.schema()));
+        auto partial_source = make_node_schema(name, std::move(schema), std::move(agg));
+        // groups never outnumber the rows they come from
+        partial_source->set_estimated_rows(source.estimated_rows());
+        *sources[side] = partial_source;
+        *group_slot = final_group;
+        return true;
+    }
+
+    bool push_join_filters(logical_plan::node_ptr& node) {
+        if (node->type() != logical_plan::node_type::aggregate_t ||
+            !node->collection_full_name().unique_identifier.empty()) {
+            return false;
+        }
+
+        const logical_plan::node_ptr* match = nullptr;
+        logical_plan::node_ptr* join_slot = nullptr;
+        for (auto& child : node->children()) {
+            if (child->type() == logical_plan::node_type::match_t && !child->expressions().empty()) {
+                match = &child;
+            } else if (child->type() == logical_plan::node_type::join_t) {
+                join_slot = &child;
+            }
+        }
+        if (!match || !join_slot) {
+            return false;
+        }
+
+        // outer joins would turn the rows a pushed filter drops into NULL-extended ones
+        std::vector<logical_plan::node_ptr*> sources;
+        std::unordered_set<std::string> join_columns;
+        if (!collect_join_sources(*join_slot, sources, join_columns) || sources.size() < 2) {
+            return false;
+        }
+
+        const auto& where = (*match)->expressions().front();
+        if (where->group() != expressions::expression_group::compare) {
+            return false;
+        }
+        std::vector<expressions::expression_ptr> conjuncts;
+        if (static_cast<const expressions::compare_expression_t&>(*where).type() ==
+            expressions::compare_type::union_and) {
+            conjuncts.assign(where->children().begin(), where->children().end());
+        } else {
+            conjuncts.push_back(where);
+        }
+
+        std::vector<std::vector<expressions::expression_ptr>> pushed(sources.size());
+        for (const auto& conjunct : conjuncts) {
+            std::vector<std::string> keys;
+            compare_keys(static_cast<const expressions::compare_expression_t&>(*conjunct), keys);
+            if (keys.empty()) {
+                continue;
+            }
+            // every key has to resolve to the same single source
+            std::optional<size_t> owner;
+            bool single = true;
+            for (const auto& key : keys) {
+                std::optional<size_t> key_owner;
+                for (size_t i = 0; i < sources.size() && single; ++i) {
+                    if (owns_key(*sources[i], *scan_of(*sources[i]), key)) {
+                        single = !key_owner;
+                        key_owner = i;
+                    }
+                }
+                if (!key_owner || (owner && *owner != *key_owner)) {
+                    single = false;
+                }
+                if (!single) {
+                    break;
+                }
+                owner = key_owner;
+            }
+            if (single && owner) {
+                pushed[*owner].push_back(conjunct);
+            }
+        }
+
+        bool changed = false;
+        auto* resource = node->resource();
+        for (size_t i = 0; i < sources.size(); ++i) {
+            if (pushed[i].empty()) {
+                continue;
+            }
+            auto& source = static_cast<schema_node_t&>(**sources[i]);
+            logical_plan::node_aggregate_t agg(*source.agg_node());
+            if (std::any_of(agg.children().begin(), agg.children().end(), [](const auto& child) {
+                    return child->type() == logical_plan::node_type::limit_t;
+                })) {
+                // the backend would filter the limited rows instead of limiting the filtered ones
+                continue;
+            }
+
+            // an existing filter of the scan is and-ed with the pushed conjuncts
+            logical_plan::node_ptr* scan_match = nullptr;
+            for (auto& child : agg.children()) {
+                if (child->type() == logical_plan::node_type::match_t && !child->expressions().empty()) {
+                    scan_match = &child;
+                }
+            }
+            if (scan_match) {
+                pushed[i].insert(pushed[i].begin(), (*scan_match)->expressions().front());
+            }
+            expressions::expression_ptr filter = pushed[i].front();
+            if (pushed[i].size() > 1) {
+                auto conjunction =
+                    expressions::make_compare_union_expression(resource, expressions::compare_type::union_and);
+                for (const auto& conjunct : pushed[i]) {
+                    conjunction->append_child(conjunct);
+                }
+                filter = conjunction;
+            }
+
+            auto name = source.collection_full_name();
+            auto scan_filter = logical_plan::make_node_match(resource, name, std::move(filter));
+            if (scan_match) {
+                *scan_match = scan_filter;
+            } else {
+                agg.append_child(scan_filter);
+            }
+
+            // a filter never changes the columns, only the rows
+            auto schema = source.schema();
+            auto estimated_rows = source.estimated_rows();
+            auto filtered = make_node_schema(name, std::move(schema), std::move(agg));
+            filtered->set_estimated_rows(estimated_rows);
+            *sources[i] = filtered;
+            changed = true;
+        }
+        return changed;
+    }
+
+    std::vector<semi_join_t> plan_semi_joins(const logical_plan::node_ptr& node,
+                                             const std::vector<logical_plan::node_ptr*>& batch) {
+        std::vector<semi_join_t> semi_joins;
+        if (batch.size() < 2) {
+            return semi_joins;
+        }
+        auto slot_index = [&batch](const logical_plan::node_ptr& child) -> std::optional<size_t> {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                if (batch[i] == &child) {
+                    return i;
+                }
+            }
+            return std::nullopt;
+        };
+
+        std::vector<bool> used(batch.size(), false);
+        std::deque<const logical_plan::node_ptr*> nodes_lookup{&node};
+        while (!nodes_lookup.empty()) {
+            const auto& n = *nodes_lookup.front();
+            nodes_lookup.pop_front();
+            for (const auto& child : n->children()) {
+                nodes_lookup.push_back(&child);
+            }
+            if (n->type() != logical_plan::node_type::join_t || n->children().size() != 2 ||
+                n->expressions().size() != 1 ||
+                static_cast<const logical_plan::node_join_t&>(*n).type() != logical_plan::join_type::inner) {
+                continue;
+            }
+
+            auto left = slot_index(n->children().front());
+            auto right = slot_index(n->children().back());
+            if (!left || !right || used[*left] || used[*right]) {
+                continue;
+            }
+            const auto* left_scan = scan_of(n->children().front());
+            const auto* right_scan = scan_of(n->children().back());
+            if (!left_scan || !right_scan) {
+                continue;
+            }
+            const auto left_rows = estimated_rows(n->children().front());
+            const auto right_rows = estimated_rows(n->children().back());
+            bool left_reduces;
+            if (left_rows >= 0 && right_rows >= 0) {
+                if (std::min(left_rows, right_rows) * SEMI_JOIN_MIN_RATIO > std::max(left_rows, right_rows)) {
+                    // sides of similar size, a reduction would save less than it delays the target
+                    continue;
+                }
+                left_reduces = left_rows < right_rows;
+            } else if (has_filter(*left_scan) != has_filter(*right_scan)) {
+                left_reduces = has_filter(*left_scan);
+            } else {
+                continue;
+            }
+
+            const auto& expr = n->expressions().front();
+            if (expr->group() != expressions::expression_group::compare) {
+                continue;
+            }
+            const auto& compare = static_cast<const expressions::compare_expression_t&>(*expr);
+            if (compare.type() != expressions::compare_type::eq || compare.key_left().is_null() ||
+                compare.key_right().is_null()) {
+                continue;
+            }
+
+            auto key_left = compare.key_left().as_string();
+            auto key_right = compare.key_right().as_string();
+            const auto& left_slot = n->children().front();
+            const auto& right_slot = n->children().back();
+            if (!owns_key(left_slot, *left_scan, key_left) || !owns_key(right_slot, *right_scan, key_right)) {
+                if (!owns_key(left_slot, *left_scan, key_right) || !owns_key(right_slot, *right_scan, key_left)) {
+                    continue;
+                }
+                std::swap(key_left, key_right);
+            }
+
+            // keys are looked up in the fetched rows and the backend table, both know them unqualified
+            if (left_reduces) {
+                semi_joins.push_back({*left, *right, column_name(key_left), column_name(key_right), right_rows});
+            } else {
+                semi_joins.push_back({*right, *left, column_name(key_right), column_name(key_left), left_rows});
+            }
+            used[*left] = used[*right] = true;
+        }
+        return semi_joins;
+    }
+
+    int64_t estimate_rows(const logical_plan::node_aggregate_t& node, const table_stats_t& stats) {
+        if (stats.rows < 0) {
+            return -1;
+        }
+        auto rows = static_cast<double>(stats.rows);
+        // children are applied in the order the backend does: filter, group, limit
+        for (const auto& child : node.children()) {
+            if (child->type() == logical_plan::node_type::match_t && !child->expressions().empty()) {
+                const auto& expr = child->expressions().front();
+                rows *= selectivity(static_cast<const expressions::compare_expression_t&>(*expr), stats);
+            }
+        }
+        for (const auto& child : node.children()) {
+            if (child->type() == logical_plan::node_type::group_t) {
+                rows = group_rows(*child, rows, stats);
+            }
+        }
+        for (const auto& child : node.children()) {
+            if (child->type() == logical_plan::node_type::limit_t) {
+                const auto limit = static_cast<const logical_plan::node_limit_t&>(*child).limit().limit();
+                if (limit >= 0) {
+                    rows = std::min(rows, static_cast<double>(limit));
+                }
+            }
+        }
+        return std::llround(rows);
+    }
+
+    void infer_parameter_types(const logical_plan::node_aggregate_t& node,
+                               const complex_logical_type& table_schema,
+                               std::vector<complex_logical_type>& types) {
+        for (const auto& child : node.children()) {
+            if (child->type() == logical_plan::node_type::match_t && !child->expressions().empty()) {
+                const auto& expr = child->expressions().front();
+                compare_parameter_types(static_cast<const expressions::compare_expression_t&>(*expr),
+                                        table_schema,
+                                        types);
+            }
+        }
+    }
+
+    key_shipping choose_key_shipping(size_t reducer_rows, int64_t target_rows) {
+        if (reducer_rows <= SEMI_JOIN_IN_LIST_LIMIT) {
+            return key_shipping::in_list;
+        }
+        // uploading the keys costs about as much as downloading that many target rows
+        if (reducer_rows > SEMI_JOIN_KEY_TABLE_LIMIT ||
+            (target_rows >= 0 && static_cast<size_t>(target_rows) <= reducer_rows)) {
+            return key_shipping::range;
+        }
+        return key_shipping::key_table;
+    }
+
     complex_logical_type merge_schemas(const complex_logical_type& sch1, const complex_logical_type& sch2) {
         if (sch1.type() != sch2.type() || sch1.type() != logical_type::STRUCT) {
             return logical_type::NA;
@@ -6,13 +6,21 @@
 #include <components/catalog/schema.hpp>
 #include <components/cursor/cursor.hpp>
 #include <components/expressions/aggregate_expression.hpp>
+#include <components/expressions/compare_expression.hpp>
 #include <components/expressions/scalar_expression.hpp>
+#include <components/expressions/sort_expression.hpp>
 #include <components/logical_plan/node_aggregate.hpp>
 #include <components/logical_plan/node_group.hpp>
 #include <components/logical_plan/node_join.hpp>
 #include <components/logical_plan/param_storage.hpp>
 #include <components/types/types.hpp>
 
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace schema_utils {
     // used during schema computation, replaces external nodes in main node (like node_raw_data does during execute())
     // generate query during schema analysis
@@ -24,6 +32,9 @@ namespace schema_utils {
 
         const components::types::complex_logical_type& schema() const;
         const components::logical_plan::node_aggregate_ptr agg_node();
+        // rows the backend is expected to return, -1 if unknown
+        int64_t estimated_rows() const noexcept;
+        void set_estimated_rows(int64_t rows) noexcept;
 
     private:
         components::expressions::hash_t hash_impl() const final;
@@ -32,6 +43,7 @@ namespace schema_utils {
 
         components::types::complex_logical_type schema_;
         components::logical_plan::node_aggregate_ptr agg_node_;
+        int64_t estimated_rows_ = -1;
     };
 
     using node_schema_ptr = boost::intrusive_ptr<schema_node_t>;
@@ -58,6 +70,76 @@ namespace schema_utils {
                         components::cursor::cursor_t_ptr catalog,
                         const std::pmr::map<collection_full_name_t, size_t>& dependencies);
 
+    // columns the plan reads from its external nodes (join keys, projection, filters, sorts),
+    // nullopt if every column may be needed: SELECT *, external root or a node we can't look into
+    std::optional<std::unordered_set<std::string>> required_columns(const components::logical_plan::node_ptr& node);
+
+    // turns SELECT * of an external aggregate into a projection of the required table columns,
+    // returns false if the node is left as is
+    bool prune_projection(components::logical_plan::node_aggregate_t& node,
+                          const std::unordered_set<std::string>& columns,
+                          const components::types::complex_logical_type& table_schema);
+
+    // two-phase aggregation of a group over inner joins: when every aggregate reads the same source, that source
+    // sends partial aggregates grouped by the keys the rest of the plan needs (count, sum, min, max) and the
+    // group in otterbrix combines them. COUNT(*) goes to any source, AVG keeps the plan as is since the group
+    // can't divide a combined sum by a combined count. returns false if the plan is left as is
+    bool push_partial_aggregation(components::logical_plan::node_ptr& node,
+                                  components::logical_plan::parameter_node_t* params);
+
+    // statistics of a remote table as reported by the backend, -1 when unknown
+    struct table_stats_t {
+        int64_t rows = -1;
+        int64_t avg_row_length = -1;
+        // distinct values of the leading column of each index
+        std::unordered_map<std::string, int64_t> index_cardinality;
+    };
+
+    // rows an external aggregate over a single table returns: filters, grouping and limit applied to the table
+    // rows. -1 if the table size is unknown
+    int64_t estimate_rows(const components::logical_plan::node_aggregate_t& node, const table_stats_t& stats);
+
+    // parameters the filter of an external aggregate compares with a column of its table get that column's type,
+    // types already known and parameters past the end of types are left as they are
+    void infer_parameter_types(const components::logical_plan::node_aggregate_t& node,
+                               const components::types::complex_logical_type& table_schema,
+                               std::vector<components::types::complex_logical_type>& types);
+
+    // conjuncts of the WHERE over inner joins whose columns all belong to one source are copied into that
+    // source's query, the local filter stays in place. returns false if no source got a filter
+    bool push_join_filters(components::logical_plan::node_ptr& node);
+
+    // inner equi-join of two scans running in the same batch: the reducer is sent first and the distinct
+    // values of its key restrict the target's query. indexes point into the batch
+    struct semi_join_t {
+        size_t reducer;
+        size_t target;
+        std::string reducer_key;
+        std::string target_key;
+        int64_t target_rows = -1;
+    };
+
+    // with row estimates for both scans the smaller one reduces the other when it is sufficiently smaller,
+    // otherwise both are fetched whole and joined locally. without estimates a scan with its own filter reduces
+    // an unfiltered one. scans take part in one semi-join at most
+    std::vector<semi_join_t> plan_semi_joins(const components::logical_plan::node_ptr& node,
+                                             const std::vector<components::logical_plan::node_ptr*>& batch);
+
+    // how the reducer's keys reach the target's backend
+    enum class key_shipping
+    {
+        in_list,
+        range,
+        key_table,
+    };
+
+    constexpr size_t SEMI_JOIN_IN_LIST_LIMIT = 1000;
+    constexpr size_t SEMI_JOIN_KEY_TABLE_LIMIT = 100000;
+
+    // decided from the rows the reducer actually returned and the target's estimate: a key table is only
+    // loaded when it is smaller than what it saves, a range costs nothing to send
+    key_shipping choose_key_shipping(size_t reducer_rows, int64_t target_rows);
+
     components::types::complex_logical_type merge_schemas(const components::types::complex_logical_type& sch1,
                                                           const components::types::complex_logical_type& sch2);
 } // namespace schema_utils
@@ -11,4 +11,11 @@ struct mock_config {
     bool return_empty = false;
     std::chrono::milliseconds wait_time = std::chrono::milliseconds(50);
     std::string error_message = "";
+    // rows of a streamed result and how many of them arrive per read
+    size_t stream_rows = 2;
+    size_t stream_batch_rows = 1;
+    // parsed statements report one parameter per '$' of the text instead of none
+    bool count_parameters = false;
+    // parsed statements read no remote table, so they are described without the catalog
+    bool local = false;
 };
@@ -6,15 +6,26 @@
 #include "mock_config.hpp"
 #include "otterbrix/parser/parser.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 
+// parse calls running at the same time and in total, shared by the parsers of one test
+struct parse_probe_t {
+    std::atomic<size_t> active{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> calls{0};
+};
+
 class SimpleMockParser : public IParser {
 public:
-    SimpleMockParser(mock_config config = {})
-        : config_(config) {
+    SimpleMockParser(mock_config config = {}, std::shared_ptr<parse_probe_t> probe = nullptr)
+        : config_(config)
+        , probe_(std::move(probe)) {
         std::cout << "MockParser created with config:" << std::endl;
         std::cout << "can_throw: " << config_.can_throw << std::endl;
         std::cout << "return_empty: " << config_.return_empty << std::endl;
@@ -30,8 +41,19 @@ public:
             std::cout << error_message << std::endl;
             throw std::runtime_error(error_message);
         }
+        if (probe_) {
+            ++probe_->calls;
+            auto active = ++probe_->active;
+            auto peak = probe_->peak.load();
+            while (peak < active && !probe_->peak.compare_exchange_weak(peak, active)) {
+            }
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(config_.wait_time)); // Simulate some processing delay
+        if (probe_) {
+            --probe_->active;
+        }
 
+        const size_t parameters = config_.count_parameters ? std::count(sql.begin(), sql.end(), '$') : 0;
         auto resource = std::pmr::get_default_resource();
         auto binder =
             sql::transform::transform_result(logical_plan::make_node_aggregate(resource, {"1", "db", "", "table"}),
@@ -43,7 +65,8 @@ public:
             std::make_unique<OtterbrixStatement>(std::vector<std::vector<logical_plan::node_ptr*>>{},
                                                  binder.params_ptr(),
                                                  binder.node_ptr(),
-                                                 1),
+                                                 config_.local ? 0u : 1u,
+                                                 parameters),
             std::move(binder),
             NodeTag::T_SelectStmt);
         parsed->otterbrix_params->external_nodes.push_back({&parsed->otterbrix_params->node});
@@ -52,6 +75,7 @@ public:
 
 private:
     mock_config config_;
+    std::shared_ptr<parse_probe_t> probe_;
 };
 
 inline parser_ptr make_mock_parser() { return std::make_unique<SimpleMockParser>(); }
\ No newline at end of file
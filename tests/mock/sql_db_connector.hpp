@@ -12,8 +12,11 @@
 #include <boost/mysql/any_address.hpp>
 #include <boost/mysql/any_connection.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace mysqlc {
 
@@ -47,6 +50,13 @@ namespace mysqlc {
 
         std::string alias() const noexcept override { return "mock_connector"; }
 
+        asio::awaitable<void> async_connect() override {
+            connect();
+            co_return;
+        }
+
+        asio::awaitable<bool> async_ping() override { co_return isConnected(); }
+
         asio::awaitable<std::unique_ptr<data_chunk_t>>
         runQuery(std::string_view query,
                  std::function<std::unique_ptr<data_chunk_t>(const boost::mysql::results&)> handler) override {
@@ -92,6 +102,36 @@ namespace mysqlc {
                  std::function<components::catalog::catalog_error(const boost::mysql::results&)> handler) override {
             throw std::runtime_error("Unimplemented");
         }
+        asio::awaitable<void> runStreamingQuery(std::string_view query, tsl::mysql_chunk_stream_t& stream) override {
+            // rows (i, "name_i") arrive in reads of stream_batch_rows, like read_some_rows batches
+            std::cout << "MockConnector streaming query: " << query << std::endl;
+            if (config_.can_throw) {
+                throw std::runtime_error(config_.error_message.empty() ? "MockConnector: exception in runQuery"
+                                                                       : config_.error_message);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(config_.wait_time));
+            std::pmr::vector<components::types::complex_logical_type> fields(std::pmr::get_default_resource());
+            fields.emplace_back(types::logical_type::INTEGER, "id");
+            fields.emplace_back(types::logical_type::STRING_LITERAL, "name");
+            stream.resolve({tsl::impl::column_decoder_t::int32, tsl::impl::column_decoder_t::string},
+                           std::move(fields));
+
+            const size_t total = config_.return_empty ? 0 : config_.stream_rows;
+            const size_t batch_rows = std::max<size_t>(config_.stream_batch_rows, 1);
+            for (size_t begin = 0; begin < total; begin += batch_rows) {
+                std::vector<std::string> names;
+                std::vector<std::vector<boost::mysql::field_view>> rows;
+                for (size_t i = begin; i < std::min(total, begin + batch_rows); ++i) {
+                    names.push_back("name_" + std::to_string(i));
+                }
+                for (size_t i = 0; i < names.size(); ++i) {
+                    rows.push_back({boost::mysql::field_view(static_cast<int64_t>(begin + i)),
+                                    boost::mysql::field_view(std::string_view(names[i]))});
+                }
+                stream.append_rows(rows);
+            }
+            co_return;
+        }
 
     private:
         mock_config config_;
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "connectors/connection_pool.hpp"
+
+#include "../mock/sql_db_connector.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+    mysqlc::connection_pool_ptr make_pool(boost::asio::io_context& ctx, mysqlc::pool_config config) {
+        auto pool = std::make_shared<mysqlc::ConnectionPool>(ctx,
+                                                             make_mysql_mock_connector,
+                                                             boost::mysql::connect_params{},
+                                                             "pool_test",
+                                                             config);
+        pool->start();
+        return pool;
+    }
+
+    // a blocking connect would stall the io context, waiters served there have to use async_connect()
+    class AsyncOnlyConnector : public mysqlc::MockConnector {
+    public:
+        void connect() override { throw std::runtime_error("blocking connect on the io context"); }
+
+        boost::asio::awaitable<void> async_connect() override {
+            boost::asio::steady_timer delay(co_await boost::asio::this_coro::executor, 20ms);
+            co_await delay.async_wait(boost::asio::use_awaitable);
+        }
+    };
+} // namespace
+
+TEST_CASE("connection pool grows up to max size") {
+    boost::asio::io_context ctx;
+    auto pool = make_pool(ctx, {.min_size = 1, .max_size = 2, .checkout_timeout = 50ms});
+    REQUIRE(pool->size() == 1);
+    REQUIRE(pool->idle() == 1);
+
+    auto first = pool->acquire();
+    auto second = pool->acquire();
+    REQUIRE(pool->size() == 2);
+    REQUIRE(pool->idle() == 0);
+    REQUIRE_THROWS(pool->acquire());
+
+    { auto released = std::move(first); }
+    REQUIRE(pool->idle() == 1);
+    auto third = pool->acquire();
+    REQUIRE(third);
+    REQUIRE(pool->size() == 2);
+}
+
+TEST_CASE("connection pool hands released connector to waiter") {
+    boost::asio::io_context ctx;
+    auto pool = make_pool(ctx, {.min_size = 1, .max_size = 1, .checkout_timeout = 5s});
+
+    auto held = pool->acquire();
+    auto waiter = std::async(std::launch::async, [&pool] { return pool->acquire(); });
+    REQUIRE(waiter.wait_for(50ms) == std::future_status::timeout);
+
+    { auto released = std::move(held); }
+    auto conn = waiter.get();
+    REQUIRE(conn);
+    REQUIRE(pool->size() == 1);
+}
+
+TEST_CASE("connection pool evicts idle connectors down to min size") {
+    boost::asio::io_context ctx;
+    auto pool = make_pool(ctx, {.min_size = 1, .max_size = 3, .idle_timeout = 0ms});
+
+    {
+        auto a = pool->acquire();
+        auto b = pool->acquire();
+        auto c = pool->acquire();
+        REQUIRE(pool->size() == 3);
+    }
+    REQUIRE(pool->size() == 1);
+    REQUIRE(pool->idle() == 1);
+}
+
+TEST_CASE("connection pool drops invalidated connectors") {
+    boost::asio::io_context ctx;
+    auto pool = make_pool(ctx, {.min_size = 0, .max_size = 2});
+
+    {
+        auto conn = pool->acquire();
+        conn.invalidate();
+    }
+    REQUIRE(pool->idle() == 0);
+    REQUIRE(pool->size() == 0);
+
+    pool->close();
+    REQUIRE(pool->isClosed());
+    REQUIRE_THROWS(pool->acquire());
+}
+
+TEST_CASE("connection pool serves asynchronous waiters in order") {
+    boost::asio::io_context ctx;
+    auto guard = boost::asio::make_work_guard(ctx);
+    std::jthread runner([&ctx] { ctx.run(); });
+    auto pool = make_pool(ctx, {.min_size = 1, .max_size = 1});
+
+    auto held = pool->acquire();
+    std::promise<int> first;
+    std::promise<int> second;
+    std::vector<mysqlc::PooledConnector> granted(2);
+    pool->async_acquire([&](std::exception_ptr err, mysqlc::PooledConnector conn) {
+        granted[0] = std::move(conn);
+        first.set_value(1);
+    });
+    pool->async_acquire([&](std::exception_ptr err, mysqlc::PooledConnector conn) {
+        granted[1] = std::move(conn);
+        second.set_value(2);
+    });
+    auto first_done = first.get_future();
+    auto second_done = second.get_future();
+    REQUIRE(first_done.wait_for(50ms) == std::future_status::timeout);
+
+    { auto released = std::move(held); }
+    REQUIRE(first_done.get() == 1);
+    REQUIRE(second_done.wait_for(50ms) == std::future_status::timeout);
+
+    { auto released = std::move(granted[0]); }
+    REQUIRE(second_done.get() == 2);
+    REQUIRE(granted[1]);
+
+    { auto released = std::move(granted[1]); }
+    guard.reset();
+    ctx.stop();
+}
+
+TEST_CASE("connection pool times out asynchronous waiters") {
+    boost::asio::io_context ctx;
+    auto guard = boost::asio::make_work_guard(ctx);
+    std::jthread runner([&ctx] { ctx.run(); });
+    auto pool = make_pool(ctx, {.min_size = 1, .max_size = 1, .checkout_timeout = 20ms});
+
+    auto held = pool->acquire();
+    std::promise<std::exception_ptr> expired;
+    pool->async_acquire([&](std::exception_ptr err, mysqlc::PooledConnector conn) {
+        REQUIRE_FALSE(conn);
+        expired.set_value(err);
+    });
+    auto expired_done = expired.get_future();
+    REQUIRE(expired_done.wait_for(2s) == std::future_status::ready);
+    REQUIRE(expired_done.get() != nullptr);
+
+    // the expired waiter no longer holds the queue, a free connector goes to the next one
+    { auto released = std::move(held); }
+    std::promise<bool> served;
+    mysqlc::PooledConnector granted;
+    pool->async_acquire([&](std::exception_ptr err, mysqlc::PooledConnector conn) {
+        granted = std::move(conn);
+        served.set_value(err == nullptr);
+    });
+    REQUIRE(served.get_future().get());
+    REQUIRE(granted);
+
+    { auto released = std::move(granted); }
+    pool->close();
+    guard.reset();
+    ctx.stop();
+}
+
+TEST_CASE("connection pool with zero min size opens connectors on demand") {
+    boost::asio::io_context ctx;
+    auto pool = make_pool(ctx, {.min_size = 0, .max_size = 2});
+    REQUIRE(pool->size() == 0);
+
+    auto conn = pool->acquire();
+    REQUIRE(conn);
+    REQUIRE(pool->size() == 1);
+}
+
+TEST_CASE("connection pool evicts idle connectors without a release") {
+    boost::asio::io_context ctx;
+    auto guard = boost::asio::make_work_guard(ctx);
+    std::jthread runner([&ctx] { ctx.run(); });
+    auto pool = make_pool(ctx, {.min_size = 0, .max_size = 2, .idle_timeout = 20ms});
+
+    {
+        auto a = pool->acquire();
+        auto b = pool->acquire();
+    }
+    REQUIRE(pool->idle() == 2);
+
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (pool->size() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    REQUIRE(pool->size() == 0);
+    REQUIRE(pool->idle() == 0);
+
+    pool->close();
+    guard.reset();
+    ctx.stop();
+}
+
+TEST_CASE("connection pool connects for asynchronous waiters without blocking") {
+    boost::asio::io_context ctx;
+    auto guard = boost::asio::make_work_guard(ctx);
+    std::jthread runner([&ctx] { ctx.run(); });
+    auto pool = std::make_shared<mysqlc::ConnectionPool>(
+        ctx,
+        [](boost::asio::io_context&, boost::mysql::connect_params, std::string) {
+            return std::make_unique<AsyncOnlyConnector>();
+        },
+        boost::mysql::connect_params{},
+        "pool_test",
+        mysqlc::pool_config{.min_size = 0, .max_size = 1});
+    pool->start();
+
+    std::promise<bool> served;
+    mysqlc::PooledConnector granted;
+    pool->async_acquire([&](std::exception_ptr err, mysqlc::PooledConnector conn) {
+        granted = std::move(conn);
+        served.set_value(err == nullptr);
+    });
+    // the single io thread keeps running other work while the connector connects
+    std::promise<void> other;
+    boost::asio::post(ctx, [&other] { other.set_value(); });
+    REQUIRE(other.get_future().wait_for(2s) == std::future_status::ready);
+
+    auto served_done = served.get_future();
+    REQUIRE(served_done.wait_for(2s) == std::future_status::ready);
+    REQUIRE(served_done.get());
+    REQUIRE(granted);
+    REQUIRE(pool->size() == 1);
+
+    { auto released = std::move(granted); }
+    pool->close();
+    guard.reset();
+    ctx.stop();
+}
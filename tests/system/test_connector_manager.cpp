@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "catalog/catalog_manager.hpp"
+#include "connectors/mysql_manager.hpp"
+
+#include "../mock/mock_config.hpp"
+#include "../mock/sql_db_connector.hpp"
+
+#include <actor-zeta.hpp>
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <string>
+
+using namespace std::chrono_literals;
+
+namespace {
+    mysqlc::connector_factory mock_factory(mock_config config) {
+        return [config](boost::asio::io_context&, boost::mysql::connect_params, std::string) {
+            return std::make_unique<mysqlc::MockConnector>(config);
+        };
+    }
+
+    using streamed_result_t = mysqlc::ConnectorManager::streamed_result_t;
+
+    std::future<streamed_result_t> stream_query(mysqlc::ConnectorManager& manager, const std::string& uuid) {
+        auto promise = std::make_shared<std::promise<streamed_result_t>>();
+        manager.executeStreamingQuery(uuid,
+                                      "SELECT id, name FROM t",
+                                      std::pmr::get_default_resource(),
+                                      [promise](std::exception_ptr error, streamed_result_t result) {
+                                          if (error) {
+                                              promise->set_exception(error);
+                                          } else {
+                                              promise->set_value(std::move(result));
+                                          }
+                                      });
+        return promise->get_future();
+    }
+
+    std::future<streamed_result_t> stream_script(mysqlc::ConnectorManager& manager,
+                                                 const std::string& uuid,
+                                                 std::vector<std::string> setup,
+                                                 std::string cleanup,
+                                                 size_t expected_rows = 0) {
+        auto promise = std::make_shared<std::promise<streamed_result_t>>();
+        manager.executeStreamingScript(uuid,
+                                       std::move(setup),
+                                       "SELECT id, name FROM t WHERE id IN (SELECT k FROM keys_0)",
+                                       std::move(cleanup),
+                                       std::pmr::get_default_resource(),
+                                       expected_rows,
+                                       [promise](std::exception_ptr error, streamed_result_t result) {
+                                           if (error) {
+                                               promise->set_exception(error);
+                                           } else {
+                                               promise->set_value(std::move(result));
+                                           }
+                                       });
+        return promise->get_future();
+    }
+} // namespace
+
+TEST_CASE("connector manager: streamed rows arrive in order across reads") {
+    auto resource = std::pmr::get_default_resource();
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    mysqlc::ConnectorManager manager(catalog_manager->address(),
+                                     mock_factory({.wait_time = 0ms, .stream_rows = 10, .stream_batch_rows = 3}),
+                                     2);
+    manager.start();
+    manager.addConnection(boost::mysql::connect_params{}, "1");
+
+    auto future = stream_query(manager, "1");
+    REQUIRE(future.wait_for(5s) == std::future_status::ready);
+    auto result = future.get();
+    REQUIRE(result.rows == 10);
+    REQUIRE(result.bytes > 0);
+
+    size_t row = 0;
+    for (const auto& chunk : result.chunks) {
+        REQUIRE(chunk->size() <= tsl::mysql_chunk_stream_t::DEFAULT_CHUNK_ROWS);
+        for (size_t i = 0; i < chunk->size(); ++i, ++row) {
+            REQUIRE(chunk->data[0].data<int32_t>()[i] == static_cast<int32_t>(row));
+            REQUIRE(chunk->data[1].data<std::string_view>()[i] == "name_" + std::to_string(row));
+        }
+    }
+    REQUIRE(row == 10);
+    manager.stop();
+}
+
+TEST_CASE("connector manager: streaming error reaches the handler") {
+    auto resource = std::pmr::get_default_resource();
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    mysqlc::ConnectorManager manager(catalog_manager->address(),
+                                     mock_factory({.can_throw = true, .error_message = "stream failed"}),
+                                     2);
+    manager.start();
+    manager.addConnection(boost::mysql::connect_params{}, "1");
+
+    auto future = stream_query(manager, "1");
+    REQUIRE(future.wait_for(5s) == std::future_status::ready);
+    REQUIRE_THROWS_WITH(future.get(), "stream failed");
+
+    auto missing = stream_query(manager, "unknown");
+    REQUIRE(missing.wait_for(5s) == std::future_status::ready);
+    REQUIRE_THROWS(missing.get());
+    manager.stop();
+}
+
+TEST_CASE("connector manager: streaming script runs its statements around the query") {
+    auto resource = std::pmr::get_default_resource();
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    mysqlc::ConnectorManager manager(catalog_manager->address(),
+                                     mock_factory({.wait_time = 0ms, .stream_rows = 4, .stream_batch_rows = 2}),
+                                     1);
+    manager.start();
+    manager.addConnection(boost::mysql::connect_params{}, "1");
+
+    auto future = stream_script(manager,
+                                "1",
+                                {"CREATE TEMPORARY TABLE keys_0 (k int8);", "INSERT INTO keys_0 VALUES (1), (2);"},
+                                "DROP TEMPORARY TABLE IF EXISTS keys_0;");
+    REQUIRE(future.wait_for(5s) == std::future_status::ready);
+    REQUIRE(future.get().rows == 4);
+
+    // the single connection went back to the pool after the cleanup
+    auto plain = stream_query(manager, "1");
+    REQUIRE(plain.wait_for(5s) == std::future_status::ready);
+    REQUIRE(plain.get().rows == 4);
+    manager.stop();
+}
+
+TEST_CASE("connector manager: failing script statement reaches the handler") {
+    auto resource = std::pmr::get_default_resource();
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    mysqlc::ConnectorManager manager(catalog_manager->address(),
+                                     mock_factory({.can_throw = true, .error_message = "setup failed"}),
+                                     1);
+    manager.start();
+    manager.addConnection(boost::mysql::connect_params{}, "1");
+
+    auto future = stream_script(manager, "1", {"CREATE TEMPORARY TABLE keys_0 (k int8);"}, {});
+    REQUIRE(future.wait_for(5s) == std::future_status::ready);
+    REQUIRE_THROWS_WITH(future.get(), "setup failed");
+
+    // an invalidated connection is replaced, the next lease doesn't wait forever
+    auto next = stream_script(manager, "1", {}, {});
+    REQUIRE(next.wait_for(5s) == std::future_status::ready);
+    REQUIRE_THROWS_WITH(next.get(), "setup failed");
+    manager.stop();
+}
@@ -19,6 +19,9 @@
 
 #include <catch2/catch.hpp>
 #include <chrono>
+#include <latch>
+#include <thread>
+#include <vector>
 
 namespace {
     otterbrix::otterbrix_ptr init_otterbrix() {
@@ -286,4 +289,249 @@ TEST_CASE("return empty test case") {
     std::cout << "[Main thread] " << std::this_thread::get_id() << " check data" << std::endl;
     REQUIRE(shared_data->status() == cv_wrapper::Status::Empty);
     REQUIRE(shared_data->result.chunk.empty() == true);
-}
\ No newline at end of file
+}
+TEST_CASE("sharded scheduler test case") {
+    using namespace std::chrono_literals;
+
+    otterbrix::otterbrix_ptr otterbrix = init_otterbrix();
+    auto resource = std::pmr::get_default_resource();
+    assert(resource);
+
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    auto conn_manager =
+        std::make_shared<mysqlc::ConnectorManager>(catalog_manager->address(), make_mysql_mock_connector);
+
+    conn_manager->addConnection(boost::mysql::connect_params{}, "1");
+    conn_manager->addConnection(boost::mysql::connect_params{}, "2");
+
+    auto otterbrix_manager =
+        actor_zeta::spawn_supervisor<db_conn::OtterbrixManager>(resource,
+                                                                std::make_unique<SimpleMockOtterbrixManager>());
+    auto sql_conn_manager = actor_zeta::spawn_supervisor<db_conn::SqlConnectionManager>(resource, conn_manager);
+
+    constexpr size_t shards = 4;
+    auto probe = std::make_shared<parse_probe_t>();
+    std::vector<parser_ptr> parsers;
+    for (size_t i = 0; i < shards; ++i) {
+        parsers.push_back(std::make_unique<SimpleMockParser>(mock_config{.wait_time = 100ms}, probe));
+    }
+    auto scheduler = actor_zeta::spawn_supervisor<Scheduler>(resource,
+                                                             std::move(parsers),
+                                                             sql_conn_manager->address(),
+                                                             otterbrix_manager->address(),
+                                                             catalog_manager->address());
+    assert(scheduler);
+    REQUIRE(scheduler->shard_count() == shards);
+
+    // one session per shard, sent from separate threads so parsing overlaps
+    std::vector<shared_flight_data> results;
+    for (size_t i = 0; i < shards; ++i) {
+        results.push_back(create_cv_wrapper(flight_data(resource)));
+    }
+    std::latch start(shards);
+    std::vector<std::jthread> clients;
+    for (session_hash_t id = 0; id < shards; ++id) {
+        clients.emplace_back([&, id] {
+            start.arrive_and_wait();
+            actor_zeta::send(scheduler->address(),
+                             scheduler->address(),
+                             scheduler::handler_id(scheduler::route::execute),
+                             id,
+                             results[id],
+                             std::string("SELECT 1 AS test"));
+        });
+    }
+    clients.clear();
+
+    for (auto& shared_data : results) {
+        shared_data->wait_for(5000ms);
+        REQUIRE(shared_data->status() == cv_wrapper::Status::Ok);
+        REQUIRE(shared_data->result.chunk.size() == 2);
+    }
+    // handlers are not serialized, sessions of different shards were parsed at the same time
+    REQUIRE(probe->peak.load() > 1);
+}
+
+TEST_CASE("unknown prepared statement test case") {
+    using namespace std::chrono_literals;
+
+    otterbrix::otterbrix_ptr otterbrix = init_otterbrix();
+    auto resource = std::pmr::get_default_resource();
+
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    auto conn_manager =
+        std::make_shared<mysqlc::ConnectorManager>(catalog_manager->address(), make_mysql_mock_connector);
+    auto otterbrix_manager =
+        actor_zeta::spawn_supervisor<db_conn::OtterbrixManager>(resource,
+                                                                std::make_unique<SimpleMockOtterbrixManager>());
+    auto sql_conn_manager = actor_zeta::spawn_supervisor<db_conn::SqlConnectionManager>(resource, conn_manager);
+    auto scheduler = actor_zeta::spawn_supervisor<Scheduler>(resource,
+                                                             std::make_unique<SimpleMockParser>(),
+                                                             sql_conn_manager->address(),
+                                                             otterbrix_manager->address(),
+                                                             catalog_manager->address());
+    assert(scheduler);
+
+    // never prepared: the session is answered right away instead of waiting for its timeout
+    session_hash_t id = 42;
+    auto shared_data = create_cv_wrapper(flight_data(resource));
+    actor_zeta::send(scheduler->address(),
+                     scheduler->address(),
+                     scheduler::handler_id(scheduler::route::execute_prepared_statement),
+                     id,
+                     std::pmr::vector<components::types::logical_value_t>(resource),
+                     shared_data);
+    shared_data->wait_for(100ms);
+    REQUIRE(shared_data->status() == cv_wrapper::Status::Error);
+    REQUIRE(shared_data->error_message().find("not found") != std::string::npos);
+}
+
+TEST_CASE("prepared literals are not parameters test case") {
+    using namespace std::chrono_literals;
+
+    otterbrix::otterbrix_ptr otterbrix = init_otterbrix();
+    auto resource = std::pmr::get_default_resource();
+
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    auto conn_manager =
+        std::make_shared<mysqlc::ConnectorManager>(catalog_manager->address(), make_mysql_mock_connector);
+    conn_manager->addConnection(boost::mysql::connect_params{}, "1");
+    auto otterbrix_manager =
+        actor_zeta::spawn_supervisor<db_conn::OtterbrixManager>(resource,
+                                                                std::make_unique<SimpleMockOtterbrixManager>());
+    auto sql_conn_manager = actor_zeta::spawn_supervisor<db_conn::SqlConnectionManager>(resource, conn_manager);
+    mock_config config;
+    config.count_parameters = true;
+    config.local = true;
+    auto scheduler = actor_zeta::spawn_supervisor<Scheduler>(resource,
+                                                             std::make_unique<SimpleMockParser>(config),
+                                                             sql_conn_manager->address(),
+                                                             otterbrix_manager->address(),
+                                                             catalog_manager->address());
+    assert(scheduler);
+
+    auto prepare = [&](session_hash_t id, std::string sql) {
+        auto shared_data = create_cv_wrapper(flight_data(resource));
+        actor_zeta::send(scheduler->address(),
+                         scheduler->address(),
+                         scheduler::handler_id(scheduler::route::prepare_schema),
+                         id,
+                         shared_data,
+                         std::move(sql));
+        shared_data->wait_for(5000ms);
+        REQUIRE(shared_data->status() == cv_wrapper::Status::Ok);
+        return shared_data->result.parameter_count;
+    };
+
+    // the literal is bound by the plan cache only, clients have nothing to send for it
+    REQUIRE(prepare(1, "SELECT * FROM db.table WHERE id = 5") == 0);
+    REQUIRE(prepare(2, "SELECT * FROM db.table WHERE id = $1") == 1);
+}
+
+TEST_CASE("repeated prepare uses the plan cache test case") {
+    using namespace std::chrono_literals;
+
+    otterbrix::otterbrix_ptr otterbrix = init_otterbrix();
+    auto resource = std::pmr::get_default_resource();
+
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    auto conn_manager =
+        std::make_shared<mysqlc::ConnectorManager>(catalog_manager->address(), make_mysql_mock_connector);
+    conn_manager->addConnection(boost::mysql::connect_params{}, "1");
+    auto otterbrix_manager =
+        actor_zeta::spawn_supervisor<db_conn::OtterbrixManager>(resource,
+                                                                std::make_unique<SimpleMockOtterbrixManager>());
+    auto sql_conn_manager = actor_zeta::spawn_supervisor<db_conn::SqlConnectionManager>(resource, conn_manager);
+    mock_config config;
+    config.count_parameters = true;
+    config.local = true;
+    auto probe = std::make_shared<parse_probe_t>();
+    auto scheduler = actor_zeta::spawn_supervisor<Scheduler>(resource,
+                                                             std::make_unique<SimpleMockParser>(config, probe),
+                                                             sql_conn_manager->address(),
+                                                             otterbrix_manager->address(),
+                                                             catalog_manager->address());
+    assert(scheduler);
+
+    auto prepare = [&](session_hash_t id, std::string sql) {
+        auto shared_data = create_cv_wrapper(flight_data(resource));
+        actor_zeta::send(scheduler->address(),
+                         scheduler->address(),
+                         scheduler::handler_id(scheduler::route::prepare_schema),
+                         id,
+                         shared_data,
+                         std::move(sql));
+        shared_data->wait_for(5000ms);
+        REQUIRE(shared_data->status() == cv_wrapper::Status::Ok);
+    };
+
+    // statements differing only in literals share one parse, the first statement is still open
+    prepare(1, "SELECT * FROM db.table WHERE id = 5");
+    prepare(2, "SELECT * FROM db.table WHERE id = 6");
+    REQUIRE(probe->calls == 1u);
+
+    // the cached instance has its literal bound, it executes without parameters
+    auto shared_data = create_cv_wrapper(flight_data(resource));
+    actor_zeta::send(scheduler->address(),
+                     scheduler->address(),
+                     scheduler::handler_id(scheduler::route::execute_prepared_statement),
+                     session_hash_t(1),
+                     std::pmr::vector<components::types::logical_value_t>(resource),
+                     shared_data);
+    shared_data->wait_for(5000ms);
+    REQUIRE(shared_data->status() == cv_wrapper::Status::Ok);
+}
+
+TEST_CASE("failed planning keeps the prepared statement test case") {
+    using namespace std::chrono_literals;
+
+    otterbrix::otterbrix_ptr otterbrix = init_otterbrix();
+    auto resource = std::pmr::get_default_resource();
+
+    // the catalog has no connector manager, planning every remote scan fails
+    auto catalog_manager = actor_zeta::spawn_supervisor<mysqlc::CatalogManager>(resource);
+    auto conn_manager =
+        std::make_shared<mysqlc::ConnectorManager>(catalog_manager->address(), make_mysql_mock_connector);
+    conn_manager->addConnection(boost::mysql::connect_params{}, "1");
+    auto otterbrix_manager =
+        actor_zeta::spawn_supervisor<db_conn::OtterbrixManager>(resource,
+                                                                std::make_unique<SimpleMockOtterbrixManager>());
+    auto sql_conn_manager = actor_zeta::spawn_supervisor<db_conn::SqlConnectionManager>(resource, conn_manager);
+    auto scheduler = actor_zeta::spawn_supervisor<Scheduler>(resource,
+                                                             std::make_unique<SimpleMockParser>(),
+                                                             sql_conn_manager->address(),
+                                                             otterbrix_manager->address(),
+                                                             catalog_manager->address());
+    assert(scheduler);
+
+    // described earlier: prepared without the catalog, the remote scan is planned on execution
+    auto schema_cache = std::make_shared<SchemaCache>();
+    const std::string sql = "SELECT * FROM db.table WHERE id = 5";
+    REQUIRE(schema_cache->store(parameterize_query(resource, sql)->sql, schema_cache->version(), {}));
+    scheduler->set_schema_cache(schema_cache);
+
+    session_hash_t id = 7;
+    auto prepared = create_cv_wrapper(flight_data(resource));
+    actor_zeta::send(scheduler->address(),
+                     scheduler->address(),
+                     scheduler::handler_id(scheduler::route::prepare_schema),
+                     id,
+                     prepared,
+                     sql);
+    prepared->wait_for(5000ms);
+    REQUIRE(prepared->status() == cv_wrapper::Status::Ok);
+
+    // each execution runs with the plan handed back after the failed planning
+    for (int i = 0; i < 2; ++i) {
+        auto shared_data = create_cv_wrapper(flight_data(resource));
+        actor_zeta::send(scheduler->address(),
+                         scheduler->address(),
+                         scheduler::handler_id(scheduler::route::execute_prepared_statement),
+                         id,
+                         std::pmr::vector<components::types::logical_value_t>(resource),
+                         shared_data);
+        shared_data->wait_for(5000ms);
+        REQUIRE(shared_data->status() == cv_wrapper::Status::Ok);
+        REQUIRE(shared_data->result.chunk.size() == 2);
+    }
+}
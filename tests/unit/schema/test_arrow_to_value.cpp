@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "otterbrix/translators/input/arrow_to_value.hpp"
+
+#include <catch2/catch.hpp>
+
+using namespace components::types;
+
+TEST_CASE("arrow to value: every row of a parameter batch is one parameter set") {
+    arrow::Int64Builder ids;
+    REQUIRE(ids.AppendValues({1, 2}).ok());
+    arrow::StringBuilder names;
+    REQUIRE(names.Append("it's").ok());
+    REQUIRE(names.AppendNull().ok());
+    auto batch = arrow::RecordBatch::Make(arrow::schema({arrow::field("$1", arrow::int64()),
+                                                         arrow::field("$2", arrow::utf8())}),
+                                          2,
+                                          {ids.Finish().ValueOrDie(), names.Finish().ValueOrDie()});
+
+    auto sets = tsl::arrow_to_parameter_sets(std::pmr::get_default_resource(), *batch);
+    REQUIRE(sets.ok());
+    REQUIRE(sets->size() == 2);
+    REQUIRE(sets->at(0).size() == 2);
+    REQUIRE(sets->at(0).at(0).value<int64_t>() == 1);
+    REQUIRE(*sets->at(0).at(1).value<std::string*>() == "it's");
+    REQUIRE(sets->at(1).at(0).value<int64_t>() == 2);
+    REQUIRE(sets->at(1).at(1).type().type() == logical_type::NA);
+}
+
+TEST_CASE("arrow to value: unsupported parameter type is rejected") {
+    arrow::Date32Builder dates;
+    REQUIRE(dates.Append(0).ok());
+    auto array = dates.Finish().ValueOrDie();
+    REQUIRE(tsl::arrow_to_value(*array, 0).status().IsNotImplemented());
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "frontend/flight_sql_server/batch_reader.hpp"
+#include "otterbrix/translators/input/mysql_to_chunk.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace components::types;
+
+namespace {
+    // "id" INTEGER holds the row number, "name" holds "name_<row>"
+    data_chunk_t make_chunk(size_t rows) {
+        std::pmr::vector<complex_logical_type> types(std::pmr::get_default_resource());
+        types.emplace_back(logical_type::INTEGER, "id");
+        types.emplace_back(logical_type::STRING_LITERAL, "name");
+        data_chunk_t chunk(std::pmr::get_default_resource(), types, std::max<size_t>(rows, 1));
+        for (size_t i = 0; i < rows; ++i) {
+            chunk.data[0].data<int32_t>()[i] = static_cast<int32_t>(i);
+            tsl::impl::append_string(chunk.data[1], i, "name_" + std::to_string(i));
+        }
+        chunk.set_cardinality(rows);
+        return chunk;
+    }
+
+    std::shared_ptr<arrow::Schema> make_schema() {
+        return arrow::schema({arrow::field("id", arrow::int32()), arrow::field("name", arrow::utf8())});
+    }
+
+    std::vector<std::shared_ptr<arrow::RecordBatch>> read_all(ChunkBatchReader& reader) {
+        std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+        for (;;) {
+            std::shared_ptr<arrow::RecordBatch> batch;
+            REQUIRE(reader.ReadNext(&batch).ok());
+            if (!batch) {
+                return batches;
+            }
+            batches.push_back(std::move(batch));
+        }
+    }
+} // namespace
+
+TEST_CASE("batch reader: batches keep row order") {
+    constexpr size_t rows = 10;
+    auto reader = ChunkBatchReader::Make(make_schema(), make_chunk(rows), 3).ValueOrDie();
+    auto batches = read_all(*reader);
+
+    REQUIRE(batches.size() == 4);
+    size_t row = 0;
+    for (const auto& batch : batches) {
+        REQUIRE(batch->num_rows() == static_cast<int64_t>(std::min<size_t>(3, rows - row)));
+        REQUIRE(batch->ValidateFull().ok());
+        auto ids = std::static_pointer_cast<arrow::Int32Array>(batch->column(0));
+        auto names = std::static_pointer_cast<arrow::StringArray>(batch->column(1));
+        for (int64_t i = 0; i < batch->num_rows(); ++i, ++row) {
+            INFO("row " << row);
+            REQUIRE(ids->Value(i) == static_cast<int32_t>(row));
+            REQUIRE(names->GetString(i) == "name_" + std::to_string(row));
+        }
+    }
+    REQUIRE(row == rows);
+}
+
+TEST_CASE("batch reader: empty chunk ends the stream") {
+    auto reader = ChunkBatchReader::Make(make_schema(), make_chunk(0)).ValueOrDie();
+    REQUIRE(read_all(*reader).empty());
+}
+
+TEST_CASE("batch reader: field missing from the chunk is null") {
+    auto schema = arrow::schema({arrow::field("missing", arrow::int64()), arrow::field("id", arrow::int32())});
+    auto reader = ChunkBatchReader::Make(schema, make_chunk(4), 2).ValueOrDie();
+    auto batches = read_all(*reader);
+
+    REQUIRE(batches.size() == 2);
+    for (const auto& batch : batches) {
+        REQUIRE(batch->column(0)->null_count() == batch->num_rows());
+        REQUIRE(batch->column(1)->null_count() == 0);
+    }
+}
+
+TEST_CASE("batch reader: destroyed with a prefetch in flight") {
+    // many readers abandoned after the first batch, each destructor waits for its queued conversion
+    for (size_t i = 0; i < 64; ++i) {
+        auto reader = ChunkBatchReader::Make(make_schema(), make_chunk(1000), 10).ValueOrDie();
+        std::shared_ptr<arrow::RecordBatch> batch;
+        REQUIRE(reader->ReadNext(&batch).ok());
+        REQUIRE(batch->num_rows() == 10);
+    }
+}
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "otterbrix/translators/input/mysql_to_chunk.hpp"
+#include "otterbrix/translators/output/chunk_to_arrow.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace components::types;
+
+namespace {
+    data_chunk_t make_chunk(logical_type type, size_t rows) {
+        std::pmr::vector<complex_logical_type> types(std::pmr::get_default_resource());
+        types.emplace_back(type, "value");
+        data_chunk_t chunk(std::pmr::get_default_resource(), types, rows);
+        chunk.set_cardinality(rows);
+        return chunk;
+    }
+
+    // converts the whole column and compares it with arrow's own builder output, nullopt marks NULL
+    template<typename T, typename ArrowType>
+    void check_fixed(logical_type type,
+                     const std::shared_ptr<arrow::DataType>& arrow_type,
+                     const std::vector<std::optional<T>>& values) {
+        auto chunk = make_chunk(type, values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i]) {
+                chunk.data[0].data<T>()[i] = *values[i];
+            } else {
+                chunk.data[0].set_null(i, true);
+            }
+        }
+
+        auto converted = to_arrow_array(chunk.data[0], arrow_type, 0, values.size());
+        REQUIRE(converted.ok());
+        auto array = std::static_pointer_cast<arrow::NumericArray<ArrowType>>(*converted);
+        REQUIRE(array->length() == static_cast<int64_t>(values.size()));
+        for (size_t i = 0; i < values.size(); ++i) {
+            INFO("row " << i);
+            REQUIRE(array->IsNull(static_cast<int64_t>(i)) == !values[i].has_value());
+            if (values[i]) {
+                REQUIRE(array->Value(static_cast<int64_t>(i)) == *values[i]);
+            }
+        }
+        REQUIRE(array->ValidateFull().ok());
+    }
+} // namespace
+
+TEST_CASE("chunk to arrow: integers") {
+    check_fixed<int8_t, arrow::Int8Type>(logical_type::TINYINT,
+                                         arrow::int8(),
+                                         {std::numeric_limits<int8_t>::min(), std::nullopt, int8_t{7}});
+    check_fixed<int16_t, arrow::Int16Type>(logical_type::SMALLINT,
+                                           arrow::int16(),
+                                           {std::numeric_limits<int16_t>::min(), std::nullopt, int16_t{7}});
+    check_fixed<int32_t, arrow::Int32Type>(logical_type::INTEGER,
+                                           arrow::int32(),
+                                           {std::numeric_limits<int32_t>::min(), std::nullopt, int32_t{7}});
+    check_fixed<int64_t, arrow::Int64Type>(logical_type::BIGINT,
+                                           arrow::int64(),
+                                           {std::numeric_limits<int64_t>::min(), std::nullopt, int64_t{7}});
+    check_fixed<uint8_t, arrow::UInt8Type>(logical_type::UTINYINT,
+                                           arrow::uint8(),
+                                           {std::numeric_limits<uint8_t>::max(), std::nullopt, uint8_t{7}});
+    check_fixed<uint16_t, arrow::UInt16Type>(logical_type::USMALLINT,
+                                             arrow::uint16(),
+                                             {std::numeric_limits<uint16_t>::max(), std::nullopt, uint16_t{7}});
+    check_fixed<uint32_t, arrow::UInt32Type>(logical_type::UINTEGER,
+                                             arrow::uint32(),
+                                             {std::numeric_limits<uint32_t>::max(), std::nullopt, uint32_t{7}});
+    check_fixed<uint64_t, arrow::UInt64Type>(logical_type::UBIGINT,
+                                             arrow::uint64(),
+                                             {std::numeric_limits<uint64_t>::max(), std::nullopt, uint64_t{7}});
+}
+
+TEST_CASE("chunk to arrow: floating point") {
+    check_fixed<float, arrow::FloatType>(logical_type::FLOAT, arrow::float32(), {1.5f, std::nullopt, -0.25f});
+    check_fixed<double, arrow::DoubleType>(logical_type::DOUBLE, arrow::float64(), {2.5, std::nullopt, -1e300});
+}
+
+TEST_CASE("chunk to arrow: booleans are packed into bits") {
+    auto chunk = make_chunk(logical_type::BOOLEAN, 10);
+    for (size_t i = 0; i < 10; ++i) {
+        chunk.data[0].data<bool>()[i] = i % 3 == 0;
+    }
+    chunk.data[0].set_null(4, true);
+
+    auto converted = to_arrow_array(chunk.data[0], arrow::boolean(), 0, 10);
+    REQUIRE(converted.ok());
+    auto array = std::static_pointer_cast<arrow::BooleanArray>(*converted);
+    REQUIRE(array->null_count() == 1);
+    for (int64_t i = 0; i < 10; ++i) {
+        INFO("row " << i);
+        REQUIRE(array->IsNull(i) == (i == 4));
+        if (i != 4) {
+            REQUIRE(array->Value(i) == (i % 3 == 0));
+        }
+    }
+    REQUIRE(array->ValidateFull().ok());
+}
+
+TEST_CASE("chunk to arrow: strings keep empty values apart from NULL") {
+    std::vector<std::optional<std::string>> values{"abc", std::nullopt, "", std::string(300, 'x'), "z"};
+    auto chunk = make_chunk(logical_type::STRING_LITERAL, values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i]) {
+            tsl::impl::append_string(chunk.data[0], i, *values[i]);
+        } else {
+            chunk.data[0].set_null(i, true);
+        }
+    }
+
+    auto converted = to_arrow_array(chunk.data[0], arrow::utf8(), 0, values.size());
+    REQUIRE(converted.ok());
+    auto array = std::static_pointer_cast<arrow::StringArray>(*converted);
+    REQUIRE(array->null_count() == 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        INFO("row " << i);
+        REQUIRE(array->IsNull(static_cast<int64_t>(i)) == !values[i].has_value());
+        if (values[i]) {
+            REQUIRE(array->GetString(static_cast<int64_t>(i)) == *values[i]);
+        }
+    }
+    REQUIRE(array->ValidateFull().ok());
+}
+
+TEST_CASE("chunk to arrow: slices start at the offset") {
+    auto chunk = make_chunk(logical_type::BIGINT, 100);
+    for (size_t i = 0; i < 100; ++i) {
+        chunk.data[0].data<int64_t>()[i] = static_cast<int64_t>(i);
+    }
+    // offsets not aligned to a byte of the validity mask
+    chunk.data[0].set_null(70, true);
+
+    auto converted = to_arrow_array(chunk.data[0], arrow::int64(), 67, 5);
+    REQUIRE(converted.ok());
+    auto array = std::static_pointer_cast<arrow::Int64Array>(*converted);
+    REQUIRE(array->length() == 5);
+    REQUIRE(array->null_count() == 1);
+    REQUIRE(array->IsNull(3));
+    REQUIRE(array->Value(0) == 67);
+    REQUIRE(array->Value(4) == 71);
+    REQUIRE(array->ValidateFull().ok());
+}
+
+TEST_CASE("chunk to arrow: column without NULLs has no validity bitmap") {
+    auto chunk = make_chunk(logical_type::INTEGER, 3);
+    for (size_t i = 0; i < 3; ++i) {
+        chunk.data[0].data<int32_t>()[i] = static_cast<int32_t>(i);
+    }
+    auto converted = to_arrow_array(chunk.data[0], arrow::int32(), 0, 3);
+    REQUIRE(converted.ok());
+    REQUIRE((*converted)->null_count() == 0);
+    REQUIRE((*converted)->null_bitmap_data() == nullptr);
+}
+
+TEST_CASE("chunk to arrow: mismatched types are not converted") {
+    auto chunk = make_chunk(logical_type::INTEGER, 1);
+    REQUIRE(to_arrow_array(chunk.data[0], arrow::int64(), 0, 1).status().IsNotImplemented());
+    REQUIRE(to_arrow_array(chunk.data[0], arrow::date32(), 0, 1).status().IsNotImplemented());
+}
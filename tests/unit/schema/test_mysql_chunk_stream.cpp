@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "otterbrix/translators/input/mysql_to_chunk.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace components::types;
+using tsl::impl::column_decoder_t;
+
+namespace {
+    using rows_t = std::vector<std::vector<boost::mysql::field_view>>;
+
+    std::pmr::vector<complex_logical_type> id_name_types() {
+        std::pmr::vector<complex_logical_type> types(std::pmr::get_default_resource());
+        types.emplace_back(logical_type::BIGINT, "id");
+        types.emplace_back(logical_type::STRING_LITERAL, "name");
+        return types;
+    }
+
+    // rows [begin, end) as (i, names[i])
+    rows_t make_rows(const std::vector<std::string>& names, size_t begin, size_t end) {
+        rows_t rows;
+        for (size_t i = begin; i < end; ++i) {
+            rows.push_back({boost::mysql::field_view(static_cast<int64_t>(i)), boost::mysql::field_view(names[i])});
+        }
+        return rows;
+    }
+} // namespace
+
+TEST_CASE("mysql chunk stream: rows are split into bounded chunks") {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < 10; ++i) {
+        names.push_back("name_" + std::to_string(i));
+    }
+
+    tsl::mysql_chunk_stream_t stream(std::pmr::get_default_resource(), 4);
+    stream.resolve({column_decoder_t::int64, column_decoder_t::string}, id_name_types());
+    // reads don't line up with chunk boundaries
+    stream.append_rows(make_rows(names, 0, 3));
+    stream.append_rows(make_rows(names, 3, 9));
+    stream.append_rows(make_rows(names, 9, 10));
+    REQUIRE(stream.size() == 10);
+    REQUIRE(stream.batches() == 3);
+
+    auto chunks = stream.finish();
+    REQUIRE(chunks.size() == 3);
+    REQUIRE(chunks[0]->size() == 4);
+    REQUIRE(chunks[1]->size() == 4);
+    REQUIRE(chunks[2]->size() == 2);
+
+    size_t row = 0;
+    for (const auto& chunk : chunks) {
+        for (size_t i = 0; i < chunk->size(); ++i, ++row) {
+            REQUIRE(chunk->data[0].data<int64_t>()[i] == static_cast<int64_t>(row));
+            REQUIRE(chunk->data[1].data<std::string_view>()[i] == names[row]);
+        }
+    }
+}
+
+TEST_CASE("mysql chunk stream: empty result keeps the column types") {
+    tsl::mysql_chunk_stream_t stream(std::pmr::get_default_resource(), 4);
+    stream.resolve({column_decoder_t::int64, column_decoder_t::string}, id_name_types());
+    stream.append_rows(rows_t{});
+
+    auto chunks = stream.finish();
+    REQUIRE(chunks.size() == 1);
+    REQUIRE(chunks[0]->size() == 0);
+    REQUIRE(chunks[0]->column_count() == 2);
+    REQUIRE(stream.bytes() == 0);
+}
+
+TEST_CASE("mysql chunk stream: chunks are joined in arrival order") {
+    std::vector<std::string> names{"a", "b", "c", "d", "e"};
+    tsl::mysql_chunk_stream_t stream(std::pmr::get_default_resource(), 2);
+    stream.resolve({column_decoder_t::int64, column_decoder_t::string}, id_name_types());
+    stream.append_rows(make_rows(names, 0, 5));
+    // 5 ids of 8 bytes and 5 one-character names
+    REQUIRE(stream.bytes() == 5 * sizeof(int64_t) + 5);
+
+    auto joined = tsl::concat_chunks(std::pmr::get_default_resource(), stream.finish());
+    REQUIRE(joined->size() == 5);
+    for (size_t i = 0; i < names.size(); ++i) {
+        REQUIRE(joined->data[0].data<int64_t>()[i] == static_cast<int64_t>(i));
+        REQUIRE(joined->data[1].data<std::string_view>()[i] == names[i]);
+    }
+}
+
+TEST_CASE("mysql chunk stream: expected rows go into the first chunk") {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < 10; ++i) {
+        names.push_back("name_" + std::to_string(i));
+    }
+
+    tsl::mysql_chunk_stream_t fits(std::pmr::get_default_resource(), 4, 8);
+    fits.resolve({column_decoder_t::int64, column_decoder_t::string}, id_name_types());
+    fits.append_rows(make_rows(names, 0, 3));
+    fits.append_rows(make_rows(names, 3, 6));
+    auto single = fits.finish();
+    REQUIRE(single.size() == 1);
+    REQUIRE(single[0]->size() == 6);
+
+    // rows past the expected count fall back to bounded chunks
+    tsl::mysql_chunk_stream_t outgrown(std::pmr::get_default_resource(), 4, 8);
+    outgrown.resolve({column_decoder_t::int64, column_decoder_t::string}, id_name_types());
+    outgrown.append_rows(make_rows(names, 0, 10));
+    auto chunks = outgrown.finish();
+    REQUIRE(chunks.size() == 2);
+    REQUIRE(chunks[0]->size() == 8);
+    REQUIRE(chunks[1]->size() == 2);
+
+    auto joined = tsl::concat_chunks(std::pmr::get_default_resource(), std::move(chunks));
+    REQUIRE(joined->size() == 10);
+    for (size_t i = 0; i < names.size(); ++i) {
+        REQUIRE(joined->data[0].data<int64_t>()[i] == static_cast<int64_t>(i));
+        REQUIRE(joined->data[1].data<std::string_view>()[i] == names[i]);
+    }
+}
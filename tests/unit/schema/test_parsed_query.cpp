@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "otterbrix/parser/parser.hpp"
+#include "otterbrix/query_generation/sql_query_generator.hpp"
+
+#include <catch2/catch.hpp>
+#include <components/logical_plan/node_data.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace components;
+
+TEST_CASE("parsed query: instance owns a copy of the plan") {
+    auto* resource = std::pmr::get_default_resource();
+    GreenplumParser parser(resource);
+    auto prepared = parser.parse("SELECT * FROM uid1.db1.schema.t1 JOIN uid2.db2.schema.t2 ON t1.id = t2.id;");
+    REQUIRE(prepared->otterbrix_params->external_nodes_count == 2);
+
+    std::vector<logical_plan::node_ptr> original;
+    for (auto& batch : prepared->otterbrix_params->external_nodes) {
+        for (auto* slot : batch) {
+            original.push_back(*slot);
+        }
+    }
+
+    for (int run = 0; run < 2; ++run) {
+        auto instance = prepared->instantiate();
+        REQUIRE(instance->otterbrix_params->node != prepared->otterbrix_params->node);
+        REQUIRE(instance->otterbrix_params->params_node != prepared->otterbrix_params->params_node);
+        REQUIRE(instance->otterbrix_params->external_nodes_count == 2);
+        REQUIRE_THROWS_AS(instance->binder(), std::logic_error);
+
+        // what SqlConnectionManager does with fetched results
+        size_t i = 0;
+        for (auto& batch : instance->otterbrix_params->external_nodes) {
+            for (auto* slot : batch) {
+                REQUIRE(*slot != original[i]);
+                REQUIRE((*slot)->collection_full_name().to_string() ==
+                        original[i++]->collection_full_name().to_string());
+                *slot = logical_plan::make_node_raw_data(resource, vector::data_chunk_t(resource, {}, 0));
+            }
+        }
+
+        i = 0;
+        for (auto& batch : prepared->otterbrix_params->external_nodes) {
+            for (auto* slot : batch) {
+                REQUIRE(*slot == original[i++]);
+            }
+        }
+    }
+}
+
+TEST_CASE("parsed query: root external node is owned by the instance") {
+    auto* resource = std::pmr::get_default_resource();
+    GreenplumParser parser(resource);
+    auto prepared = parser.parse("SELECT * FROM uid1.db1.schema.t1 WHERE id > $1;");
+    REQUIRE(prepared->otterbrix_params->external_nodes_count == 1);
+    auto root = prepared->otterbrix_params->node;
+
+    auto instance = prepared->instantiate();
+    auto* slot = instance->otterbrix_params->external_nodes.at(0).at(0);
+    REQUIRE(slot == &instance->otterbrix_params->node);
+    *slot = logical_plan::make_node_raw_data(resource, vector::data_chunk_t(resource, {}, 0));
+
+    REQUIRE(prepared->otterbrix_params->node == root);
+}
+
+TEST_CASE("parsed query: join on one connection is a single external node") {
+    auto* resource = std::pmr::get_default_resource();
+    GreenplumParser parser(resource);
+    auto parsed = parser.parse("SELECT t1.id, t2.name FROM uid1.db1.schema.t1 JOIN uid1.db1.schema.t2 "
+                               "ON t1.id = t2.id ORDER BY t2.name LIMIT 5;");
+    REQUIRE(parsed->otterbrix_params->external_nodes_count == 1);
+    REQUIRE(parsed->otterbrix_params->external_nodes.at(0).at(0) == &parsed->otterbrix_params->node);
+    REQUIRE(parsed->otterbrix_params->node->collection_full_name().unique_identifier == "uid1");
+
+    auto query = sql_gen::generate_query(parsed->otterbrix_params->node,
+                                         &parsed->otterbrix_params->params_node->parameters());
+    REQUIRE(query.find(" AS t1 JOIN ") != std::string::npos);
+    REQUIRE(query.find(" AS t2 ON ") != std::string::npos);
+    REQUIRE(query.ends_with(" LIMIT 5;"));
+
+    // different connections are still joined by otterbrix
+    auto federated = parser.parse("SELECT t1.id FROM uid1.db1.schema.t1 JOIN uid2.db1.schema.t2 ON t1.id = t2.id;");
+    REQUIRE(federated->otterbrix_params->external_nodes_count == 2);
+
+    // so are scans the generated aliases can't tell apart
+    auto same_name = parser.parse("SELECT * FROM uid1.db1.schema.t1 JOIN uid1.db2.schema.t1 ON t1.id = t1.id;");
+    REQUIRE(same_name->otterbrix_params->external_nodes_count == 2);
+    auto aliased = parser.parse("SELECT a.id FROM uid1.db1.schema.t1 AS a JOIN uid1.db1.schema.t2 AS b "
+                                "ON a.id = b.id;");
+    REQUIRE(aliased->otterbrix_params->external_nodes_count == 2);
+}
+
+TEST_CASE("parsed query: pushed join keeps every join condition") {
+    auto* resource = std::pmr::get_default_resource();
+    GreenplumParser parser(resource);
+    auto parsed = parser.parse("SELECT t1.id FROM uid1.db1.schema.t1 JOIN uid1.db1.schema.t2 "
+                               "ON t1.id = t2.id AND t1.kind = t2.kind;");
+    REQUIRE(parsed->otterbrix_params->external_nodes_count == 1);
+
+    auto query = sql_gen::generate_query(parsed->otterbrix_params->node,
+                                         &parsed->otterbrix_params->params_node->parameters());
+    REQUIRE(query.find("t1.id = t2.id") != std::string::npos);
+    REQUIRE(query.find("t1.kind = t2.kind") != std::string::npos);
+}
+
+TEST_CASE("parsed query: HAVING is aggregated by otterbrix") {
+    auto* resource = std::pmr::get_default_resource();
+    GreenplumParser parser(resource);
+    auto grouped = parser.parse("SELECT region, SUM(amount) AS total FROM uid1.db1.schema.sales GROUP BY region;");
+    REQUIRE(grouped->otterbrix_params->external_nodes.at(0).at(0) == &grouped->otterbrix_params->node);
+
+    auto having = parser.parse("SELECT region, SUM(amount) AS total FROM uid1.db1.schema.sales WHERE amount > 0 "
+                               "GROUP BY region HAVING SUM(amount) > 10;");
+    REQUIRE(having->otterbrix_params->external_nodes_count == 1);
+    REQUIRE(having->otterbrix_params->node->collection_full_name().unique_identifier.empty());
+    auto* scan = having->otterbrix_params->external_nodes.at(0).at(0);
+    REQUIRE(scan != &having->otterbrix_params->node);
+    REQUIRE((*scan)->collection_full_name().unique_identifier == "uid1");
+
+    // the backend only sends the rows, grouping and both filters stay local
+    auto query = sql_gen::generate_query(*scan, &having->otterbrix_params->params_node->parameters());
+    REQUIRE(query.find("GROUP BY") == std::string::npos);
+    REQUIRE(query.find("WHERE") == std::string::npos);
+    const auto& children = having->otterbrix_params->node->children();
+    REQUIRE(std::any_of(children.begin(), children.end(), [](const auto& child) {
+        return child->type() == logical_plan::node_type::group_t;
+    }));
+
+    // so does the limit, it applies to the groups the HAVING keeps
+    auto limited = parser.parse("SELECT region, SUM(amount) AS total FROM uid1.db1.schema.sales GROUP BY region "
+                                "HAVING SUM(amount) > 10 ORDER BY total LIMIT 3;");
+    auto* limited_scan = limited->otterbrix_params->external_nodes.at(0).at(0);
+    auto limited_query =
+        sql_gen::generate_query(*limited_scan, &limited->otterbrix_params->params_node->parameters());
+    REQUIRE(limited_query.find("LIMIT") == std::string::npos);
+    const auto& limited_children = limited->otterbrix_params->node->children();
+    REQUIRE(std::any_of(limited_children.begin(), limited_children.end(), [](const auto& child) {
+        return child->type() == logical_plan::node_type::limit_t;
+    }));
+}
+
+TEST_CASE("parsed query: planning an instance leaves the template unchanged") {
+    auto* resource = std::pmr::get_default_resource();
+    GreenplumParser parser(resource);
+    auto cached = parser.parse("SELECT t1.id FROM uid1.db1.schema.t1 JOIN uid2.db1.schema.t2 ON t1.id = t2.id "
+                               "WHERE t1.id > 5;");
+    std::vector<logical_plan::node_ptr> original(cached->otterbrix_params->node->children().begin(),
+                                                 cached->otterbrix_params->node->children().end());
+    REQUIRE_FALSE(original.empty());
+    auto* scan = cached->otterbrix_params->external_nodes.at(0).at(0);
+    const auto scan_children = (*scan)->children().size();
+
+    auto instance = cached->instantiate();
+    // what the catalog does when it splits an aggregation or pushes a filter below a scan
+    instance->otterbrix_params->node->children().front() =
+        logical_plan::make_node_raw_data(resource, vector::data_chunk_t(resource, {}, 0));
+    auto* instance_scan = instance->otterbrix_params->external_nodes.at(0).at(0);
+    (*instance_scan)->append_child(logical_plan::make_node_raw_data(resource, vector::data_chunk_t(resource, {}, 0)));
+
+    const auto& children = cached->otterbrix_params->node->children();
+    REQUIRE(std::equal(children.begin(), children.end(), original.begin(), original.end()));
+    REQUIRE((*scan)->children().size() == scan_children);
+}
+
+TEST_CASE("parsed query: literals compared against become parameters") {
+    auto* resource = std::pmr::get_default_resource();
+    auto query = parameterize_query(resource,
+                                    "SELECT id, 1 FROM uid1.db1.schema.t1 WHERE id = 5 AND name = 'it''s' "
+                                    "AND v IN (1, 2.5) AND d = DATE '2020-01-01' ORDER BY 1 LIMIT 10;");
+    REQUIRE(query);
+    REQUIRE(query->sql == "SELECT id, 1 FROM uid1.db1.schema.t1 WHERE id = $1 AND name = $2 "
+                          "AND v IN ($3, $4) AND d = DATE '2020-01-01' ORDER BY 1 LIMIT 10;");
+    REQUIRE(query->values.size() == 4);
+    REQUIRE(query->values.at(0).value<int64_t>() == 5);
+    REQUIRE(*query->values.at(1).value<std::string*>() == "it's");
+    REQUIRE(query->values.at(2).value<int64_t>() == 1);
+    REQUIRE(query->values.at(3).value<double>() == 2.5);
+
+    auto between = parameterize_query(resource, "SELECT * FROM t WHERE x BETWEEN 1 AND 10 AND y = '7'::int;");
+    REQUIRE(between);
+    REQUIRE(between->sql == "SELECT * FROM t WHERE x BETWEEN $1 AND $2 AND y = '7'::int;");
+
+    // other statements and text that already has parameters are left to the parser
+    REQUIRE_FALSE(parameterize_query(resource, "INSERT INTO t VALUES (1);"));
+    REQUIRE_FALSE(parameterize_query(resource, "SELECT * FROM t WHERE id = $1;"));
+    REQUIRE_FALSE(parameterize_query(resource, "SELECT * FROM t WHERE name = E'a\\nb';"));
+
+    // same shape with other literals gives the same text
+    auto other = parameterize_query(resource,
+                                    "SELECT id, 1 FROM uid1.db1.schema.t1 WHERE id = 42 AND name = 'x' "
+                                    "AND v IN (3, 4.5) AND d = DATE '2020-01-01' ORDER BY 1 LIMIT 10;");
+    REQUIRE(other);
+    REQUIRE(other->sql == query->sql);
+
+    GreenplumParser parser(resource);
+    auto simple = parameterize_query(resource, "SELECT * FROM uid1.db1.schema.t1 WHERE id = 5 AND name = 'a';");
+    REQUIRE(simple);
+    auto parsed = parser.parse(simple->sql);
+    REQUIRE(parsed->otterbrix_params->parameters_count == simple->values.size());
+}
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "frontend/flight_sql_server/result_spool.hpp"
+#include "otterbrix/translators/input/mysql_to_chunk.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace components::types;
+using namespace std::chrono_literals;
+
+namespace {
+    // "id" INTEGER holds the row number, "name" holds "name_<row>"
+    data_chunk_t make_chunk(size_t rows) {
+        std::pmr::vector<complex_logical_type> types(std::pmr::get_default_resource());
+        types.emplace_back(logical_type::INTEGER, "id");
+        types.emplace_back(logical_type::STRING_LITERAL, "name");
+        data_chunk_t chunk(std::pmr::get_default_resource(), types, std::max<size_t>(rows, 1));
+        for (size_t i = 0; i < rows; ++i) {
+            chunk.data[0].data<int32_t>()[i] = static_cast<int32_t>(i);
+            tsl::impl::append_string(chunk.data[1], i, "name_" + std::to_string(i));
+        }
+        chunk.set_cardinality(rows);
+        return chunk;
+    }
+
+    ResultSpool::spooled_result_ptr make_result(size_t rows, size_t batch_rows) {
+        auto schema = arrow::schema({arrow::field("id", arrow::int32()), arrow::field("name", arrow::utf8())});
+        return ResultSpool::Make(std::move(schema), make_chunk(rows), batch_rows).ValueOrDie();
+    }
+} // namespace
+
+TEST_CASE("result spool: every part is taken once") {
+    ResultSpool spool(60s, int64_t{1} << 30);
+    auto result = make_result(10, 3);
+    REQUIRE(result->total_records == 10);
+    result->Split(2);
+    REQUIRE(spool.Put(1, result));
+    REQUIRE(spool.bytes() == result->total_bytes);
+
+    auto second = spool.Take(1, 1);
+    REQUIRE(second);
+    REQUIRE_FALSE(spool.Take(1, 1));
+    REQUIRE_FALSE(spool.Take(1, 2));
+
+    auto first = spool.Take(1, 0);
+    REQUIRE(first);
+    REQUIRE(first->batches.size() + second->batches.size() == 4);
+    REQUIRE(first->batches.front()->num_rows() == 3);
+    REQUIRE(second->batches.back()->num_rows() == 1);
+
+    // dropped after its last part
+    REQUIRE(spool.bytes() == 0);
+    REQUIRE_FALSE(spool.Take(1, 0));
+}
+
+TEST_CASE("result spool: results over the byte limit are refused") {
+    auto result = make_result(100, 10);
+    ResultSpool spool(60s, result->total_bytes + result->total_bytes / 2);
+
+    REQUIRE(spool.Put(1, result));
+    REQUIRE_FALSE(spool.Put(2, make_result(100, 10)));
+    REQUIRE_FALSE(spool.Take(2, 0));
+
+    // taking the first one makes room
+    REQUIRE(spool.Take(1, 0));
+    REQUIRE(spool.Put(2, make_result(100, 10)));
+    REQUIRE(spool.Take(2, 0));
+}
+
+TEST_CASE("result spool: expired results are swept without being asked for") {
+    ResultSpool spool(20ms, int64_t{1} << 30);
+    REQUIRE(spool.Put(1, make_result(10, 3)));
+    REQUIRE(spool.bytes() > 0);
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (spool.bytes() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    REQUIRE(spool.bytes() == 0);
+    REQUIRE_FALSE(spool.Take(1, 0));
+}
+
+TEST_CASE("result spool: empty result still has a part") {
+    ResultSpool spool(60s, 0);
+    auto result = make_result(0, 3);
+    result->Split(4);
+    REQUIRE(result->parts() == 1);
+    REQUIRE(spool.Put(1, result));
+    auto part = spool.Take(1, 0);
+    REQUIRE(part);
+    REQUIRE(part->batches.empty());
+}
+
+TEST_CASE("result spool: split keeps whole batches in order") {
+    auto result = make_result(10, 1);
+    REQUIRE(result->batches.size() == 10);
+
+    result->Split(3);
+    REQUIRE(result->part_begin == std::vector<size_t>{0, 3, 6});
+
+    // never more parts than batches, and at least one
+    result->Split(20);
+    REQUIRE(result->parts() == 10);
+    result->Split(0);
+    REQUIRE(result->part_begin == std::vector<size_t>{0});
+
+    ResultSpool spool(60s, int64_t{1} << 30);
+    result->Split(3);
+    REQUIRE(spool.Put(1, result));
+    int32_t row = 0;
+    for (size_t part = 0; part < 3; ++part) {
+        auto taken = spool.Take(1, part);
+        REQUIRE(taken);
+        REQUIRE(taken->batches.size() == (part == 2 ? 4u : 3u));
+        for (const auto& batch : taken->batches) {
+            auto ids = std::static_pointer_cast<arrow::Int32Array>(batch->column(0));
+            REQUIRE(ids->Value(0) == row++);
+        }
+    }
+    REQUIRE(row == 10);
+}
+
+TEST_CASE("result spool: taking a part renews the others") {
+    ResultSpool spool(300ms, int64_t{1} << 30);
+    auto result = make_result(3, 1);
+    result->Split(3);
+    REQUIRE(spool.Put(1, result));
+
+    // every fetch comes within the time to live of the previous one, the last well after the first
+    REQUIRE(spool.Take(1, 0));
+    std::this_thread::sleep_for(200ms);
+    REQUIRE(spool.Take(1, 1));
+    std::this_thread::sleep_for(200ms);
+    REQUIRE(spool.Take(1, 2));
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2025-2026  OtterStax
 
+#include "otterbrix/query_generation/sql_query_generator.hpp"
 #include "otterbrix/translators/input/mysql_to_chunk.hpp"
 #include "scheduler/schema_utils.hpp"
 
@@ -177,3 +178,598 @@ TEST_CASE("join: complex") {
         REQUIRE(joined_cur->is_error());
     }
 }
+
+TEST_CASE("projection: required columns") {
+    {
+        auto [node, params] = parse("SELECT t1.id, t2.name FROM uid1.db1.schema.t1 JOIN uid2.db2.schema.t2 "
+                                    "ON t1.id = t2.id ORDER BY t2.score;");
+        auto columns = required_columns(node);
+        REQUIRE(columns);
+        REQUIRE(columns->count("id"));
+        REQUIRE(columns->count("name"));
+        REQUIRE(columns->count("score"));
+        REQUIRE_FALSE(columns->count("dummy"));
+    }
+    {
+        auto [node, params] = parse("SELECT * FROM uid1.db1.schema.t1 JOIN uid2.db2.schema.t2 ON t1.id = t2.id;");
+        REQUIRE_FALSE(required_columns(node));
+    }
+    {
+        // single backend query is sent as is
+        auto [node, params] = parse("SELECT id FROM uid1.db1.schema.t1;");
+        REQUIRE_FALSE(required_columns(node));
+    }
+}
+
+TEST_CASE("projection: prune external scan") {
+    auto* resource = std::pmr::get_default_resource();
+    std::vector<complex_logical_type> fields;
+    fields.emplace_back(logical_type::BIGINT);
+    fields.back().set_alias("id");
+    fields.emplace_back(logical_type::STRING_LITERAL);
+    fields.back().set_alias("name");
+    fields.emplace_back(logical_type::FLOAT);
+    fields.back().set_alias("dummy");
+    auto table = complex_logical_type::create_struct(fields);
+    logical_plan::parameter_node_t params(resource);
+
+    auto node = logical_plan::make_node_aggregate(resource, collection_full_name_t("db1", "t1"));
+    REQUIRE_FALSE(prune_projection(*node, {"missing"}, table));
+    REQUIRE_FALSE(prune_projection(*node, {"id", "name", "dummy"}, table));
+    REQUIRE(sql_gen::generate_query(node, &params.parameters()).starts_with("SELECT * FROM"));
+
+    REQUIRE(prune_projection(*node, {"name", "id", "other"}, table));
+    REQUIRE(sql_gen::generate_query(node, &params.parameters()).starts_with("SELECT id, name FROM"));
+    auto pruned = aggregate_filter_schema(*node, &params, catalog::schema(resource, table));
+    REQUIRE(pruned.child_types().size() == 2);
+    REQUIRE_FALSE(complex_logical_type::contains(pruned, logical_type::FLOAT));
+
+    // already projected
+    REQUIRE_FALSE(prune_projection(*node, {"id"}, table));
+}
+
+TEST_CASE("aggregate: typed by column") {
+    auto* resource = std::pmr::get_default_resource();
+    std::vector<complex_logical_type> fields;
+    fields.emplace_back(logical_type::BIGINT);
+    fields.back().set_alias("id");
+    fields.emplace_back(logical_type::DOUBLE);
+    fields.back().set_alias("price");
+    fields.emplace_back(logical_type::STRING_LITERAL);
+    fields.back().set_alias("name");
+    auto schema = catalog::schema(resource, complex_logical_type::create_struct(fields));
+
+    auto [node, params] = parse("SELECT sum(price), sum(id), max(name), avg(id), count(name) from test;");
+    auto filtered =
+        aggregate_filter_schema(static_cast<const logical_plan::node_aggregate_t&>(*node), params.get(), schema);
+    REQUIRE(filtered.child_types().size() == 5);
+    REQUIRE(filtered.child_types()[0] == logical_type::DOUBLE);
+    REQUIRE(filtered.child_types()[1] == logical_type::BIGINT);
+    REQUIRE(filtered.child_types()[2] == logical_type::STRING_LITERAL);
+    REQUIRE(filtered.child_types()[3] == logical_type::DOUBLE);
+    REQUIRE(filtered.child_types()[4] == logical_type::BIGINT);
+}
+
+TEST_CASE("aggregate: group by pushdown") {
+    auto* resource = std::pmr::get_default_resource();
+    std::vector<complex_logical_type> fields;
+    fields.emplace_back(logical_type::BIGINT);
+    fields.back().set_alias("amount");
+    fields.emplace_back(logical_type::STRING_LITERAL);
+    fields.back().set_alias("region");
+    auto schema = catalog::schema(resource, complex_logical_type::create_struct(fields));
+
+    auto [node, params] =
+        parse("SELECT region, sum(amount) AS total, avg(amount) AS mean FROM uid1.db1.schema.t1 GROUP BY region;");
+    auto filtered =
+        aggregate_filter_schema(static_cast<const logical_plan::node_aggregate_t&>(*node), params.get(), schema);
+
+    auto query = sql_gen::generate_query(node, &params->parameters(), &filtered);
+    REQUIRE(query.find("CAST(SUM(amount) AS SIGNED) AS total") != std::string::npos);
+    REQUIRE(query.find("(AVG(amount) + 0E0) AS mean") != std::string::npos);
+    REQUIRE(query.find(" GROUP BY region") != std::string::npos);
+
+    // without the expected schema aggregates are sent as they are
+    auto plain = sql_gen::generate_query(node, &params->parameters());
+    REQUIRE(plain.find("SUM(amount) AS total") != std::string::npos);
+    REQUIRE(plain.find("CAST(") == std::string::npos);
+}
+
+TEST_CASE("aggregate: decimal sums keep their fraction") {
+    auto* resource = std::pmr::get_default_resource();
+    std::vector<complex_logical_type> fields;
+    // mysql DECIMAL columns are decoded as strings
+    fields.emplace_back(logical_type::STRING_LITERAL);
+    fields.back().set_alias("price");
+    fields.emplace_back(logical_type::STRING_LITERAL);
+    fields.back().set_alias("region");
+    auto schema = catalog::schema(resource, complex_logical_type::create_struct(fields));
+
+    auto [node, params] = parse("SELECT region, sum(price) AS total FROM uid1.db1.schema.t1 GROUP BY region;");
+    auto filtered =
+        aggregate_filter_schema(static_cast<const logical_plan::node_aggregate_t&>(*node), params.get(), schema);
+    REQUIRE(filtered.child_types()[1] == logical_type::DOUBLE);
+
+    auto query = sql_gen::generate_query(node, &params->parameters(), &filtered);
+    REQUIRE(query.find("(SUM(price) + 0E0) AS total") != std::string::npos);
+    REQUIRE(query.find("SIGNED") == std::string::npos);
+}
+
+TEST_CASE("aggregate: partial pushdown below join") {
+    auto* resource = std::pmr::get_default_resource();
+    std::vector<complex_logical_type> regions;
+    regions.emplace_back(logical_type::BIGINT);
+    regions.back().set_alias("id");
+    regions.emplace_back(logical_type::STRING_LITERAL);
+    regions.back().set_alias("region");
+    std::vector<complex_logical_type> sales;
+    sales.emplace_back(logical_type::BIGINT);
+    sales.back().set_alias("region_id");
+    sales.emplace_back(logical_type::BIGINT);
+    sales.back().set_alias("amount");
+
+    auto plan = [&](const std::string& sql) {
+        auto [node, params] = parse(sql);
+        // what CatalogManager::get_catalog_schema leaves in place of the scans
+        for (auto& child : node->children()) {
+            if (child->type() != logical_plan::node_type::join_t) {
+                continue;
+            }
+            for (auto& scan : child->children()) {
+                auto name = scan->collection_full_name();
+                auto table = complex_logical_type::create_struct(name.collection == "regions" ? regions : sales);
+                scan = make_node_schema(name,
+                                        std::move(table),
+                                        logical_plan::node_aggregate_t(
+                                            static_cast<const logical_plan::node_aggregate_t&>(*scan)));
+            }
+        }
+        return std::make_pair(std::move(node), std::move(params));
+    };
+
+    SECTION("count and sum") {
+        auto [node, params] = plan("SELECT regions.region, count(sales.amount) AS cnt, sum(sales.amount) AS total "
+                                   "FROM uid1.db1.schema.regions JOIN uid2.db2.schema.sales "
+                                   "ON regions.id = sales.region_id GROUP BY regions.region;");
+        REQUIRE(push_partial_aggregation(node, params.get()));
+
+        schema_node_t* source = nullptr;
+        for (auto& child : node->children()) {
+            if (child->type() == logical_plan::node_type::join_t) {
+                for (auto& scan : child->children()) {
+                    if (scan->collection_full_name().collection == "sales") {
+                        source = static_cast<schema_node_t*>(scan.get());
+                    }
+                }
+            }
+        }
+        REQUIRE(source);
+        auto remote = sql_gen::generate_query(source->agg_node(), &params->parameters(), &source->schema());
+        REQUIRE(remote.find("COUNT(amount) AS __partial_0") != std::string::npos);
+        REQUIRE(remote.find("CAST(SUM(amount) AS SIGNED) AS __partial_1") != std::string::npos);
+        REQUIRE(remote.find(" GROUP BY region_id") != std::string::npos);
+
+        // counts are combined as sums, aliases stay
+        for (const auto& child : node->children()) {
+            if (child->type() != logical_plan::node_type::group_t) {
+                continue;
+            }
+            size_t combined = 0;
+            for (const auto& expr : child->expressions()) {
+                if (expr->group() == expressions::expression_group::aggregate) {
+                    auto& agg = static_cast<const expressions::aggregate_expression_t&>(*expr);
+                    REQUIRE(agg.type() == expressions::aggregate_type::sum);
+                    REQUIRE((agg.key().as_string() == "cnt" || agg.key().as_string() == "total"));
+                    ++combined;
+                }
+            }
+            REQUIRE(combined == 2);
+        }
+    }
+
+    SECTION("count star goes with the other aggregates") {
+        auto [node, params] = plan("SELECT regions.region, count(*) AS cnt, sum(sales.amount) AS total "
+                                   "FROM uid1.db1.schema.regions JOIN uid2.db2.schema.sales "
+                                   "ON regions.id = sales.region_id GROUP BY regions.region;");
+        REQUIRE(push_partial_aggregation(node, params.get()));
+
+        for (auto& child : node->children()) {
+            if (child->type() != logical_plan::node_type::join_t) {
+                continue;
+            }
+            for (auto& scan : child->children()) {
+                if (scan->collection_full_name().collection != "sales") {
+                    continue;
+                }
+                auto& source = static_cast<schema_node_t&>(*scan);
+                auto remote = sql_gen::generate_query(source.agg_node(), &params->parameters(), &source.schema());
+                REQUIRE(remote.find("COUNT(*) AS __partial_0") != std::string::npos);
+                REQUIRE(remote.find(" GROUP BY region_id") != std::string::npos);
+            }
+        }
+    }
+
+    SECTION("avg stays local") {
+        auto [node, params] = plan("SELECT regions.region, avg(sales.amount) AS mean "
+                                   "FROM uid1.db1.schema.regions JOIN uid2.db2.schema.sales "
+                                   "ON regions.id = sales.region_id GROUP BY regions.region;");
+        REQUIRE_FALSE(push_partial_aggregation(node, params.get()));
+    }
+
+    SECTION("aggregates over both sources stay local") {
+        auto [node, params] = plan("SELECT count(regions.region), sum(sales.amount) "
+                                   "FROM uid1.db1.schema.regions JOIN uid2.db2.schema.sales "
+                                   "ON regions.id = sales.region_id;");
+        REQUIRE_FALSE(push_partial_aggregation(node, params.get()));
+    }
+}
+
+TEST_CASE("select: limit pushdown") {
+    {
+        auto [node, params] = parse("SELECT id FROM uid1.db1.schema.t1 ORDER BY id DESC LIMIT 10;");
+        auto query = sql_gen::generate_query(node, &params->parameters());
+        REQUIRE(query.ends_with(" ORDER BY id DESC LIMIT 10;"));
+    }
+    {
+        auto [node, params] = parse("SELECT id FROM uid1.db1.schema.t1 ORDER BY id DESC;");
+        auto query = sql_gen::generate_query(node, &params->parameters());
+        REQUIRE(query.find("LIMIT") == std::string::npos);
+    }
+    {
+        // the backend would limit the groups before the HAVING drops some of them
+        auto [node, params] = parse("SELECT region, sum(amount) AS total FROM uid1.db1.schema.t1 GROUP BY region "
+                                    "HAVING sum(amount) > 10 ORDER BY region LIMIT 10;");
+        auto query = sql_gen::generate_query(node, &params->parameters());
+        REQUIRE(query.find("LIMIT") == std::string::npos);
+    }
+}
+
+namespace {
+    logical_plan::node_ptr scan_agg(const logical_plan::node_ptr& slot) {
+        if (slot->type() == logical_plan::node_type::unused) {
+            return static_cast<schema_node_t&>(*slot).agg_node();
+        }
+        return slot;
+    }
+} // namespace
+
+TEST_CASE("semi-join: filtered scan reduces the other one") {
+    auto* resource = std::pmr::get_default_resource();
+    auto [node, params] = parse("SELECT * FROM uid1.db1.schema.regions JOIN uid2.db2.schema.sales "
+                                "ON regions.id = sales.region_id;");
+
+    std::vector<logical_plan::node_ptr*> batch;
+    for (auto& child : node->children()) {
+        if (child->type() != logical_plan::node_type::join_t) {
+            continue;
+        }
+        for (auto& scan : child->children()) {
+            batch.push_back(&scan);
+        }
+    }
+    REQUIRE(batch.size() == 2);
+
+    auto wrap = [&](bool filter_regions) {
+        for (auto* slot : batch) {
+            auto name = (*slot)->collection_full_name();
+            std::vector<complex_logical_type> fields;
+            fields.emplace_back(logical_type::BIGINT);
+            fields.back().set_alias(name.collection == "regions" ? "id" : "region_id");
+            logical_plan::node_aggregate_t agg(
+                static_cast<const logical_plan::node_aggregate_t&>(*scan_agg(*slot)));
+            if (filter_regions && name.collection == "regions") {
+                agg.append_child(logical_plan::make_node_match(
+                    resource,
+                    name,
+                    expressions::make_compare_expression(resource,
+                                                         expressions::compare_type::eq,
+                                                         expressions::side_t::undefined,
+                                                         expressions::key_t("id"),
+                                                         params->add_parameter(types::logical_value_t(1)))));
+            }
+            *slot = make_node_schema(name, complex_logical_type::create_struct(fields), std::move(agg));
+        }
+    };
+
+    // neither side is filtered, both go at once
+    wrap(false);
+    REQUIRE(plan_semi_joins(node, batch).empty());
+
+    wrap(true);
+    auto semi_joins = plan_semi_joins(node, batch);
+    REQUIRE(semi_joins.size() == 1);
+    REQUIRE((*batch[semi_joins[0].reducer])->collection_full_name().collection == "regions");
+    REQUIRE((*batch[semi_joins[0].target])->collection_full_name().collection == "sales");
+    REQUIRE(semi_joins[0].reducer_key == "id");
+    REQUIRE(semi_joins[0].target_key == "region_id");
+
+    // estimates take over from the filters: the much smaller side reduces, sides of similar size join locally
+    auto estimate = [&](int64_t regions, int64_t sales) {
+        for (auto* slot : batch) {
+            static_cast<schema_node_t&>(**slot).set_estimated_rows(
+                (*slot)->collection_full_name().collection == "regions" ? regions : sales);
+        }
+    };
+    estimate(1000000, 200);
+    semi_joins = plan_semi_joins(node, batch);
+    REQUIRE(semi_joins.size() == 1);
+    REQUIRE((*batch[semi_joins[0].reducer])->collection_full_name().collection == "sales");
+    REQUIRE(semi_joins[0].reducer_key == "region_id");
+    REQUIRE(semi_joins[0].target_rows == 1000000);
+
+    estimate(1000, 2000);
+    REQUIRE(plan_semi_joins(node, batch).empty());
+}
+
+TEST_CASE("semi-join: key filter") {
+    auto* resource = std::pmr::get_default_resource();
+    std::pmr::vector<complex_logical_type> fields(resource);
+    fields.emplace_back(logical_type::BIGINT, "id");
+    vector::data_chunk_t chunk(resource, fields);
+    chunk.resize(4);
+    chunk.set_value(0, 0, logical_value_t{int64_t(7)});
+    chunk.set_value(0, 1, logical_value_t{int64_t(3)});
+    chunk.set_value(0, 2, logical_value_t{int64_t(7)});
+    chunk.set_value(0, 3, logical_value_t{int64_t(5)});
+
+    REQUIRE(sql_gen::generate_key_filter("region_id", chunk, 0, 10) == "region_id IN (3, 5, 7)");
+    REQUIRE(sql_gen::generate_key_filter("region_id", chunk, 0, 2) == "(region_id >= 3 AND region_id <= 7)");
+
+    vector::data_chunk_t empty(resource, fields);
+    REQUIRE(sql_gen::generate_key_filter("region_id", empty, 0, 10) == "1 = 0");
+}
+
+TEST_CASE("semi-join: key filter literals") {
+    auto* resource = std::pmr::get_default_resource();
+    {
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::STRING_LITERAL, "name");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(2);
+        std::string quoted = "it's";
+        std::string escaped = "a\\\" OR 1=1";
+        chunk.set_value(0, 0, logical_value_t{std::string_view(quoted)});
+        chunk.set_value(0, 1, logical_value_t{std::string_view(escaped)});
+        REQUIRE(sql_gen::generate_key_filter("name", chunk, 0, 10) == "name IN ('a\\\" OR 1=1', 'it''s')");
+    }
+    {
+        // 'B' < 'a' byte-wise, but not under a case-insensitive collation: strings get no range
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::STRING_LITERAL, "code");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(2);
+        std::string upper = "B";
+        std::string lower = "a";
+        chunk.set_value(0, 0, logical_value_t{std::string_view(upper)});
+        chunk.set_value(0, 1, logical_value_t{std::string_view(lower)});
+        REQUIRE(sql_gen::generate_key_filter("code", chunk, 0, 10) == "code IN ('B', 'a')");
+        REQUIRE(sql_gen::generate_key_filter("code", chunk, 0, 1).empty());
+    }
+    {
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::DOUBLE, "price");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(2);
+        chunk.set_value(0, 0, logical_value_t{0.1});
+        chunk.set_value(0, 1, logical_value_t{2.5});
+        REQUIRE(sql_gen::generate_key_filter("price", chunk, 0, 10).empty());
+        REQUIRE(sql_gen::generate_key_filter("price", chunk, 0, 1).empty());
+
+        vector::data_chunk_t empty(resource, fields);
+        REQUIRE(sql_gen::generate_key_filter("price", empty, 0, 10) == "1 = 0");
+    }
+    {
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::TINYINT, "flag");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(2);
+        chunk.set_value(0, 0, logical_value_t{int8_t(65)});
+        chunk.set_value(0, 1, logical_value_t{int8_t(-1)});
+        REQUIRE(sql_gen::generate_key_filter("flag", chunk, 0, 10) == "flag IN (-1, 65)");
+        REQUIRE(sql_gen::generate_key_filter("flag", chunk, 0, 1) == "(flag >= -1 AND flag <= 65)");
+        auto statements = sql_gen::generate_key_table("keys_0", chunk, 0, 2);
+        REQUIRE(statements.size() == 2);
+        REQUIRE(statements[0] == "CREATE TEMPORARY TABLE keys_0 (k TINYINT);");
+        REQUIRE(statements[1] == "INSERT INTO keys_0 VALUES (-1), (65);");
+    }
+}
+
+TEST_CASE("semi-join: key table") {
+    auto* resource = std::pmr::get_default_resource();
+    std::pmr::vector<complex_logical_type> fields(resource);
+    fields.emplace_back(logical_type::BIGINT, "id");
+    vector::data_chunk_t chunk(resource, fields);
+    chunk.resize(4);
+    chunk.set_value(0, 0, logical_value_t{int64_t(7)});
+    chunk.set_value(0, 1, logical_value_t{int64_t(3)});
+    chunk.set_value(0, 2, logical_value_t{int64_t(7)});
+    chunk.set_value(0, 3, logical_value_t{int64_t(5)});
+
+    auto statements = sql_gen::generate_key_table("keys_0", chunk, 0, 2);
+    REQUIRE(statements.size() == 3);
+    REQUIRE(statements[0] == "CREATE TEMPORARY TABLE keys_0 (k BIGINT);");
+    REQUIRE(statements[1] == "INSERT INTO keys_0 VALUES (3), (5);");
+    REQUIRE(statements[2] == "INSERT INTO keys_0 VALUES (7);");
+    REQUIRE(sql_gen::generate_key_table_filter("region_id", "keys_0") == "region_id IN (SELECT k FROM keys_0)");
+
+    vector::data_chunk_t empty(resource, fields);
+    REQUIRE(sql_gen::generate_key_table("keys_0", empty, 0, 2).size() == 1);
+}
+
+TEST_CASE("semi-join: key table column types") {
+    auto* resource = std::pmr::get_default_resource();
+    {
+        // above the range of a signed INT
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::UINTEGER, "id");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(2);
+        chunk.set_value(0, 0, logical_value_t{uint32_t(3000000000u)});
+        chunk.set_value(0, 1, logical_value_t{uint32_t(1)});
+        auto statements = sql_gen::generate_key_table("keys_0", chunk, 0, 10);
+        REQUIRE(statements.size() == 2);
+        REQUIRE(statements[0] == "CREATE TEMPORARY TABLE keys_0 (k INT UNSIGNED);");
+        REQUIRE(statements[1] == "INSERT INTO keys_0 VALUES (1), (3000000000);");
+    }
+    {
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::UBIGINT, "id");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(1);
+        chunk.set_value(0, 0, logical_value_t{uint64_t(18000000000000000000ull)});
+        auto statements = sql_gen::generate_key_table("keys_0", chunk, 0, 10);
+        REQUIRE(statements[0] == "CREATE TEMPORARY TABLE keys_0 (k BIGINT UNSIGNED);");
+        REQUIRE(statements[1] == "INSERT INTO keys_0 VALUES (18000000000000000000);");
+    }
+    {
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::UTINYINT, "flag");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(1);
+        chunk.set_value(0, 0, logical_value_t{uint8_t(200)});
+        auto statements = sql_gen::generate_key_table("keys_0", chunk, 0, 10);
+        REQUIRE(statements[0] == "CREATE TEMPORARY TABLE keys_0 (k TINYINT UNSIGNED);");
+        REQUIRE(statements[1] == "INSERT INTO keys_0 VALUES (200);");
+    }
+    {
+        std::pmr::vector<complex_logical_type> fields(resource);
+        fields.emplace_back(logical_type::STRING_LITERAL, "code");
+        vector::data_chunk_t chunk(resource, fields);
+        chunk.resize(2);
+        std::string shorter = "ab";
+        std::string longer = "abcde";
+        chunk.set_value(0, 0, logical_value_t{std::string_view(shorter)});
+        chunk.set_value(0, 1, logical_value_t{std::string_view(longer)});
+        auto statements = sql_gen::generate_key_table("keys_0", chunk, 0, 10);
+        REQUIRE(statements[0] == "CREATE TEMPORARY TABLE keys_0 (k VARCHAR(5));");
+        REQUIRE(statements[1] == "INSERT INTO keys_0 VALUES ('ab'), ('abcde');");
+    }
+}
+
+TEST_CASE("statistics: row estimates") {
+    table_stats_t stats;
+    stats.rows = 10000;
+    stats.index_cardinality["id"] = 10000;
+    stats.index_cardinality["region_id"] = 50;
+
+    auto estimate = [&stats](std::string sql) {
+        auto [node, params] = parse(std::move(sql));
+        return estimate_rows(static_cast<const logical_plan::node_aggregate_t&>(*node), stats);
+    };
+
+    REQUIRE(estimate("SELECT * FROM uid1.db1.schema.sales;") == 10000);
+    REQUIRE(estimate("SELECT * FROM uid1.db1.schema.sales WHERE id = 7;") == 1);
+    REQUIRE(estimate("SELECT * FROM uid1.db1.schema.sales WHERE region_id = 7;") == 200);
+    REQUIRE(estimate("SELECT * FROM uid1.db1.schema.sales WHERE amount > 7;") == 3333);
+    REQUIRE(estimate("SELECT * FROM uid1.db1.schema.sales LIMIT 10;") == 10);
+    REQUIRE(estimate("SELECT region_id, SUM(amount) AS total FROM uid1.db1.schema.sales GROUP BY region_id;") == 50);
+    REQUIRE(estimate("SELECT COUNT(*) AS cnt FROM uid1.db1.schema.sales;") == 1);
+
+    REQUIRE(estimate_rows(logical_plan::node_aggregate_t(std::pmr::get_default_resource(), collection_full_name_t()),
+                          table_stats_t{}) == -1);
+}
+
+TEST_CASE("parameters: typed by the compared column") {
+    auto [node, params] = parse("SELECT * FROM uid1.db1.schema.sales "
+                                "WHERE sales.id = 7 AND (name = 'a' OR amount > 1.5) AND note = 'b';");
+    std::vector<complex_logical_type> fields;
+    fields.emplace_back(logical_type::BIGINT);
+    fields.back().set_alias("id");
+    fields.emplace_back(logical_type::STRING_LITERAL);
+    fields.back().set_alias("name");
+    fields.emplace_back(logical_type::DOUBLE);
+    fields.back().set_alias("amount");
+    auto table = complex_logical_type::create_struct(fields);
+
+    std::vector<complex_logical_type> types(4, complex_logical_type(logical_type::NA));
+    infer_parameter_types(static_cast<const logical_plan::node_aggregate_t&>(*node), table, types);
+    REQUIRE(types[0].type() == logical_type::BIGINT);
+    REQUIRE(types[1].type() == logical_type::STRING_LITERAL);
+    REQUIRE(types[2].type() == logical_type::DOUBLE);
+    // not a column of the table
+    REQUIRE(types[3].type() == logical_type::NA);
+
+    // parameters past the end are not typed
+    std::vector<complex_logical_type> first(1, complex_logical_type(logical_type::NA));
+    infer_parameter_types(static_cast<const logical_plan::node_aggregate_t&>(*node), table, first);
+    REQUIRE(first.size() == 1u);
+    REQUIRE(first[0].type() == logical_type::BIGINT);
+}
+
+TEST_CASE("semi-join: key shipping") {
+    REQUIRE(choose_key_shipping(10, -1) == key_shipping::in_list);
+    REQUIRE(choose_key_shipping(SEMI_JOIN_IN_LIST_LIMIT + 1, -1) == key_shipping::key_table);
+    REQUIRE(choose_key_shipping(SEMI_JOIN_IN_LIST_LIMIT + 1, 1000000) == key_shipping::key_table);
+    // the target is smaller than the keys that would be uploaded to cut it
+    REQUIRE(choose_key_shipping(5000, 4000) == key_shipping::range);
+    REQUIRE(choose_key_shipping(SEMI_JOIN_KEY_TABLE_LIMIT + 1, -1) == key_shipping::range);
+}
+
+TEST_CASE("feedback: normalized query shape") {
+    REQUIRE(sql_gen::normalize_query("SELECT * FROM t1 WHERE id = 7 AND name = \"it\"\"s\";") ==
+            "SELECT * FROM t1 WHERE id = ? AND name = ?;");
+    REQUIRE(sql_gen::normalize_query("SELECT * FROM t1 WHERE id IN (3, 5, 7);") ==
+            sql_gen::normalize_query("SELECT * FROM t1 WHERE id IN (12);"));
+    REQUIRE(sql_gen::normalize_query("SELECT * FROM t1 WHERE price > -1.5 LIMIT 10;") ==
+            "SELECT * FROM t1 WHERE price > -? LIMIT ?;");
+    // digits inside identifiers are kept
+    REQUIRE(sql_gen::normalize_query("SELECT * FROM t1 WHERE k IN (SELECT k FROM __otterstax_keys_1);") ==
+            "SELECT * FROM t1 WHERE k IN (SELECT k FROM __otterstax_keys_1);");
+}
+
+namespace {
+    // wraps the scans under the join into schema nodes, as the catalog does
+    std::vector<logical_plan::node_ptr*> wrap_join_scans(logical_plan::node_ptr& node) {
+        std::vector<logical_plan::node_ptr*> scans;
+        for (auto& child : node->children()) {
+            if (child->type() == logical_plan::node_type::join_t) {
+                for (auto& scan : child->children()) {
+                    scans.push_back(&scan);
+                }
+            }
+        }
+        for (auto* slot : scans) {
+            auto name = (*slot)->collection_full_name();
+            std::vector<complex_logical_type> fields;
+            fields.emplace_back(logical_type::BIGINT, "id");
+            if (name.collection == "regions") {
+                fields.emplace_back(logical_type::STRING_LITERAL, "name");
+            } else {
+                fields.emplace_back(logical_type::BIGINT, "region_id");
+                fields.emplace_back(logical_type::BIGINT, "amount");
+            }
+            logical_plan::node_aggregate_t agg(static_cast<const logical_plan::node_aggregate_t&>(**slot));
+            *slot = make_node_schema(name, complex_logical_type::create_struct(fields), std::move(agg));
+        }
+        return scans;
+    }
+} // namespace
+
+TEST_CASE("filters: single-source conjuncts are pushed below the join") {
+    auto [node, params] = parse("SELECT * FROM uid1.db1.schema.regions JOIN uid2.db2.schema.sales "
+                                "ON regions.id = sales.region_id "
+                                "WHERE sales.amount > 5 AND regions.name = 'north' AND sales.amount < regions.id;");
+    auto scans = wrap_join_scans(node);
+    REQUIRE(scans.size() == 2);
+
+    REQUIRE(push_join_filters(node));
+    for (auto* slot : scans) {
+        auto& scan = static_cast<schema_node_t&>(**slot);
+        auto query = sql_gen::generate_query(scan.agg_node(), &params->parameters(), &scan.schema());
+        // qualified keys resolve against the table name
+        REQUIRE(query.find(" AS " + scan.collection_full_name().collection + " WHERE ") != std::string::npos);
+        if (scan.collection_full_name().collection == "sales") {
+            REQUIRE(query.find("WHERE sales.amount > 5") != std::string::npos);
+        } else {
+            REQUIRE(query.find("WHERE regions.name = ") != std::string::npos);
+        }
+        // the conjunct reading both sources stays local only
+        REQUIRE(query.find("<") == std::string::npos);
+    }
+
+    // a left join keeps the filters above it
+    auto [outer, outer_params] = parse("SELECT * FROM uid1.db1.schema.regions LEFT JOIN uid2.db2.schema.sales "
+                                       "ON regions.id = sales.region_id WHERE sales.amount > 5;");
+    REQUIRE(wrap_join_scans(outer).size() == 2);
+    REQUIRE_FALSE(push_join_filters(outer));
+}
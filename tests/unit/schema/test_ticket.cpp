@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "frontend/flight_sql_server/ticket.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+TEST_CASE("ticket: statement handle round trip") {
+    TicketData data{"SELECT * FROM t WHERE at = '12:30'::time", "tx", 42, 3, true};
+    auto handle = EncodeStatementHandle(data);
+    REQUIRE(handle == "SELECT * FROM t WHERE at = '12:30'::time:tx:42:3:1");
+
+    auto decoded = DecodeTransactionQuery(handle);
+    REQUIRE(decoded.ok());
+    REQUIRE(decoded->sql_query == data.sql_query);
+    REQUIRE(decoded->transaction_id == "tx");
+    REQUIRE(decoded->session_hash == 42u);
+    REQUIRE(decoded->endpoint == 3u);
+    REQUIRE(decoded->spooled);
+
+    auto plain = DecodeTransactionQuery(EncodeStatementHandle({"SELECT 1", "", 7}));
+    REQUIRE(plain.ok());
+    REQUIRE(plain->sql_query == "SELECT 1");
+    REQUIRE(plain->transaction_id.empty());
+    REQUIRE(plain->session_hash == 7u);
+    REQUIRE(plain->endpoint == 0u);
+    REQUIRE_FALSE(plain->spooled);
+
+    REQUIRE(EncodeTransactionQuery(data).ok());
+}
+
+TEST_CASE("ticket: malformed handles are rejected") {
+    REQUIRE_FALSE(DecodeTransactionQuery("").ok());
+    REQUIRE_FALSE(DecodeTransactionQuery("SELECT 1").ok());
+    // tickets of the old layout without endpoint and spooled flag
+    REQUIRE_FALSE(DecodeTransactionQuery("SELECT 1::42").ok());
+    REQUIRE_FALSE(DecodeTransactionQuery("SELECT 1::x:0:0").ok());
+    REQUIRE_FALSE(DecodeTransactionQuery("SELECT 1::42:1x:0").ok());
+    REQUIRE_FALSE(DecodeTransactionQuery("SELECT 1::42:0:2").ok());
+}
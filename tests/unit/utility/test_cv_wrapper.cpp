@@ -76,4 +76,36 @@ TEST_CASE("cv_wrapper: error") {
     REQUIRE(cv_w->result == nullptr);
     REQUIRE(cv_w->status() == Status::Error);
     REQUIRE(cv_w->error_message() == "Some error occurred");
-}
\ No newline at end of file
+}
+TEST_CASE("cv_wrapper: on_ready") {
+    auto cv_w = create_cv_wrapper(std::unique_ptr<std::string>());
+    int calls = 0;
+    cv_w->on_ready([&calls]() { calls++; });
+    REQUIRE(calls == 0);
+
+    cv_w->result = std::make_unique<std::string>("Hello, World!");
+    cv_w->release();
+    REQUIRE(calls == 1);
+    REQUIRE(cv_w->status() == Status::Ok);
+
+    // already released - callback runs immediately
+    cv_w->on_ready([&calls]() { calls++; });
+    REQUIRE(calls == 2);
+    REQUIRE_FALSE(cv_w->expire());
+    REQUIRE(cv_w->status() == Status::Ok);
+}
+
+TEST_CASE("cv_wrapper: expire") {
+    auto cv_w = create_cv_wrapper(std::unique_ptr<std::string>());
+    int calls = 0;
+    cv_w->on_ready([&calls]() { calls++; });
+
+    REQUIRE(cv_w->expire());
+    REQUIRE(cv_w->status() == Status::Timeout);
+
+    // late result is ignored, callback is dropped
+    cv_w->release_on_error("Some error occurred");
+    REQUIRE(calls == 0);
+    REQUIRE(cv_w->status() == Status::Timeout);
+    REQUIRE(cv_w->error_message().empty());
+}
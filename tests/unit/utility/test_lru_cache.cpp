@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "utility/lru_cache.hpp"
+
+#include <catch2/catch.hpp>
+#include <memory>
+#include <string>
+
+TEST_CASE("lru cache: least recently used entry is evicted") {
+    LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    REQUIRE(cache.find("a"));
+
+    cache.put("c", 3);
+    REQUIRE(cache.size() == 2);
+    REQUIRE_FALSE(cache.contains("b"));
+    REQUIRE(*cache.find("a") == 1);
+    REQUIRE(*cache.find("c") == 3);
+}
+
+TEST_CASE("lru cache: put replaces the value of an existing key") {
+    LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.put("a", 10);
+    REQUIRE(cache.size() == 2);
+
+    cache.put("c", 3);
+    REQUIRE_FALSE(cache.contains("b"));
+    REQUIRE(*cache.find("a") == 10);
+}
+
+TEST_CASE("lru cache: take removes the entry") {
+    LruCache<std::string, std::unique_ptr<int>> cache(4);
+    cache.put("a", std::make_unique<int>(1));
+
+    auto taken = cache.take("a");
+    REQUIRE(taken);
+    REQUIRE(**taken == 1);
+    REQUIRE(cache.size() == 0);
+    REQUIRE_FALSE(cache.take("a"));
+    REQUIRE(cache.find("a") == nullptr);
+}
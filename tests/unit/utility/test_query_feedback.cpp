@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "utility/query_feedback.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("query feedback: first sample is taken as is") {
+    QueryFeedback feedback;
+    REQUIRE_FALSE(feedback.lookup("SELECT * FROM t WHERE id = ?;"));
+
+    feedback.record("SELECT * FROM t WHERE id = ?;", 100, 800, 2000us);
+    auto observed = feedback.lookup("SELECT * FROM t WHERE id = ?;");
+    REQUIRE(observed);
+    REQUIRE(observed->rows == 100);
+    REQUIRE(observed->bytes == 800);
+    REQUIRE(observed->latency == 2000us);
+    REQUIRE(observed->samples == 1);
+}
+
+TEST_CASE("query feedback: later samples move the average") {
+    QueryFeedback feedback;
+    feedback.record("q", 100, 1000, 1000us);
+    feedback.record("q", 500, 5000, 5000us);
+
+    auto observed = feedback.lookup("q");
+    REQUIRE(observed);
+    REQUIRE(observed->samples == 2);
+    REQUIRE(observed->rows == Approx(100 + QueryFeedback::SAMPLE_WEIGHT * 400));
+    REQUIRE(observed->bytes == Approx(1000 + QueryFeedback::SAMPLE_WEIGHT * 4000));
+    REQUIRE(observed->latency == 2000us);
+}
+
+TEST_CASE("query feedback: least recently used shapes are evicted first") {
+    QueryFeedback feedback(2);
+    // many samples don't keep a shape that is no longer used
+    for (int i = 0; i < 10; ++i) {
+        feedback.record("old", 1, 1, 1us);
+    }
+    feedback.record("recent", 1, 1, 1us);
+    feedback.record("new", 1, 1, 1us);
+
+    REQUIRE(feedback.size() == 2);
+    REQUIRE_FALSE(feedback.lookup("old"));
+    REQUIRE(feedback.lookup("recent"));
+    REQUIRE(feedback.lookup("new"));
+
+    // the planner reading a shape keeps it too
+    REQUIRE(feedback.lookup("recent"));
+    feedback.record("newer", 1, 1, 1us);
+    REQUIRE(feedback.lookup("recent"));
+    REQUIRE_FALSE(feedback.lookup("new"));
+}
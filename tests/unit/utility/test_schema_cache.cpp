@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#include "utility/schema_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+using namespace components::types;
+
+namespace {
+    complex_logical_type make_schema(const std::string& column) {
+        std::vector<complex_logical_type> fields;
+        fields.emplace_back(logical_type::BIGINT);
+        fields.back().set_alias(column);
+        return complex_logical_type::create_struct(fields);
+    }
+} // namespace
+
+TEST_CASE("schema cache: stored schema is found") {
+    SchemaCache cache;
+    REQUIRE_FALSE(cache.lookup("SELECT id FROM t WHERE id = $1;"));
+
+    REQUIRE(cache.store("SELECT id FROM t WHERE id = $1;", cache.version(), make_schema("id")));
+    auto schema = cache.lookup("SELECT id FROM t WHERE id = $1;");
+    REQUIRE(schema);
+    REQUIRE(schema->child_types().size() == 1);
+    REQUIRE(schema->child_types().front().alias() == "id");
+}
+
+TEST_CASE("schema cache: catalog change drops schemas") {
+    SchemaCache cache;
+    REQUIRE(cache.store("q", cache.version(), make_schema("id")));
+    cache.invalidate();
+    REQUIRE(cache.size() == 0);
+    REQUIRE_FALSE(cache.lookup("q"));
+}
+
+TEST_CASE("schema cache: schema described before a catalog change is not stored") {
+    SchemaCache cache;
+    const auto version = cache.version();
+    cache.invalidate();
+    REQUIRE_FALSE(cache.store("q", version, make_schema("id")));
+    REQUIRE_FALSE(cache.lookup("q"));
+
+    REQUIRE(cache.store("q", cache.version(), make_schema("id")));
+    REQUIRE(cache.lookup("q"));
+}
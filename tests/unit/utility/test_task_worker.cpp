@@ -7,17 +7,163 @@
 #include <chrono>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    bool wait_until(const std::function<bool()>& done, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+} // namespace
 
 TEST_CASE("worker: base test case") {
     std::atomic<int> c{0};
-    TaskManager<std::function<void()>> tm;
+    task_executor_t tm;
 
     auto f1 = [&c]() { c++; };
     auto f2 = [&c]() { c++; };
-    tm.start();
-    tm.addTask(std::move(f1));
-    tm.addTask(std::move(f2));
+    REQUIRE(tm.addTask(std::move(f1)));
+    REQUIRE(tm.addTask(std::move(f2)));
+
+    REQUIRE(wait_until([&c] { return c.load() == 2; }));
+}
+
+TEST_CASE("worker: bounded queue") {
+    BoundedTaskQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.tryPush(i));
+    }
+    int rejected = 42;
+    REQUIRE_FALSE(queue.tryPush(rejected));
+    REQUIRE(rejected == 42);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.tryPop(value));
+}
+
+TEST_CASE("worker: producers block instead of dropping tasks") {
+    constexpr int producers = 4;
+    constexpr int tasks_per_producer = 500;
+    std::atomic<int> c{0};
+    // tiny queues so producers hit backpressure
+    task_executor_t tm(2, 4);
+
+    std::atomic<int> rejected{0};
+    std::vector<std::jthread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&tm, &c, &rejected] {
+            for (int i = 0; i < tasks_per_producer; ++i) {
+                if (!tm.addTask([&c] { c++; })) {
+                    rejected++;
+                }
+            }
+        });
+    }
+    threads.clear();
+    REQUIRE(rejected.load() == 0);
+
+    REQUIRE(wait_until([&c] { return c.load() == producers * tasks_per_producer; }));
+}
+
+TEST_CASE("worker: full executor queues nested tasks without running them inline") {
+    std::atomic<int> c{0};
+    std::atomic<int> ran_inline{-1};
+    std::atomic<int> rejected{0};
+    task_executor_t tm(1, 2);
+
+    tm.addTask([&tm, &c, &ran_inline, &rejected] {
+        for (int i = 0; i < 8; ++i) {
+            if (!tm.addTask([&c] { c++; })) {
+                rejected++;
+            }
+        }
+        // the only worker is busy here, so nothing could have run yet
+        ran_inline = c.load();
+        c++;
+    });
+
+    REQUIRE(wait_until([&c] { return c.load() == 9; }));
+    REQUIRE(ran_inline.load() == 0);
+    REQUIRE(rejected.load() == 0);
+}
+
+TEST_CASE("worker: stop drains queued tasks") {
+    std::atomic<int> c{0};
+    {
+        task_executor_t tm(2);
+        for (int i = 0; i < 100; ++i) {
+            tm.addTask([&c] { c++; });
+        }
+    }
+    REQUIRE(c.load() == 100);
+
+    task_executor_t stopped(1);
+    stopped.stop();
+    REQUIRE_FALSE(stopped.addTask([] {}));
+}
+
+TEST_CASE("worker: stop from a worker does not join the pool") {
+    std::atomic<bool> stopped{false};
+    auto tm = std::make_shared<task_executor_t>(2);
+    tm->addTask([&tm, &stopped] {
+        tm->stop();
+        stopped = true;
+    });
+    REQUIRE(wait_until([&stopped] { return stopped.load(); }));
+    REQUIRE_FALSE(tm->addTask([] {}));
+    // joined here, outside the pool
+    tm.reset();
+}
+
+TEST_CASE("worker: task group waits for its tasks") {
+    auto tm = std::make_shared<task_executor_t>(2);
+    std::atomic<int> c{0};
+    {
+        TaskGroup group(tm);
+        for (int i = 0; i < 16; ++i) {
+            REQUIRE(group.addTask([&c] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                c++;
+            }));
+        }
+    }
+    // every task finished before the group was gone
+    REQUIRE(c.load() == 16);
+
+    TaskGroup closed(tm);
+    closed.close();
+    REQUIRE_FALSE(closed.addTask([] {}));
+    REQUIRE(closed.size() == 0);
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    REQUIRE(c.load() == 2);
+TEST_CASE("worker: task group owner is destroyed after its tasks") {
+    struct owner_t {
+        std::atomic<int> delivered{0};
+        TaskGroup worker{std::make_shared<task_executor_t>(1)};
+    };
+    std::atomic<int> seen{0};
+    {
+        owner_t owner;
+        for (int i = 0; i < 8; ++i) {
+            owner.worker.addTask([&owner, &seen] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                seen = ++owner.delivered;
+            });
+        }
+    }
+    REQUIRE(seen.load() == 8);
 }
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -43,32 +45,46 @@ namespace cv_wrapper {
                 status_ = Status::Timeout;
             }
         }
-        void release() {
-            {
-                std::unique_lock<std::mutex> lock(m_);
-                ready_ = true;
-                status_ = Status::Ok;
-            }
-            cv_.notify_one();
-        }
+        void release() { finish([this] { status_ = Status::Ok; }); }
 
         void release_on_error(std::string error_msg) {
-            {
-                std::unique_lock<std::mutex> lock(m_);
+            finish([this, &error_msg] {
                 error = std::move(error_msg);
-                ready_ = true;
                 status_ = Status::Error;
+            });
+        }
+
+        void release_empty() { finish([this] { status_ = Status::Empty; }); }
+
+        // callback runs once the result is released: on the releasing thread, or right away if it already is.
+        // it is dropped if the wrapper expires first
+        void on_ready(std::function<void()> callback) {
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                if (!ready_) {
+                    callback_ = std::move(callback);
+                    return;
+                }
+                if (status_ == Status::Timeout) {
+                    return;
+                }
             }
-            cv_.notify_one();
+            callback();
         }
 
-        void release_empty() {
+        // asynchronous counterpart of wait_for timing out, false if the result was already released
+        bool expire() {
             {
                 std::unique_lock<std::mutex> lock(m_);
+                if (ready_) {
+                    return false;
+                }
                 ready_ = true;
-                status_ = Status::Empty;
+                status_ = Status::Timeout;
+                callback_ = nullptr;
             }
-            cv_.notify_one();
+            cv_.notify_all();
+            return true;
         }
 
         Status status() const noexcept {
@@ -82,9 +98,28 @@ namespace cv_wrapper {
         }
 
     private:
+        template<typename Update>
+        void finish(Update&& update) {
+            std::function<void()> callback;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                if (ready_ && status_ == Status::Timeout) {
+                    return; // expired, nobody is waiting for the result anymore
+                }
+                update();
+                ready_ = true;
+                callback = std::move(callback_);
+            }
+            cv_.notify_one();
+            if (callback) {
+                callback();
+            }
+        }
+
         Status status_{Status::Unknown};
         std::optional<std::string> error{std::nullopt};
         bool ready_{false};
+        std::function<void()> callback_;
         mutable std::mutex m_;
         std::condition_variable cv_;
     };
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+// bounded map dropping the least recently used entry once it is full.
+// not synchronized, owners guard it with their own lock
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(std::size_t capacity)
+        : capacity_(std::max<std::size_t>(capacity, 1)) {}
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // marks the entry as most recently used, nullptr on miss
+    Value* find(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+
+    // removes the entry and hands its value to the caller
+    std::optional<Value> take(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return std::nullopt;
+        }
+        std::optional<Value> value(std::move(it->second->second));
+        entries_.erase(it->second);
+        index_.erase(it);
+        return value;
+    }
+
+    void put(Key key, Value value) {
+        if (auto it = index_.find(key); it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        if (entries_.size() >= capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(std::move(key), std::move(value));
+        index_.emplace(entries_.front().first, entries_.begin());
+    }
+
+    bool contains(const Key& key) const { return index_.contains(key); }
+    std::size_t size() const noexcept { return entries_.size(); }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    void clear() {
+        index_.clear();
+        entries_.clear();
+    }
+
+private:
+    using entry_t = std::pair<Key, Value>;
+
+    const std::size_t capacity_;
+    // most recently used first
+    std::list<entry_t> entries_;
+    std::unordered_map<Key, typename std::list<entry_t>::iterator, Hash> index_;
+};
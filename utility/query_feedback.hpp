@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include "lru_cache.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+// observed cost of remote queries by normalized shape (sql with literals stripped), the planner prefers
+// it over estimates from table statistics
+class QueryFeedback {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+    // weight of a new sample, older ones fade out so the numbers follow changing data
+    static constexpr double SAMPLE_WEIGHT = 0.25;
+
+    struct observation_t {
+        double rows = 0;
+        double bytes = 0;
+        // from launch to the last row, waiting for a pooled connection included
+        std::chrono::microseconds latency{0};
+        std::size_t samples = 0;
+    };
+
+    explicit QueryFeedback(std::size_t capacity = DEFAULT_CAPACITY)
+        : shapes_(capacity) {}
+    QueryFeedback(const QueryFeedback&) = delete;
+    QueryFeedback& operator=(const QueryFeedback&) = delete;
+
+    // shapes neither recorded nor looked up for the longest time make room for new ones
+    void record(const std::string& shape, std::size_t rows, std::size_t bytes, std::chrono::microseconds latency) {
+        std::lock_guard lock(mtx_);
+        auto* observed = shapes_.find(shape);
+        if (!observed) {
+            shapes_.put(shape, observation_t{static_cast<double>(rows), static_cast<double>(bytes), latency, 1});
+            return;
+        }
+        observed->rows += SAMPLE_WEIGHT * (static_cast<double>(rows) - observed->rows);
+        observed->bytes += SAMPLE_WEIGHT * (static_cast<double>(bytes) - observed->bytes);
+        observed->latency +=
+            std::chrono::duration_cast<std::chrono::microseconds>(SAMPLE_WEIGHT * (latency - observed->latency));
+        ++observed->samples;
+    }
+
+    std::optional<observation_t> lookup(const std::string& shape) {
+        std::lock_guard lock(mtx_);
+        auto* observed = shapes_.find(shape);
+        if (!observed) {
+            return std::nullopt;
+        }
+        return *observed;
+    }
+
+    std::size_t size() const {
+        std::lock_guard lock(mtx_);
+        return shapes_.size();
+    }
+
+    void clear() {
+        std::lock_guard lock(mtx_);
+        shapes_.clear();
+    }
+
+private:
+    mutable std::mutex mtx_;
+    LruCache<std::string, observation_t> shapes_;
+};
+
+using query_feedback_ptr = std::shared_ptr<QueryFeedback>;
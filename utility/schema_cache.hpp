@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2025-2026  OtterStax
+
+#pragma once
+
+#include "lru_cache.hpp"
+
+#include <components/types/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+// result schemas of described queries by normalized sql. every catalog change bumps the version and drops them,
+// a schema computed against an older version is never stored
+class SchemaCache {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    explicit SchemaCache(std::size_t capacity = DEFAULT_CAPACITY)
+        : schemas_(capacity) {}
+    SchemaCache(const SchemaCache&) = delete;
+    SchemaCache& operator=(const SchemaCache&) = delete;
+
+    // taken before the schema is computed and handed back to store()
+    uint64_t version() const {
+        std::lock_guard lock(mtx_);
+        return version_;
+    }
+
+    std::optional<components::types::complex_logical_type> lookup(const std::string& query) {
+        std::lock_guard lock(mtx_);
+        if (auto* schema = schemas_.find(query); schema) {
+            return *schema;
+        }
+        return std::nullopt;
+    }
+
+    bool store(std::string query, uint64_t version, components::types::complex_logical_type schema) {
+        std::lock_guard lock(mtx_);
+        if (version != version_) {
+            return false;
+        }
+        schemas_.put(std::move(query), std::move(schema));
+        return true;
+    }
+
+    void invalidate() {
+        std::lock_guard lock(mtx_);
+        ++version_;
+        schemas_.clear();
+    }
+
+    std::size_t size() const {
+        std::lock_guard lock(mtx_);
+        return schemas_.size();
+    }
+
+private:
+    mutable std::mutex mtx_;
+    uint64_t version_ = 0;
+    LruCache<std::string, components::types::complex_logical_type> schemas_;
+};
+
+using schema_cache_ptr = std::shared_ptr<SchemaCache>;
@@ -9,10 +9,14 @@
 #include <components/types/types.hpp>
 #include <components/vector/data_chunk.hpp>
 
+#include <vector>
+
 struct flight_data {
     components::types::complex_logical_type schema;
     components::vector::data_chunk_t chunk;
     size_t parameter_count;
+    // one per parameter when the scheduler could tell them, NA where it could not
+    std::vector<components::types::complex_logical_type> parameter_types;
     NodeTag tag;
 
     explicit flight_data(std::pmr::memory_resource* resource)
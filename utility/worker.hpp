@@ -3,92 +3,335 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
-#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <shared_mutex>
 #include <thread>
+#include <vector>
 
-// TODO add concepts
+// bounded lock-free multi-producer/multi-consumer ring (Vyukov), capacity is rounded up to a power of two
 template<typename Task>
-class Tasks {
+class BoundedTaskQueue {
 public:
-    explicit Tasks(std::size_t max_size = 100)
-        : max_size_{max_size} {}
-    Tasks(const Tasks&) = delete;
-    Tasks& operator=(const Tasks&) = delete;
-    Tasks(Tasks&&) = delete;
-    Tasks& operator=(Tasks&&) = delete;
-    bool addTask(Task task) {
-        std::unique_lock<std::shared_mutex> lock;
-        if (tasks_.size() >= max_size_) {
-            return false;
+    explicit BoundedTaskQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1)
+        , cells_(std::make_unique<cell_t[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
         }
-        tasks_.push(std::move(task));
-        return true;
     }
-    Task enqueueTask() {
-        std::unique_lock<std::shared_mutex> lock;
-        auto task = tasks_.front();
-        tasks_.pop();
-        return task;
-    }
-    void reset() {
-        std::unique_lock<std::shared_mutex> lock;
-        while (!tasks_.empty()) {
-            tasks_.pop();
+    BoundedTaskQueue(const BoundedTaskQueue&) = delete;
+    BoundedTaskQueue& operator=(const BoundedTaskQueue&) = delete;
+
+    // task is left untouched when the queue is full
+    bool tryPush(Task& task) {
+        cell_t* cell;
+        auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
         }
-    }
-    size_t size() const noexcept {
-        std::shared_lock<std::shared_mutex> lock_;
-        return tasks_.size();
+        cell->task = std::move(task);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
     }
 
-    bool empty() const noexcept {
-        std::shared_lock<std::shared_mutex> lock_;
-        return tasks_.empty();
+    bool tryPop(Task& task) {
+        cell_t* cell;
+        auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        task = std::move(cell->task);
+        cell->task = Task{};
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
     }
 
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
 private:
-    std::size_t max_size_{0};
-    std::shared_mutex m_;
-    std::queue<Task> tasks_;
+    struct cell_t {
+        std::atomic<std::size_t> sequence;
+        Task task;
+    };
+
+    const std::size_t mask_;
+    std::unique_ptr<cell_t[]> cells_;
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
 };
 
+// fixed set of workers, each owning a bounded queue; idle workers steal from the others.
+// addTask never drops a task and never runs it on the caller: producers block while every queue is full,
+// a worker of this executor spills to an unbounded overflow list instead, so a full executor cannot deadlock
+// on itself
 template<typename Task>
-class TaskManager {
+class TaskExecutor {
 public:
-    void start() {
-        worker_ = std::move(std::jthread([this]() { this->process(); }));
+    static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 1024;
+
+    explicit TaskExecutor(std::size_t workers = std::max(2u, std::thread::hardware_concurrency()),
+                          std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY) {
+        workers = std::max<std::size_t>(workers, 1);
+        queues_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            queues_.push_back(std::make_unique<BoundedTaskQueue<Task>>(queue_capacity));
+        }
+        threads_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, i] { process(i); });
+        }
     }
-    void stop() {
-        tasks_.reset();
-        stop_.store(true);
-        cv_.notify_one();
-        worker_.join();
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+    TaskExecutor(TaskExecutor&&) = delete;
+    TaskExecutor& operator=(TaskExecutor&&) = delete;
+
+    // must not run on a worker of this executor, it joins them
+    ~TaskExecutor() {
+        assert(current_executor_ != this);
+        stop();
+        join();
     }
-    void process() {
-        while (!stop_.load()) {
-            std::unique_lock<std::mutex> lk(m_);
-            this->cv_.wait(lk, [this]() { return !this->tasks_.empty() || this->stop_.load(); });
-            while (!this->tasks_.empty()) {
-                this->tasks_.enqueueTask()();
-            }
+
+    // queued tasks are still run, new ones are rejected. a worker of this executor only signals the stop,
+    // the workers are joined by the first call from outside the pool
+    void stop() {
+        {
+            std::lock_guard lock(idle_mtx_);
+            stop_.store(true, std::memory_order_release);
+        }
+        idle_cv_.notify_all();
+        space_cv_.notify_all();
+        if (current_executor_ != this) {
+            join();
         }
     }
+
+    // false only once the executor is stopped
     bool addTask(Task task) {
-        auto res = tasks_.addTask(std::move(task));
-        cv_.notify_one();
-        return res;
+        const bool on_worker = current_executor_ == this;
+        const std::size_t start = on_worker ? current_worker_ : next_queue_.fetch_add(1, std::memory_order_relaxed);
+        for (;;) {
+            if (stop_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            // counted before the push so a worker never sees more tasks than pending_
+            pending_.fetch_add(1, std::memory_order_seq_cst);
+            bool pushed = tryPushAny(task, start);
+            if (!pushed && on_worker) {
+                // blocking here could leave every worker waiting for space only workers can free
+                std::lock_guard lock(overflow_mtx_);
+                overflow_.push_back(std::move(task));
+                pushed = true;
+            }
+            if (pushed) {
+                if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+                    { std::lock_guard lock(idle_mtx_); }
+                    idle_cv_.notify_one();
+                }
+                return true;
+            }
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            // backpressure: wait for a worker to free a slot
+            std::unique_lock lock(space_mtx_);
+            waiting_producers_.fetch_add(1, std::memory_order_seq_cst);
+            space_cv_.wait_for(lock, std::chrono::milliseconds(1));
+            waiting_producers_.fetch_sub(1, std::memory_order_relaxed);
+        }
     }
-    ~TaskManager() { stop(); }
+
+    std::size_t workers() const noexcept { return threads_.size(); }
+    std::size_t size() const noexcept { return pending_.load(std::memory_order_relaxed); }
+    bool empty() const noexcept { return size() == 0; }
 
 private:
-    Tasks<Task> tasks_;
-    std::jthread worker_;
-    std::mutex m_;
-    std::condition_variable cv_;
+    void join() {
+        std::lock_guard lock(join_mtx_);
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    bool tryPushAny(Task& task, std::size_t start) {
+        for (std::size_t i = 0; i < queues_.size(); ++i) {
+            if (queues_[(start + i) % queues_.size()]->tryPush(task)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // own queue first, then steal from the neighbours, then the overflow
+    bool tryPopAny(Task& task, std::size_t index) {
+        for (std::size_t i = 0; i < queues_.size(); ++i) {
+            if (queues_[(index + i) % queues_.size()]->tryPop(task)) {
+                return true;
+            }
+        }
+        std::lock_guard lock(overflow_mtx_);
+        if (overflow_.empty()) {
+            return false;
+        }
+        task = std::move(overflow_.front());
+        overflow_.pop_front();
+        return true;
+    }
+
+    void process(std::size_t index) {
+        current_executor_ = this;
+        current_worker_ = index;
+        Task task;
+        for (;;) {
+            if (tryPopAny(task, index)) {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                if (waiting_producers_.load(std::memory_order_seq_cst) > 0) {
+                    { std::lock_guard lock(space_mtx_); }
+                    space_cv_.notify_one();
+                }
+                task();
+                task = Task{};
+                continue;
+            }
+            std::unique_lock lock(idle_mtx_);
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            idle_cv_.wait(lock, [this] {
+                return pending_.load(std::memory_order_seq_cst) > 0 || stop_.load(std::memory_order_acquire);
+            });
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            if (stop_.load(std::memory_order_acquire) && pending_.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local TaskExecutor* current_executor_ = nullptr;
+    static inline thread_local std::size_t current_worker_ = 0;
+
+    std::vector<std::unique_ptr<BoundedTaskQueue<Task>>> queues_;
+    std::vector<std::jthread> threads_;
+    alignas(64) std::atomic<std::size_t> next_queue_{0};
+    alignas(64) std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> sleeping_{0};
+    std::atomic<std::size_t> waiting_producers_{0};
     std::atomic_bool stop_{false};
-};
\ No newline at end of file
+
+    std::mutex idle_mtx_;
+    std::condition_variable idle_cv_;
+    std::mutex space_mtx_;
+    std::condition_variable space_cv_;
+    std::mutex overflow_mtx_;
+    std::deque<Task> overflow_;
+    std::mutex join_mtx_;
+};
+
+using task_executor_t = TaskExecutor<std::function<void()>>;
+using task_executor_ptr = std::shared_ptr<task_executor_t>;
+
+// process-wide executor used by the actors to deliver results
+inline task_executor_ptr shared_executor() {
+    static task_executor_ptr executor = std::make_shared<task_executor_t>();
+    return executor;
+}
+
+// tasks one owner submits to a shared executor. the destructor rejects new tasks and waits for the submitted
+// ones, so they may capture the owner's this as long as the group is destroyed before the state they touch.
+// must not be destroyed by one of its own tasks
+class TaskGroup {
+public:
+    explicit TaskGroup(task_executor_ptr executor = shared_executor())
+        : executor_(std::move(executor))
+        , state_(std::make_shared<state_t>()) {}
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() { close(); }
+
+    // false once the group or the executor is closed
+    bool addTask(std::function<void()> task) {
+        {
+            std::lock_guard lock(state_->mtx);
+            if (state_->closed) {
+                return false;
+            }
+            ++state_->pending;
+        }
+        auto wrapped = [state = state_, task = std::move(task)]() mutable {
+            // counted down even if the task throws, after the task and its captures are gone
+            struct done_t {
+                state_t& state;
+                ~done_t() {
+                    std::lock_guard lock(state.mtx);
+                    if (--state.pending == 0) {
+                        state.cv.notify_all();
+                    }
+                }
+            } done{*state};
+            auto run = std::move(task);
+            run();
+        };
+        if (!executor_->addTask(std::move(wrapped))) {
+            std::lock_guard lock(state_->mtx);
+            if (--state_->pending == 0) {
+                state_->cv.notify_all();
+            }
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        std::unique_lock lock(state_->mtx);
+        state_->closed = true;
+        state_->cv.wait(lock, [this] { return state_->pending == 0; });
+    }
+
+    std::size_t size() const {
+        std::lock_guard lock(state_->mtx);
+        return state_->pending;
+    }
+
+private:
+    struct state_t {
+        mutable std::mutex mtx;
+        std::condition_variable cv;
+        std::size_t pending = 0;
+        bool closed = false;
+    };
+
+    task_executor_ptr executor_;
+    std::shared_ptr<state_t> state_;
+};